@@ -2953,6 +2953,9 @@ class USERPREF_PT_developer_tools(Panel):
                 ({"property": "use_extensions_debug"}, ("/blender/blender/issues/119521", "#119521")),
                 ({"property": "write_legacy_blend_file_format"}, ("/blender/blender/issues/129309", "#129309")),
                 ({"property": "no_data_block_packing"}, ("/blender/blender/issues/132167", "#132167")),
+                ({"property": "use_mapped_blend_file_data"}, None),
+                ({"property": "use_undo_compression"}, None),
+                ({"property": "use_incremental_depsgraph_relations"}, None),
             ),
         )
 
@@ -30,6 +30,7 @@
  * specific cases requiring advanced (and potentially dangerous) handling.
  */
 
+#include <atomic>
 #include <optional>
 
 #include "BLI_compiler_attrs.hh"
@@ -91,6 +92,15 @@ struct ID_Runtime {
    * freed and the pointer set to `nullptr`.
    */
   ID_Readfile_Data *readfile_data = nullptr;
+
+  /**
+   * Changes whenever the data-block is tagged for update, see #BKE_id_update_stamp_tag. Stamps
+   * are taken from a single global counter, so a data-block that is re-created (e.g. re-read by
+   * undo) never gets a stamp that was already used for a different state of that data-block.
+   * Atomic because it is read while evaluating other depsgraphs, which can happen while the
+   * data-block is tagged.
+   */
+  std::atomic<uint64_t> update_stamp = 0;
 };
 
 }  // namespace bke::id
@@ -145,6 +155,11 @@ void BKE_libblock_init_empty(ID *id) ATTR_NONNULL(1);
  */
 void BKE_libblock_runtime_ensure(ID &id);
 
+/**
+ * Give the ID a new #ID_Runtime::update_stamp, called when it is tagged for update.
+ */
+void BKE_id_update_stamp_tag(ID &id);
+
 /**
  * Reset the runtime counters used by ID remapping.
  */
@@ -0,0 +1,81 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <optional>
+
+#include "BKE_geometry_set.hh"
+
+namespace blender {
+
+struct CustomData_MeshMasks;
+struct Depsgraph;
+struct Object;
+struct Scene;
+
+/**
+ * Every depsgraph evaluates the modifier stack of a mesh object separately, so rendering several
+ * view layers of the same scene keeps a copy of every evaluated mesh per view layer. This cache
+ * allows depsgraphs that evaluate an object with identical inputs to share the evaluated mesh
+ * instead. Each depsgraph still gets its own #Mesh, but its arrays are implicitly shared with the
+ * meshes of the other depsgraphs, so they are only copied when one of them modifies them.
+ *
+ * Only objects whose result does not depend on anything but the object, its mesh and shape keys
+ * and the scene are shared, i.e. objects in object mode with modifiers that do not reference
+ * other data-blocks. Geometry nodes modifiers may use node groups and materials, but no other
+ * data-blocks, simulations or bakes. The active depsgraph never takes part, because the user
+ * interface reads evaluation state (like modifier errors) from it that is not part of the
+ * evaluated mesh.
+ */
+namespace bke::mesh_eval_share {
+
+/**
+ * Get the evaluated geometry of a mesh object, if a different depsgraph already evaluated it with
+ * the same inputs. The returned mesh is owned by the geometry set and uses the evaluated
+ * data-blocks of the given depsgraph.
+ */
+std::optional<GeometrySet> lookup(const Depsgraph &depsgraph,
+                                  const Scene &scene,
+                                  const Object &ob,
+                                  const CustomData_MeshMasks &data_mask,
+                                  bool need_mapping);
+
+/**
+ * Make the result of evaluating the modifier stack of a mesh object available to other
+ * depsgraphs. Does nothing when the object or the result cannot be shared.
+ */
+void add(const Depsgraph &depsgraph,
+         const Scene &scene,
+         const Object &ob,
+         const CustomData_MeshMasks &data_mask,
+         bool need_mapping,
+         const GeometrySet &geometry_set);
+
+/**
+ * Remove the depsgraph from the users of the shared meshes, freeing the ones that are not used
+ * by any depsgraph anymore, unless a render job is running. Called when the depsgraph is freed.
+ */
+void remove_depsgraph(const Depsgraph &depsgraph);
+
+/**
+ * Keep shared meshes that are not used by any depsgraph until #render_job_end is called. Renders
+ * free the depsgraph of a view layer before the depsgraph of the next view layer is built, so the
+ * meshes would be freed before they can be shared otherwise. Render jobs can be nested and run
+ * concurrently, the meshes are freed when the last one ends.
+ */
+void render_job_begin();
+void render_job_end();
+
+/**
+ * Free all shared meshes.
+ */
+void clear();
+
+}  // namespace bke::mesh_eval_share
+}  // namespace blender
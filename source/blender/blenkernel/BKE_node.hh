@@ -448,6 +448,13 @@ struct bNodeType {
 
   /** True when the node cannot be muted. */
   bool no_muting = false;
+  /**
+   * True when the outputs of the node do not only depend on its inputs and settings, e.g. because
+   * it reads the scene time, the viewport state or files, or when it has side effects like
+   * logging values or showing a gizmo. Results of node groups containing such nodes are not
+   * reused across evaluations.
+   */
+  bool depends_on_eval_context = false;
   /** Some nodes should ignore the inferred visibility for improved UX. */
   bool ignore_inferred_input_socket_visibility = false;
   /** True when the node still works but it's usage is discouraged. */
@@ -453,14 +453,30 @@ static void read_shared_array(BlendDataReader &reader,
                               const ImplicitSharingInfo **sharing_info)
 {
   const char *func = __func__;
-  *sharing_info = BLO_read_shared(&reader, data, [&]() -> const ImplicitSharingInfo * {
+  const auto read_fn = [&]() -> const ImplicitSharingInfo * {
     read_array_data(reader, dna_attr_type, size, data);
     if (*data == nullptr) {
       return nullptr;
     }
     const CPPType &cpp_type = attribute_type_to_cpp_type(AttrType(dna_attr_type));
     return MEM_new<ArrayDataImplicitSharing>(func, *data, size, cpp_type);
-  });
+  };
+  if (dna_attr_type < 0 || dna_attr_type > int8_t(AttrType::Float4)) {
+    /* Unknown type, #read_array_data handles the error. */
+    *sharing_info = BLO_read_shared(&reader, data, read_fn);
+    return;
+  }
+  const CPPType &cpp_type = attribute_type_to_cpp_type(AttrType(dna_attr_type));
+  if (!cpp_type.is_trivially_destructible) {
+    *sharing_info = BLO_read_shared(&reader, data, read_fn);
+    return;
+  }
+  /* The array is stored as it is in memory, so it may be used from the blend-file directly. Only
+   * strings are written as DNA structs, see #write_array_data. */
+  const char *struct_name = dna_attr_type == int8_t(AttrType::String) ? "MStringProperty" :
+                                                                         nullptr;
+  *sharing_info = BLO_read_shared_mapped(
+      &reader, data, struct_name, size * cpp_type.size, cpp_type.alignment, read_fn);
 }
 
 static std::optional<Attribute::DataVariant> read_attr_data(BlendDataReader &reader,
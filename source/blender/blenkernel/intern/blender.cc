@@ -37,11 +37,13 @@
 #include "BKE_global.hh"
 #include "BKE_idprop.hh"
 #include "BKE_main.hh"
+#include "BKE_mesh_eval_share.hh"
 #include "BKE_node.hh"
 #include "BKE_screen.hh"
 #include "BKE_studiolight.h"
 
 #include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_debug.hh"
 
 #include "RE_texture.h"
 
@@ -68,6 +70,8 @@ void BKE_blender_free()
   BKE_studiolight_free();
 
   BKE_blender_globals_clear();
+  /* Normally empty once all depsgraphs are freed with the main database. */
+  bke::mesh_eval_share::clear();
 
   if (G.log.file != nullptr) {
     fclose(static_cast<FILE *>(G.log.file));
@@ -76,6 +80,7 @@ void BKE_blender_free()
   BKE_spacetypes_free(); /* after free main, it uses space callbacks */
 
   IMB_exit();
+  DEG_debug_trace_end();
   DEG_free_node_types();
 
   BKE_brush_system_exit();
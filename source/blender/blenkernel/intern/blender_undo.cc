@@ -133,6 +133,11 @@ MemFileUndoData *BKE_memfile_undo_encode(Main *bmain, MemFileUndoData *mfu_prev)
     }
     /* success = */ /* UNUSED */ BLO_write_file_mem(bmain, prevfile, &mfu->memfile, fileflags);
     mfu->undo_size = mfu->memfile.size;
+
+    /* The previous step is not active anymore, its data is only needed again when undoing. */
+    if (prevfile && USER_DEVELOPER_TOOL_TEST(&U, use_undo_compression)) {
+      BLO_memfile_compress(prevfile);
+    }
   }
 
   bmain->is_memfile_undo_written = true;
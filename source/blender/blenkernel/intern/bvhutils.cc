@@ -499,7 +499,7 @@ static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_legacy_faces(
     }
     BLI_bvhtree_insert(tree.get(), i, co[0], faces[i].v4 ? 4 : 3);
   }
-  BLI_bvhtree_balance(tree.get());
+  BLI_bvhtree_balance_ex(tree.get(), BVH_BALANCE_SAH);
   return tree;
 }
 
@@ -518,7 +518,8 @@ static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_tris(const Span
     copy_v3_v3(co[2], positions[corner_verts[corner_tris[tri][2]]]);
     BLI_bvhtree_insert(tree.get(), tri, co[0], 3);
   }
-  BLI_bvhtree_balance(tree.get());
+  /* Triangle trees are mostly used for ray-casts, which benefit from the slower SAH build. */
+  BLI_bvhtree_balance_ex(tree.get(), BVH_BALANCE_SAH);
   return tree;
 }
 
@@ -551,7 +552,7 @@ static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_tris(
       BLI_bvhtree_insert(tree.get(), tri, co[0], 3);
     }
   });
-  BLI_bvhtree_balance(tree.get());
+  BLI_bvhtree_balance_ex(tree.get(), BVH_BALANCE_SAH);
   return tree;
 }
 
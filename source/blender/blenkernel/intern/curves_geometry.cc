@@ -1946,8 +1946,13 @@ void CurvesGeometry::blend_read(BlendDataReader &reader)
   this->attribute_storage.wrap().blend_read(reader);
 
   if (this->curve_offsets) {
-    this->runtime->curve_offsets_sharing_info = BLO_read_shared(
-        &reader, &this->curve_offsets, [&]() {
+    this->runtime->curve_offsets_sharing_info = BLO_read_shared_mapped(
+        &reader,
+        &this->curve_offsets,
+        nullptr,
+        (int64_t(this->curve_num) + 1) * int64_t(sizeof(int)),
+        alignof(int),
+        [&]() {
           if (!BLO_read_array(&reader, &this->curve_offsets, int64_t(this->curve_num) + 1)) {
             this->curve_num = 0;
           }
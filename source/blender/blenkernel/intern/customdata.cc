@@ -4985,6 +4985,36 @@ static void blend_read_layer_data(BlendDataReader *reader, CustomDataLayer &laye
   }
 }
 
+/**
+ * Layers of trivial types without any separately allocated data are stored in the same layout
+ * they have in memory, so they don't need any processing when they are read.
+ */
+/** The DNA struct of the layer data as written by #blend_write_layer_data, null for raw data. */
+static const char *blend_read_layer_data_struct_name(const CustomDataLayer &layer)
+{
+  switch (layer.type) {
+    case CD_PAINT_MASK:
+    case CD_PROP_BOOL:
+      return nullptr;
+    default: {
+      const char *structname;
+      int structnum;
+      get_type_file_write_info(eCustomDataType(layer.type), &structname, &structnum);
+      return structnum > 0 ? structname : nullptr;
+    }
+  }
+}
+
+static bool blend_read_layer_data_can_be_mapped(const CustomDataLayer &layer,
+                                                const LayerTypeInfo *typeInfo)
+{
+  if (layer.flag & CD_FLAG_EXTERNAL) {
+    return false;
+  }
+  return typeInfo != nullptr && typeInfo->size > 0 && typeInfo->copy == nullptr &&
+         typeInfo->free == nullptr;
+}
+
 void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int count)
 {
   BLO_read_array_and_validate_size(reader, &data->layers, &data->totlayer);
@@ -5015,15 +5045,27 @@ void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int
     layer->sharing_info = nullptr;
 
     if (CustomData_verify_versions(data, i)) {
-      layer->sharing_info = BLO_read_shared(
-          reader, &layer->data, [&]() -> const ImplicitSharingInfo * {
-            blend_read_layer_data(reader, *layer, count);
-            if (layer->data == nullptr) {
-              return nullptr;
-            }
-            return make_implicit_sharing_info_for_layer(
-                eCustomDataType(layer->type), layer->data, count);
-          });
+      const auto read_fn = [&]() -> const ImplicitSharingInfo * {
+        blend_read_layer_data(reader, *layer, count);
+        if (layer->data == nullptr) {
+          return nullptr;
+        }
+        return make_implicit_sharing_info_for_layer(
+            eCustomDataType(layer->type), layer->data, count);
+      };
+      const LayerTypeInfo *typeInfo = layerType_getInfo(eCustomDataType(layer->type));
+      if (blend_read_layer_data_can_be_mapped(*layer, typeInfo)) {
+        /* The layer data may be used from the blend-file directly, without any copy. */
+        layer->sharing_info = BLO_read_shared_mapped(reader,
+                                                     &layer->data,
+                                                     blend_read_layer_data_struct_name(*layer),
+                                                     int64_t(count) * typeInfo->size,
+                                                     typeInfo->alignment,
+                                                     read_fn);
+      }
+      else {
+        layer->sharing_info = BLO_read_shared(reader, &layer->data, read_fn);
+      }
       i++;
     }
   }
@@ -9,6 +9,7 @@
  * allocate and free of all library data
  */
 
+#include <atomic>
 #include <cctype>
 #include <cstddef>
 #include <cstdio>
@@ -1332,9 +1333,17 @@ void BKE_libblock_runtime_ensure(ID &id)
 {
   if (!id.runtime) {
     id.runtime = MEM_new<bke::id::ID_Runtime>(__func__);
+    BKE_id_update_stamp_tag(id);
   }
 }
 
+void BKE_id_update_stamp_tag(ID &id)
+{
+  static std::atomic<uint64_t> global_update_stamp = 0;
+  id.runtime->update_stamp.store(global_update_stamp.fetch_add(1) + 1,
+                                 std::memory_order_relaxed);
+}
+
 size_t BKE_libblock_get_alloc_info(short type, const char **r_name)
 {
   const IDTypeInfo *id_type = BKE_idtype_get_info_from_idcode(type);
@@ -477,8 +477,13 @@ static void mesh_blend_read_data(BlendDataReader *reader, ID *id)
   mesh->runtime = new bke::MeshRuntime();
 
   if (mesh->face_offset_indices) {
-    mesh->runtime->face_offsets_sharing_info = BLO_read_shared(
-        reader, &mesh->face_offset_indices, [&]() {
+    mesh->runtime->face_offsets_sharing_info = BLO_read_shared_mapped(
+        reader,
+        &mesh->face_offset_indices,
+        nullptr,
+        (int64_t(mesh->faces_num) + 1) * int64_t(sizeof(int)),
+        alignof(int),
+        [&]() {
           if (!BLO_read_array(reader, &mesh->face_offset_indices, int64_t(mesh->faces_num) + 1)) {
             mesh->faces_num = 0;
           }
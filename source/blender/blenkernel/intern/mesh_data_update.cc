@@ -32,6 +32,7 @@
 #include "BKE_lib_id.hh"
 #include "BKE_material.hh"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_eval_share.hh"
 #include "BKE_mesh_iterators.hh"
 #include "BKE_mesh_runtime.hh"
 #include "BKE_mesh_wrapper.hh"
@@ -912,8 +913,18 @@ static void mesh_build_data(Depsgraph &depsgraph,
                             const bool need_mapping)
 {
   const Mesh &mesh_input = *id_cast<const Mesh *>(ob.data);
-  GeometrySet geometry_set = mesh_calc_modifiers(
-      depsgraph, scene, ob, true, need_mapping, dataMask, true);
+  /* Reuse the result of other depsgraphs evaluating the object with the same inputs, e.g. when
+   * rendering multiple view layers. */
+  std::optional<GeometrySet> shared_geometry_set = mesh_eval_share::lookup(
+      depsgraph, scene, ob, dataMask, need_mapping);
+  GeometrySet geometry_set;
+  if (shared_geometry_set) {
+    geometry_set = std::move(*shared_geometry_set);
+  }
+  else {
+    geometry_set = mesh_calc_modifiers(depsgraph, scene, ob, true, need_mapping, dataMask, true);
+    mesh_eval_share::add(depsgraph, scene, ob, dataMask, need_mapping, geometry_set);
+  }
   const Mesh *mesh_eval = geometry_set.get_mesh();
 
   /* Make sure that drivers can target shapekey properties.
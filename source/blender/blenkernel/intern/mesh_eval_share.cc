@@ -0,0 +1,627 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <algorithm>
+#include <xxhash.h>
+
+#include "DNA_anim_types.h"
+#include "DNA_customdata_types.h"
+#include "DNA_key_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BLI_hash.hh"
+#include "BLI_listbase.hh"
+#include "BLI_map.hh"
+#include "BLI_math_matrix_types.hh"
+#include "BLI_memory_counter.hh"
+#include "BLI_mutex.hh"
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_anim_data.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_lib_query.hh"
+#include "BKE_mesh_eval_share.hh"
+#include "BKE_mesh_types.hh"
+#include "BKE_modifier.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_object_types.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_query.hh"
+
+#include "NOD_dependencies.hh"
+
+namespace blender::bke::mesh_eval_share {
+
+/**
+ * Identifies the object whose evaluated mesh is shared. Evaluated objects keep the session UID of
+ * their original, so it is the same in all depsgraphs.
+ */
+struct ObjectKey {
+  uint32_t session_uid;
+  eEvaluationMode mode;
+
+  uint64_t hash() const
+  {
+    return get_default_hash(session_uid, int(mode));
+  }
+
+  friend bool operator==(const ObjectKey &a, const ObjectKey &b)
+  {
+    return a.session_uid == b.session_uid && a.mode == b.mode;
+  }
+};
+
+/**
+ * Everything the evaluated mesh of an object depends on. Changes to the data-blocks are detected
+ * with their update stamps, which change whenever they are tagged for update.
+ */
+struct EvalState {
+  uint64_t object_stamp = 0;
+  uint64_t mesh_stamp = 0;
+  uint64_t key_stamp = 0;
+  uint64_t scene_stamp = 0;
+  /** Stamps of the actions of the object, the mesh and the shape keys. */
+  uint64_t action_stamps[3] = {};
+  /** Combined stamps of the node groups used by geometry nodes modifiers. */
+  uint64_t node_groups_stamp = 0;
+  float ctime = 0.0f;
+  CustomData_MeshMasks data_mask;
+  bool need_mapping = false;
+  /**
+   * Hash of the evaluated object transform and modifier settings. Together with #mesh_data, this
+   * detects changes of data-blocks that were edited without being tagged for update.
+   */
+  uint64_t settings_hash = 0;
+  /**
+   * The arrays of the evaluated input mesh, and their versions when the state was taken. Writing
+   * to shared arrays copies them or changes their version, so the state of a depsgraph that was
+   * copied from a modified original mesh never matches.
+   */
+  Vector<std::pair<WeakImplicitSharingPtr, int64_t>> mesh_data;
+
+  friend bool operator==(const EvalState &a, const EvalState &b)
+  {
+    return a.object_stamp == b.object_stamp && a.mesh_stamp == b.mesh_stamp &&
+           a.key_stamp == b.key_stamp && a.scene_stamp == b.scene_stamp &&
+           std::equal(std::begin(a.action_stamps),
+                      std::end(a.action_stamps),
+                      std::begin(b.action_stamps)) &&
+           a.node_groups_stamp == b.node_groups_stamp && a.ctime == b.ctime &&
+           a.data_mask.vmask == b.data_mask.vmask &&
+           a.data_mask.emask == b.data_mask.emask && a.data_mask.fmask == b.data_mask.fmask &&
+           a.data_mask.pmask == b.data_mask.pmask && a.data_mask.lmask == b.data_mask.lmask &&
+           a.need_mapping == b.need_mapping && a.settings_hash == b.settings_hash &&
+           a.mesh_data == b.mesh_data;
+  }
+};
+
+struct SharedMesh {
+  EvalState state;
+  /**
+   * Mesh component with the final mesh. ID pointers in the mesh point to original data-blocks,
+   * since the evaluated ones belong to the depsgraph that added the mesh.
+   */
+  GeometryComponentPtr mesh;
+  /** Mesh with only deform modifiers applied, null when it is the input mesh. */
+  GeometryComponentPtr mesh_deform;
+  /**
+   * Depsgraphs that evaluated the object to this mesh. Without users, the mesh is only kept while
+   * a render job is running.
+   */
+  Set<const Depsgraph *> users;
+};
+
+/**
+ * Singleton cache that's shared throughout the application. Objects are evaluated from multiple
+ * threads, so the cache is protected by a mutex.
+ */
+struct GlobalCache {
+  Mutex mutex;
+  Map<ObjectKey, SharedMesh> meshes;
+  /** Number of running render jobs, see #render_job_begin. */
+  int render_jobs_num = 0;
+};
+
+/**
+ * Uses the "construct on first use" idiom to get the cache.
+ */
+static GlobalCache &get_global_cache()
+{
+  static GlobalCache global_cache;
+  return global_cache;
+}
+
+static uint64_t id_update_stamp(const ID *id)
+{
+  if (id == nullptr) {
+    return 0;
+  }
+  return DEG_get_original_id(id)->runtime->update_stamp.load(std::memory_order_relaxed);
+}
+
+/**
+ * Hash the values stored in the ID property, or nothing for types that are not used for modifier
+ * inputs.
+ */
+static bool hash_id_property(const IDProperty &prop, uint64_t &hash)
+{
+  hash = get_default_hash(hash, StringRef(prop.name), int(prop.type), int(prop.subtype));
+  switch (prop.type) {
+    case IDP_INT:
+    case IDP_FLOAT:
+    case IDP_BOOLEAN:
+      hash = get_default_hash(hash, prop.data.val);
+      return true;
+    case IDP_DOUBLE:
+      hash = get_default_hash(hash, prop.data.val, prop.data.val2);
+      return true;
+    case IDP_STRING:
+      hash = XXH3_64bits_withSeed(prop.data.pointer, size_t(prop.len), hash);
+      return true;
+    case IDP_ARRAY: {
+      size_t element_size = 0;
+      switch (prop.subtype) {
+        case IDP_INT:
+          element_size = sizeof(int);
+          break;
+        case IDP_FLOAT:
+          element_size = sizeof(float);
+          break;
+        case IDP_DOUBLE:
+          element_size = sizeof(double);
+          break;
+        case IDP_BOOLEAN:
+          element_size = sizeof(int8_t);
+          break;
+        default:
+          return false;
+      }
+      hash = XXH3_64bits_withSeed(prop.data.pointer, element_size * size_t(prop.len), hash);
+      return true;
+    }
+    case IDP_GROUP:
+      for (const IDProperty &child : prop.data.group) {
+        if (!hash_id_property(child, hash)) {
+          return false;
+        }
+      }
+      return true;
+    case IDP_ID: {
+      /* The pointers differ between depsgraphs, the session UID is the same. */
+      const ID *id = static_cast<const ID *>(prop.data.pointer);
+      hash = get_default_hash(hash, id ? id->session_uid : 0);
+      return true;
+    }
+    case IDP_IDPARRAY:
+      return false;
+  }
+  return false;
+}
+
+static std::optional<uint64_t> settings_hash(const Object &ob)
+{
+  uint64_t hash = XXH3_64bits(&ob.object_to_world(), sizeof(float4x4));
+  for (const ModifierData &md : ob.modifiers) {
+    /* The #ModifierData header contains pointers and UI state that don't affect the result. */
+    hash = get_default_hash(hash, md.type, md.mode, md.flag);
+    if (md.type == eModifierType_Nodes) {
+      /* The inputs are stored in ID properties, the rest of the struct is mostly pointers that
+       * differ between depsgraphs. */
+      const NodesModifierData &nmd = reinterpret_cast<const NodesModifierData &>(md);
+      hash = get_default_hash(
+          hash, nmd.node_group ? nmd.node_group->id.session_uid : 0, int(nmd.flag));
+      if (md.system_properties && !hash_id_property(*md.system_properties, hash)) {
+        return std::nullopt;
+      }
+      continue;
+    }
+    const ModifierTypeInfo *mti = BKE_modifier_get_info(ModifierType(md.type));
+    hash = XXH3_64bits_withSeed(
+        POINTER_OFFSET(&md, sizeof(ModifierData)), mti->struct_size - sizeof(ModifierData), hash);
+  }
+  return hash;
+}
+
+/**
+ * Get the shared arrays of the mesh with their versions, or nothing when some arrays are not
+ * shared, so that their changes cannot be detected.
+ */
+static std::optional<Vector<std::pair<WeakImplicitSharingPtr, int64_t>>> mesh_data_versions(
+    const Mesh &mesh)
+{
+  MemoryCount shared_count;
+  MemoryCounter shared_counter(shared_count);
+  mesh.count_memory(shared_counter);
+  /* Counting again skips the shared data that was counted already. */
+  MemoryCount unique_count;
+  unique_count.handled_shared_data = shared_count.handled_shared_data;
+  MemoryCounter unique_counter(unique_count);
+  mesh.count_memory(unique_counter);
+  if (unique_count.total_bytes > 0) {
+    return std::nullopt;
+  }
+
+  Vector<std::pair<WeakImplicitSharingPtr, int64_t>> data;
+  for (const WeakImplicitSharingPtr &sharing_info : shared_count.handled_shared_data) {
+    data.append({sharing_info, sharing_info->version()});
+  }
+  std::sort(data.begin(), data.end(), [](const auto &a, const auto &b) {
+    return a.first.get() < b.first.get();
+  });
+  return data;
+}
+
+/**
+ * Animation is supported as long as it only depends on the evaluated time and the action itself.
+ */
+static bool animation_is_shareable(const ID *id, uint64_t &r_action_stamp)
+{
+  const AnimData *adt = BKE_animdata_from_id(id);
+  if (adt == nullptr) {
+    r_action_stamp = 0;
+    return true;
+  }
+  if (!BLI_listbase_is_empty(&adt->drivers) || !BLI_listbase_is_empty(&adt->nla_tracks) ||
+      adt->tmpact != nullptr)
+  {
+    return false;
+  }
+  r_action_stamp = id_update_stamp(reinterpret_cast<const ID *>(adt->action));
+  return true;
+}
+
+static void add_node_group_stamps(const bNodeTree &tree,
+                                  Set<const bNodeTree *> &added_groups,
+                                  uint64_t &r_stamp)
+{
+  if (!added_groups.add(&tree)) {
+    return;
+  }
+  r_stamp = get_default_hash(r_stamp, id_update_stamp(&tree.id));
+  for (const bNode &node : tree.nodes) {
+    if (node.is_group() && node.id != nullptr) {
+      add_node_group_stamps(*reinterpret_cast<const bNodeTree *>(node.id), added_groups, r_stamp);
+    }
+  }
+}
+
+/**
+ * Geometry nodes can be shared when the result only depends on the modifier inputs, the node
+ * groups and the state that is compared for all objects, like the time and the object transform.
+ * Simulations and bakes are excluded, since they depend on previously evaluated frames.
+ */
+static bool node_group_is_shareable(const NodesModifierData &nmd)
+{
+  if (nmd.bakes_num > 0) {
+    return false;
+  }
+  const bNodeTree &node_group = *DEG_get_original(nmd.node_group);
+  const nodes::EvalDependencies *deps = node_group.runtime->eval_dependencies.get();
+  if (deps == nullptr || deps->needs_active_camera || deps->needs_scene_render_params) {
+    return false;
+  }
+  /* Materials are only referenced by the result, the copies use the depsgraph's own. */
+  for (const ID *id : deps->ids.values()) {
+    if (GS(id->name) != ID_MA) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool modifiers_are_shareable(const Object &ob, uint64_t &r_node_groups_stamp)
+{
+  Set<const bNodeTree *> added_groups;
+  r_node_groups_stamp = 0;
+  for (const ModifierData &md : ob.modifiers) {
+    const ModifierTypeInfo *mti = BKE_modifier_get_info(ModifierType(md.type));
+    if (mti->flags & eModifierTypeFlag_UsesPointCache) {
+      return false;
+    }
+    /* These store evaluation data on the evaluated modifier which is used by other objects. */
+    if (ELEM(md.type, eModifierType_Collision, eModifierType_Surface, eModifierType_Fluid)) {
+      return false;
+    }
+    const bool is_nodes = md.type == eModifierType_Nodes;
+    if (is_nodes) {
+      const NodesModifierData &nmd = reinterpret_cast<const NodesModifierData &>(md);
+      if (nmd.node_group != nullptr) {
+        if (!node_group_is_shareable(nmd)) {
+          return false;
+        }
+        add_node_group_stamps(
+            *DEG_get_original(nmd.node_group), added_groups, r_node_groups_stamp);
+      }
+    }
+    if (mti->foreach_ID_link == nullptr) {
+      continue;
+    }
+    /* Referenced data-blocks may be evaluated differently in every depsgraph. Node groups and
+     * materials passed to geometry nodes are the exception, see #node_group_is_shareable. */
+    struct IDLinkCheck {
+      bool is_nodes;
+      bool uses_ids = false;
+    } check{is_nodes};
+    mti->foreach_ID_link(
+        const_cast<ModifierData *>(&md),
+        const_cast<Object *>(&ob),
+        [](void *user_data,
+           Object * /*ob*/,
+           ID **idpoin,
+           LibraryForeachIDCallbackFlag /*cb_flag*/) {
+          IDLinkCheck &check = *static_cast<IDLinkCheck *>(user_data);
+          if (*idpoin == nullptr) {
+            return;
+          }
+          if (check.is_nodes && ELEM(GS((*idpoin)->name), ID_NT, ID_MA)) {
+            return;
+          }
+          check.uses_ids = true;
+        },
+        &check);
+    if (check.uses_ids) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Get the state the evaluated mesh of the object depends on, or nothing when the evaluation can
+ * depend on more than that.
+ */
+static std::optional<EvalState> get_eval_state(const Depsgraph &depsgraph,
+                                               const Scene &scene,
+                                               const Object &ob,
+                                               const CustomData_MeshMasks &data_mask,
+                                               const bool need_mapping)
+{
+  if (DEG_is_active(&depsgraph)) {
+    return std::nullopt;
+  }
+  if (ob.type != OB_MESH || ob.mode != OB_MODE_OBJECT || ob.runtime->sculpt_session != nullptr) {
+    return std::nullopt;
+  }
+  if (BLI_listbase_is_empty(&ob.modifiers) || !BLI_listbase_is_empty(&ob.particlesystem)) {
+    return std::nullopt;
+  }
+  /* Parenting to an armature, curve or lattice adds a virtual modifier deforming the mesh. */
+  if (ob.parent != nullptr && ob.partype == PARSKEL) {
+    return std::nullopt;
+  }
+  const Mesh &mesh = *id_cast<const Mesh *>(ob.data);
+  if (mesh.runtime->edit_mesh || mesh.texcomesh != nullptr) {
+    return std::nullopt;
+  }
+
+  EvalState state;
+  if (!animation_is_shareable(&ob.id, state.action_stamps[0]) ||
+      !animation_is_shareable(&mesh.id, state.action_stamps[1]) ||
+      (mesh.key && !animation_is_shareable(&mesh.key->id, state.action_stamps[2])))
+  {
+    return std::nullopt;
+  }
+  if (!modifiers_are_shareable(ob, state.node_groups_stamp)) {
+    return std::nullopt;
+  }
+  const std::optional<uint64_t> ob_settings_hash = settings_hash(ob);
+  if (!ob_settings_hash) {
+    return std::nullopt;
+  }
+
+  std::optional<Vector<std::pair<WeakImplicitSharingPtr, int64_t>>> mesh_data =
+      mesh_data_versions(mesh);
+  if (!mesh_data) {
+    return std::nullopt;
+  }
+  state.mesh_data = std::move(*mesh_data);
+  state.settings_hash = *ob_settings_hash;
+  state.object_stamp = id_update_stamp(&ob.id);
+  state.mesh_stamp = id_update_stamp(&mesh.id);
+  state.key_stamp = mesh.key ? id_update_stamp(&mesh.key->id) : 0;
+  state.scene_stamp = id_update_stamp(&scene.id);
+  state.ctime = DEG_get_ctime(&depsgraph);
+  state.data_mask = data_mask;
+  state.need_mapping = need_mapping;
+  return state;
+}
+
+/**
+ * Copy the mesh component, pointing the ID pointers of the new mesh to the evaluated data-blocks
+ * of the depsgraph, or to the original data-blocks when there is no depsgraph. The copy shares its
+ * arrays with the source mesh.
+ */
+static GeometryComponentPtr copy_with_remapped_ids(const GeometryComponent &component,
+                                                   const Depsgraph *depsgraph)
+{
+  GeometryComponentPtr copy = component.copy();
+  Mesh *mesh = static_cast<MeshComponent &>(copy.ensure_mutable_inplace()).get_for_write();
+  BKE_library_foreach_ID_link(
+      nullptr,
+      &mesh->id,
+      [&](LibraryIDLinkCallbackData *cb_data) {
+        ID *id = *cb_data->id_pointer;
+        if (id != nullptr) {
+          *cb_data->id_pointer = depsgraph ? DEG_get_evaluated_id(depsgraph, id) :
+                                             DEG_get_original_id(id);
+        }
+        return IDWALK_RET_NOP;
+      },
+      nullptr,
+      IDWALK_NOP);
+  return copy;
+}
+
+std::optional<GeometrySet> lookup(const Depsgraph &depsgraph,
+                                  const Scene &scene,
+                                  const Object &ob,
+                                  const CustomData_MeshMasks &data_mask,
+                                  const bool need_mapping)
+{
+  const std::optional<EvalState> state = get_eval_state(
+      depsgraph, scene, ob, data_mask, need_mapping);
+  if (!state) {
+    return std::nullopt;
+  }
+  const ObjectKey key{ob.id.session_uid, DEG_get_mode(&depsgraph)};
+
+  GeometryComponentPtr mesh;
+  GeometryComponentPtr mesh_deform;
+  {
+    GlobalCache &cache = get_global_cache();
+    std::lock_guard lock{cache.mutex};
+    SharedMesh *shared_mesh = cache.meshes.lookup_ptr(key);
+    if (shared_mesh == nullptr || shared_mesh->state != *state) {
+      return std::nullopt;
+    }
+    shared_mesh->users.add(&depsgraph);
+    /* Keep the components alive while copying them, the entry may be replaced meanwhile. */
+    mesh = shared_mesh->mesh;
+    mesh_deform = shared_mesh->mesh_deform;
+  }
+
+  GeometrySet geometry_set;
+  geometry_set.add(*copy_with_remapped_ids(*mesh, &depsgraph));
+  auto &edit_data = geometry_set.get_component_for_write<GeometryComponentEditData>();
+  edit_data.mesh_edit_hints_ = std::make_unique<MeshEditHints>();
+  if (mesh_deform) {
+    edit_data.mesh_edit_hints_->mesh_deform = copy_with_remapped_ids(*mesh_deform, &depsgraph);
+  }
+  else {
+    edit_data.mesh_edit_hints_->mesh_deform = GeometryComponentPtr(new MeshComponent(
+        id_cast<Mesh *>(ob.data), GeometryOwnershipType::ReadOnly));
+  }
+  return geometry_set;
+}
+
+/**
+ * Only meshes that are owned by the geometry are shared, which excludes objects without any
+ * modifiers that change the input mesh.
+ */
+static bool geometry_is_shareable(const GeometrySet &geometry_set, const Mesh &mesh_input)
+{
+  for (const GeometryComponent *component : geometry_set.get_components()) {
+    switch (component->type()) {
+      case GeometryComponent::Type::Mesh: {
+        const MeshComponent &mesh_component = *static_cast<const MeshComponent *>(component);
+        if (!mesh_component.owns_direct_data() || mesh_component.get() == &mesh_input) {
+          return false;
+        }
+        break;
+      }
+      case GeometryComponent::Type::Edit: {
+        const auto &edit_data = *static_cast<const GeometryComponentEditData *>(component);
+        if (edit_data.curves_edit_hints_ || edit_data.grease_pencil_edit_hints_ ||
+            edit_data.gizmo_edit_hints_)
+        {
+          return false;
+        }
+        if (edit_data.mesh_edit_hints_ && edit_data.mesh_edit_hints_->mesh_cage) {
+          return false;
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  const Mesh *mesh = geometry_set.get_mesh();
+  return mesh != nullptr && mesh->runtime->wrapper_type == ME_WRAPPER_TYPE_MDATA;
+}
+
+void add(const Depsgraph &depsgraph,
+         const Scene &scene,
+         const Object &ob,
+         const CustomData_MeshMasks &data_mask,
+         const bool need_mapping,
+         const GeometrySet &geometry_set)
+{
+  const Mesh &mesh_input = *id_cast<const Mesh *>(ob.data);
+  if (!geometry_is_shareable(geometry_set, mesh_input)) {
+    return;
+  }
+  std::optional<EvalState> state = get_eval_state(depsgraph, scene, ob, data_mask, need_mapping);
+  if (!state) {
+    return;
+  }
+  const ObjectKey key{ob.id.session_uid, DEG_get_mode(&depsgraph)};
+
+  /* The depsgraph keeps using its own mesh, the cache stores a copy that is never drawn, so no
+   * evaluation or draw caches of the depsgraph end up in the shared mesh. */
+  SharedMesh shared_mesh;
+  shared_mesh.state = *state;
+  shared_mesh.mesh = copy_with_remapped_ids(
+      *geometry_set.get_component(GeometryComponent::Type::Mesh), nullptr);
+  if (const GeometryComponentEditData *edit_data = geometry_set.get_component<
+          GeometryComponentEditData>())
+  {
+    if (edit_data->mesh_edit_hints_ && edit_data->mesh_edit_hints_->mesh_deform) {
+      const auto &mesh_deform = static_cast<const MeshComponent &>(
+          *edit_data->mesh_edit_hints_->mesh_deform);
+      if (mesh_deform.get() != &mesh_input) {
+        shared_mesh.mesh_deform = copy_with_remapped_ids(mesh_deform, nullptr);
+      }
+    }
+  }
+  shared_mesh.users.add(&depsgraph);
+
+  GlobalCache &cache = get_global_cache();
+  std::lock_guard lock{cache.mutex};
+  SharedMesh *existing = cache.meshes.lookup_ptr(key);
+  if (existing != nullptr && existing->state == *state) {
+    /* Another depsgraph evaluated the same state at the same time. */
+    existing->users.add(&depsgraph);
+    return;
+  }
+  /* Depsgraphs still using the previous state keep their own meshes. */
+  cache.meshes.add_overwrite(key, std::move(shared_mesh));
+}
+
+void remove_depsgraph(const Depsgraph &depsgraph)
+{
+  GlobalCache &cache = get_global_cache();
+  std::lock_guard lock{cache.mutex};
+  const bool keep_unused = cache.render_jobs_num > 0;
+  cache.meshes.remove_if([&](auto item) {
+    item.value.users.remove(&depsgraph);
+    return item.value.users.is_empty() && !keep_unused;
+  });
+}
+
+void render_job_begin()
+{
+  GlobalCache &cache = get_global_cache();
+  std::lock_guard lock{cache.mutex};
+  cache.render_jobs_num++;
+}
+
+void render_job_end()
+{
+  GlobalCache &cache = get_global_cache();
+  std::lock_guard lock{cache.mutex};
+  BLI_assert(cache.render_jobs_num > 0);
+  cache.render_jobs_num--;
+  if (cache.render_jobs_num == 0) {
+    cache.meshes.remove_if([&](auto item) { return item.value.users.is_empty(); });
+  }
+}
+
+void clear()
+{
+  GlobalCache &cache = get_global_cache();
+  std::lock_guard lock{cache.mutex};
+  cache.meshes.clear();
+}
+
+}  // namespace blender::bke::mesh_eval_share
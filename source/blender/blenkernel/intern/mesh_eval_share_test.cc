@@ -0,0 +1,191 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_listbase.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_collection.hh"
+#include "BKE_gtest_base.hh"
+#include "BKE_layer.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.h"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_eval_share.hh"
+#include "BKE_modifier.hh"
+#include "BKE_object.hh"
+#include "BKE_scene.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_query.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "testing/testing.h"
+
+namespace blender::bke::tests {
+
+class MeshEvalShareTest : public BlenderGTestBase {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  Object *ob = nullptr;
+  Mesh *mesh = nullptr;
+  Vector<Depsgraph *> depsgraphs;
+
+  void SetUp() override
+  {
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+
+    ob = BKE_object_add_only_object(bmain, OB_MESH, "Object");
+    mesh = BKE_mesh_add(bmain, "Mesh");
+    ob->data = id_cast<ID *>(mesh);
+    Mesh *mesh_src = BKE_mesh_new_nomain(4, 0, 0, 0);
+    mesh_src->vert_positions_for_write().copy_from(
+        {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}});
+    BKE_mesh_nomain_to_mesh(mesh_src, mesh, ob);
+    BKE_collection_object_add(bmain, scene->master_collection, ob);
+
+    /* Creates a new mesh that does not reference other data-blocks, so it can be shared. */
+    ModifierData *md = BKE_modifier_new(eModifierType_Array);
+    BLI_addtail(&ob->modifiers, md);
+    BKE_modifiers_persistent_uid_init(*ob, *md);
+  }
+
+  void TearDown() override
+  {
+    for (Depsgraph *depsgraph : depsgraphs) {
+      DEG_graph_free(depsgraph);
+    }
+    BKE_main_free(bmain);
+  }
+
+  Depsgraph *evaluate(const eEvaluationMode mode, ViewLayer *view_layer = nullptr)
+  {
+    if (view_layer == nullptr) {
+      view_layer = static_cast<ViewLayer *>(scene->view_layers.first);
+    }
+    Depsgraph *depsgraph = DEG_graph_new(bmain, scene, view_layer, mode);
+    DEG_graph_build_from_view_layer(depsgraph);
+    BKE_scene_graph_update_tagged(depsgraph, bmain);
+    depsgraphs.append(depsgraph);
+    return depsgraph;
+  }
+
+  void free_depsgraph(Depsgraph *depsgraph)
+  {
+    depsgraphs.remove_first_occurrence_and_reorder(depsgraph);
+    DEG_graph_free(depsgraph);
+  }
+
+  Span<float3> evaluated_positions(Depsgraph *depsgraph) const
+  {
+    const Object *ob_eval = DEG_get_evaluated(depsgraph, ob);
+    return BKE_object_get_evaluated_mesh(ob_eval)->vert_positions();
+  }
+
+  /** Reference the evaluated positions without keeping them alive. */
+  WeakImplicitSharingPtr evaluated_positions_sharing_info(Depsgraph *depsgraph) const
+  {
+    const Object *ob_eval = DEG_get_evaluated(depsgraph, ob);
+    const Mesh *mesh_eval = BKE_object_get_evaluated_mesh(ob_eval);
+    const ImplicitSharingInfo *sharing_info =
+        mesh_eval->attributes().lookup("position").sharing_info;
+    sharing_info->add_weak_user();
+    return WeakImplicitSharingPtr(sharing_info);
+  }
+};
+
+TEST_F(MeshEvalShareTest, share_hit)
+{
+  Depsgraph *depsgraph_a = evaluate(DAG_EVAL_RENDER);
+  Depsgraph *depsgraph_b = evaluate(DAG_EVAL_RENDER);
+  const Span<float3> positions_a = evaluated_positions(depsgraph_a);
+  const Span<float3> positions_b = evaluated_positions(depsgraph_b);
+  EXPECT_EQ(positions_a.size(), 8);
+  EXPECT_EQ(positions_a.data(), positions_b.data());
+}
+
+TEST_F(MeshEvalShareTest, share_between_sequential_view_layers)
+{
+  ViewLayer *view_layer_a = static_cast<ViewLayer *>(scene->view_layers.first);
+  ViewLayer *view_layer_b = BKE_view_layer_add(
+      bmain, scene, "View Layer B", nullptr, VIEWLAYER_ADD_NEW);
+
+  /* Like a render, which frees the depsgraph of a view layer before evaluating the next one. */
+  mesh_eval_share::render_job_begin();
+  Depsgraph *depsgraph_a = evaluate(DAG_EVAL_RENDER, view_layer_a);
+  const WeakImplicitSharingPtr positions_a = evaluated_positions_sharing_info(depsgraph_a);
+  free_depsgraph(depsgraph_a);
+  EXPECT_FALSE(positions_a->is_expired());
+
+  Depsgraph *depsgraph_b = evaluate(DAG_EVAL_RENDER, view_layer_b);
+  EXPECT_EQ(evaluated_positions_sharing_info(depsgraph_b), positions_a);
+  mesh_eval_share::render_job_end();
+
+  /* The mesh is still used by the second depsgraph. */
+  EXPECT_FALSE(positions_a->is_expired());
+  free_depsgraph(depsgraph_b);
+  EXPECT_TRUE(positions_a->is_expired());
+}
+
+TEST_F(MeshEvalShareTest, free_without_render_job)
+{
+  Depsgraph *depsgraph = evaluate(DAG_EVAL_RENDER);
+  const WeakImplicitSharingPtr positions = evaluated_positions_sharing_info(depsgraph);
+  free_depsgraph(depsgraph);
+  EXPECT_TRUE(positions->is_expired());
+}
+
+TEST_F(MeshEvalShareTest, invalidate_after_tag)
+{
+  Depsgraph *depsgraph_a = evaluate(DAG_EVAL_RENDER);
+  const float3 *positions_a_data = evaluated_positions(depsgraph_a).data();
+
+  mesh->vert_positions_for_write()[0] = float3(0.0f, 0.0f, 5.0f);
+  DEG_id_tag_update_ex(bmain, &mesh->id, ID_RECALC_GEOMETRY);
+
+  Depsgraph *depsgraph_b = evaluate(DAG_EVAL_RENDER);
+  const Span<float3> positions_b = evaluated_positions(depsgraph_b);
+  EXPECT_NE(positions_b.data(), positions_a_data);
+  EXPECT_EQ(positions_b[0], float3(0.0f, 0.0f, 5.0f));
+
+  /* The tagged depsgraph evaluates the same new state again, and can reuse that. */
+  BKE_scene_graph_update_tagged(depsgraph_a, bmain);
+  EXPECT_EQ(evaluated_positions(depsgraph_a).data(), positions_b.data());
+}
+
+TEST_F(MeshEvalShareTest, invalidate_after_untagged_edit)
+{
+  Depsgraph *depsgraph_a = evaluate(DAG_EVAL_RENDER);
+  const Span<float3> positions_a = evaluated_positions(depsgraph_a);
+
+  /* Edits that don't tag the mesh are not propagated to existing depsgraphs, but new ones must
+   * not reuse the outdated result. */
+  mesh->vert_positions_for_write()[0] = float3(0.0f, 0.0f, 5.0f);
+
+  Depsgraph *depsgraph_b = evaluate(DAG_EVAL_RENDER);
+  const Span<float3> positions_b = evaluated_positions(depsgraph_b);
+  EXPECT_NE(positions_b.data(), positions_a.data());
+  EXPECT_EQ(positions_a[0], float3(0.0f, 0.0f, 0.0f));
+  EXPECT_EQ(positions_b[0], float3(0.0f, 0.0f, 5.0f));
+}
+
+TEST_F(MeshEvalShareTest, no_share_with_different_eval_mode)
+{
+  Depsgraph *depsgraph_viewport = evaluate(DAG_EVAL_VIEWPORT);
+  Depsgraph *depsgraph_render = evaluate(DAG_EVAL_RENDER);
+  const Span<float3> positions_viewport = evaluated_positions(depsgraph_viewport);
+  const Span<float3> positions_render = evaluated_positions(depsgraph_render);
+  EXPECT_EQ(positions_viewport.size(), positions_render.size());
+  EXPECT_NE(positions_viewport.data(), positions_render.data());
+}
+
+}  // namespace blender::bke::tests
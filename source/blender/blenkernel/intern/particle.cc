@@ -2669,7 +2669,10 @@ void psys_find_parents(ParticleSimulationData *sim, const bool use_render_params
 
   kdtree_balance<float3>(tree);
 
-  for (; p < totchild; p++, cpa++) {
+  /* Find the parents of the remaining children in one batch, which is done in parallel. */
+  ChildParticle *children = cpa;
+  Array<float3> child_orcos(std::max(totchild - p, 0));
+  for (float3 &child_orco : child_orcos) {
     psys_particle_on_emitter(sim->psmd,
                              from,
                              cpa->num,
@@ -2680,8 +2683,14 @@ void psys_find_parents(ParticleSimulationData *sim, const bool use_render_params
                              nullptr,
                              nullptr,
                              nullptr,
-                             orco);
-    cpa->parent = kdtree_find_nearest<float3>(tree, orco, nullptr);
+                             child_orco);
+    cpa++;
+  }
+
+  Array<int> parents(child_orcos.size());
+  kdtree_find_nearest_batch<float3>(tree, child_orcos, parents);
+  for (const int i : parents.index_range()) {
+    children[i].parent = parents[i];
   }
 
   kdtree_free<float3>(tree);
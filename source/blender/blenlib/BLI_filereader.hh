@@ -25,17 +25,28 @@ namespace blender {
 typedef int64_t off64_t;
 #endif
 
+class ImplicitSharingInfo;
 struct FileReader;
 
 typedef int64_t (*FileReaderReadFn)(struct FileReader *reader, void *buffer, size_t size);
 typedef off64_t (*FileReaderSeekFn)(struct FileReader *reader, off64_t offset, int whence);
 typedef void (*FileReaderCloseFn)(struct FileReader *reader);
+typedef const void *(*FileReaderMapFn)(struct FileReader *reader,
+                                       off64_t offset,
+                                       size_t size,
+                                       const ImplicitSharingInfo **r_sharing_info);
 
 /** General structure for all #FileReaders, implementations add custom fields at the end. */
 struct FileReader {
   FileReaderReadFn read;
   FileReaderSeekFn seek;
   FileReaderCloseFn close;
+  /**
+   * Optional, reference `size` bytes at `offset` in the underlying storage without copying them.
+   * On success, the caller owns a user of `r_sharing_info`, which keeps the memory alive even
+   * after the reader is closed. Returns null when the data cannot be referenced directly.
+   */
+  FileReaderMapFn map;
 
   off64_t offset;
 };
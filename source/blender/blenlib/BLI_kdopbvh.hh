@@ -10,7 +10,9 @@
 
 #include "BLI_function_ref.hh"
 #include "BLI_hash.hh"
+#include "BLI_index_mask_fwd.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_sys_types.hh"
 
 namespace blender {
@@ -96,6 +98,12 @@ enum {
   /* calculate IsectRayPrecalc data */
   BVH_RAYCAST_WATERTIGHT = (1 << 0),
 };
+enum {
+  /* Choose splits with the surface area heuristic instead of splitting at the median. This takes
+   * a bit longer to build but gives faster ray-casts. Only supported for binary trees that
+   * contain the x, y and z axes, other trees ignore it. */
+  BVH_BALANCE_SAH = (1 << 0),
+};
 #define BVH_RAYCAST_DEFAULT (BVH_RAYCAST_WATERTIGHT)
 #define BVH_RAYCAST_DIST_MAX (FLT_MAX / 2.0f)
 
@@ -155,6 +163,7 @@ BVHTree *BLI_bvhtree_new(int maxsize, float epsilon, char tree_type, char axis);
  */
 void BLI_bvhtree_insert(BVHTree *tree, int index, const float co[3], int numpoints);
 void BLI_bvhtree_balance(BVHTree *tree);
+void BLI_bvhtree_balance_ex(BVHTree *tree, int flag);
 
 /**
  * Update: first update points/nodes, then call update_tree to refit the bounding volumes.
@@ -289,6 +298,40 @@ void BLI_bvhtree_ray_cast_all(const BVHTree *tree,
                               BVHTree_RayCastCallback callback,
                               void *userdata);
 
+/**
+ * Cast a ray for every index in the mask, which is faster than calling #BLI_bvhtree_ray_cast for
+ * each of them. The rays are processed in parallel, in an order in which rays starting close to
+ * each other are traversed one after another, so that they mostly access the same tree nodes.
+ *
+ * \param hits: Initialized like the hit passed to #BLI_bvhtree_ray_cast for every index in the
+ * mask, updated in the same way.
+ * \note The callback is called from multiple threads at the same time.
+ */
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                Span<float3> origins,
+                                Span<float3> directions,
+                                float radius,
+                                MutableSpan<BVHTreeRayHit> hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag = BVH_RAYCAST_DEFAULT);
+
+/**
+ * Find the nearest node for every index in the mask, see #BLI_bvhtree_ray_cast_batch.
+ *
+ * \param nearest: Initialized like the nearest passed to #BLI_bvhtree_find_nearest for every
+ * index in the mask, updated in the same way.
+ * \note The callback is called from multiple threads at the same time.
+ */
+void BLI_bvhtree_find_nearest_batch(const BVHTree &tree,
+                                    const IndexMask &mask,
+                                    Span<float3> positions,
+                                    MutableSpan<BVHTreeNearest> nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag = 0);
+
 float BLI_bvhtree_bb_raycast(const float bv[6],
                              const float light_start[3],
                              const float light_end[3],
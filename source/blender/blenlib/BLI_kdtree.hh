@@ -16,6 +16,7 @@
 #include "BLI_math_base_c.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_stack.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "PRF_profile.hh"
@@ -38,6 +39,11 @@ constexpr uint kd_node_unset = (uint(-1));
  */
 constexpr uint kd_node_root_is_init = (uint(-2));
 
+/** Sub-trees with more nodes than this are balanced on separate threads. */
+constexpr uint kd_balance_threading_threshold = 8192;
+/** Number of queries processed by a task in the batched queries. */
+constexpr int64_t kd_batch_grain_size = 512;
+
 template<typename CoordT>
 inline typename KDTreeCoordTraits<CoordT>::ValueType axis_get(const CoordT &co, uint axis)
 {
@@ -171,9 +177,15 @@ static uint kdtree_balance(KDTreeNode<CoordT> *nodes, uint nodes_len, uint axis,
   node = &nodes[median];
   node->d = axis;
   axis = (axis + 1) % KDTree<CoordT>::DimsNum;
-  node->left = kdtree_balance(nodes, median, axis, ofs);
-  node->right = kdtree_balance(
-      nodes + median + 1, (nodes_len - (median + 1)), axis, (median + 1) + ofs);
+  /* The sub-nodes are stored in separate parts of the array, so they can be sorted in parallel.
+   * This does not change the resulting tree. */
+  threading::parallel_invoke(
+      nodes_len > kd_balance_threading_threshold,
+      [&]() { node->left = kdtree_balance(nodes, median, axis, ofs); },
+      [&]() {
+        node->right = kdtree_balance(
+            nodes + median + 1, (nodes_len - (median + 1)), axis, (median + 1) + ofs);
+      });
 
   return median + ofs;
 }
@@ -184,10 +196,12 @@ template<typename CoordT> inline void kdtree_balance(KDTree<CoordT> *tree)
 {
   PRF_scope(ProfileCategory::Default);
   if (tree->root != detail::kd_node_root_is_init) {
-    for (uint i = 0; i < tree->nodes_len; i++) {
-      tree->nodes[i].left = detail::kd_node_unset;
-      tree->nodes[i].right = detail::kd_node_unset;
-    }
+    threading::parallel_for(IndexRange(tree->nodes_len), 4096, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        tree->nodes[i].left = detail::kd_node_unset;
+        tree->nodes[i].right = detail::kd_node_unset;
+      }
+    });
   }
 
   tree->root = detail::kdtree_balance<CoordT>(tree->nodes, tree->nodes_len, 0, 0);
@@ -636,6 +650,105 @@ inline void kdtree_range_search_cb(const KDTree<CoordT> *tree,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Batched Queries
+ *
+ * Versions of the queries above for many query points at once. The queries are processed in
+ * parallel, so these should be preferred over calling the single queries in a loop.
+ * \{ */
+
+/**
+ * Find the nearest point for every position, see #kdtree_find_nearest.
+ *
+ * \param r_indices: The index of the nearest point for every position, or -1 if the tree is
+ * empty.
+ * \param r_nearest: Optional, the nearest point for every position.
+ */
+template<typename CoordT>
+inline void kdtree_find_nearest_batch(const KDTree<CoordT> *tree,
+                                      const Span<CoordT> positions,
+                                      MutableSpan<int> r_indices,
+                                      MutableSpan<KDTreeNearest<CoordT>> r_nearest = {})
+{
+  BLI_assert(r_indices.size() == positions.size());
+  BLI_assert(r_nearest.is_empty() || r_nearest.size() == positions.size());
+  threading::parallel_for(
+      positions.index_range(), detail::kd_batch_grain_size, [&](const IndexRange range) {
+        for (const int64_t i : range) {
+          r_indices[i] = kdtree_find_nearest<CoordT>(
+              tree, positions[i], r_nearest.is_empty() ? nullptr : &r_nearest[i]);
+        }
+      });
+}
+
+/**
+ * Find the \a nearest_len_capacity nearest points for every position, see
+ * #kdtree_find_nearest_n.
+ *
+ * \param r_nearest: The nearest points of the position `i` are stored at
+ * `i * nearest_len_capacity`, sorted by distance.
+ * \param r_nearest_len: The number of nearest points found for every position.
+ */
+template<typename CoordT>
+inline void kdtree_find_nearest_n_batch(const KDTree<CoordT> *tree,
+                                        const Span<CoordT> positions,
+                                        const uint nearest_len_capacity,
+                                        MutableSpan<KDTreeNearest<CoordT>> r_nearest,
+                                        MutableSpan<int> r_nearest_len)
+{
+  BLI_assert(r_nearest.size() == positions.size() * int64_t(nearest_len_capacity));
+  BLI_assert(r_nearest_len.size() == positions.size());
+  threading::parallel_for(
+      positions.index_range(), detail::kd_batch_grain_size, [&](const IndexRange range) {
+        for (const int64_t i : range) {
+          r_nearest_len[i] = kdtree_find_nearest_n<CoordT>(
+              tree,
+              positions[i],
+              &r_nearest[i * int64_t(nearest_len_capacity)],
+              nearest_len_capacity);
+        }
+      });
+}
+
+/**
+ * Find the points in \a range of every position, see #kdtree_range_search.
+ *
+ * \param fn: Called with the index of the position and the points in range, sorted by distance.
+ * It is called from multiple threads at the same time. The points are stored in a buffer that is
+ * reused for the next query, so they have to be copied if they are needed afterwards.
+ */
+template<typename CoordT, typename Fn>
+inline void kdtree_range_search_batch(const KDTree<CoordT> *tree,
+                                      const Span<CoordT> positions,
+                                      const typename KDTree<CoordT>::ValueType range,
+                                      Fn &&fn)
+{
+  threading::parallel_for(
+      positions.index_range(), detail::kd_batch_grain_size, [&](const IndexRange range_i) {
+        /* Reuse the result buffer for all queries of this task to avoid allocations. */
+        Vector<KDTreeNearest<CoordT>, 32> nearest;
+        for (const int64_t i : range_i) {
+          nearest.clear();
+          kdtree_range_search_cb<CoordT>(
+              tree,
+              positions[i],
+              range,
+              [&](const int index, const CoordT &co, const auto dist_sq) {
+                nearest.append({index, std::sqrt(dist_sq), co});
+                return true;
+              });
+          std::sort(nearest.begin(),
+                    nearest.end(),
+                    [](const KDTreeNearest<CoordT> &a, const KDTreeNearest<CoordT> &b) {
+                      return a.dist < b.dist;
+                    });
+          fn(i, nearest.as_span());
+        }
+      });
+}
+
+/** \} */
+
 namespace detail {
 
 /**
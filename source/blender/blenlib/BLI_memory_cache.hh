@@ -44,6 +44,20 @@ std::shared_ptr<const T> get(const GenericKey &key, FunctionRef<std::unique_ptr<
 std::shared_ptr<CachedValue> get_base(const GenericKey &key,
                                       FunctionRef<std::unique_ptr<CachedValue>()> compute_fn);
 
+/**
+ * Get the value that corresponds to the given key if it is cached already. This is useful when the
+ * value can't be computed in a single function call, e.g. because it is computed lazily. The value
+ * can be added with #add once it has been computed.
+ */
+template<typename T> std::shared_ptr<const T> lookup(const GenericKey &key);
+std::shared_ptr<CachedValue> lookup_base(const GenericKey &key);
+
+/**
+ * Add a value to the cache. If another thread added a value for the same key already, that value
+ * is kept and returned instead.
+ */
+std::shared_ptr<CachedValue> add(const GenericKey &key, std::shared_ptr<CachedValue> value);
+
 /**
  * Set how much memory the cache is allowed to use. This is only an approximation because counting
  * the memory is not 100% accurate, and for some types the memory usage may even change over time.
@@ -75,6 +89,11 @@ inline std::shared_ptr<const T> get(const GenericKey &key,
   return std::dynamic_pointer_cast<const T>(get_base(key, compute_fn));
 }
 
+template<typename T> inline std::shared_ptr<const T> lookup(const GenericKey &key)
+{
+  return std::dynamic_pointer_cast<const T>(lookup_base(key));
+}
+
 /** \} */
 
 }  // namespace blender::memory_cache
@@ -19,8 +19,10 @@ struct BLI_mmap_file;
 
 /* Prepares an opened file for memory-mapped IO.
  * May return NULL if the operation fails.
- * Note that this seeks to the end of the file to determine its length. */
-BLI_mmap_file *BLI_mmap_open(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+ * Note that this seeks to the end of the file to determine its length.
+ * The mapping is read-only, unless `writable` is true. Writable mappings are private, changes
+ * are not written back to the file. They are not supported on Windows. */
+BLI_mmap_file *BLI_mmap_open(int fd, bool writable = false) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
 
 /* Reads length bytes from file at the given offset into dest.
  * Returns whether the operation was successful (may fail when reading beyond the file
@@ -28,10 +30,18 @@ BLI_mmap_file *BLI_mmap_open(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
     ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
 
+/* Returns the start of the mapped file. The memory may only be written to when the file was
+ * opened as writable. */
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 size_t BLI_mmap_get_length(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 bool BLI_mmap_any_io_error(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
+/* Tag the mapped memory as referenced directly by other data, instead of only being read with
+ * #BLI_mmap_read. IO errors are normally handled by replacing the mapping with zeros and setting
+ * the error flag, which the reading code checks. Referenced data is not checked like that, so an
+ * IO error is reported as a fatal error instead of silently replacing the data. */
+void BLI_mmap_tag_referenced(BLI_mmap_file *file) ATTR_NONNULL(1);
+
 void BLI_mmap_free(BLI_mmap_file *file) ATTR_NONNULL(1);
 
 }  // namespace blender
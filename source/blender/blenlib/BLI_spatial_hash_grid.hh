@@ -0,0 +1,205 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <algorithm>
+
+#include "BLI_array.hh"
+#include "BLI_bounds_types.hh"
+#include "BLI_index_mask_fwd.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_offset_indices.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+namespace blender {
+
+/**
+ * Spatial index to find all points within a fixed distance of a position. It is an alternative
+ * to #KDTree when the query radius is known when building the index: the points are sorted into
+ * a uniform grid of cubic cells, so a query only has to look at the few cells around the
+ * position instead of traversing a tree.
+ *
+ * The cells are mapped to a number of buckets proportional to the number of points with a hash,
+ * so the memory usage does not depend on the extent of the points. The points of every bucket
+ * are stored contiguously in memory, grouped with #OffsetIndices. Building the grid is a
+ * parallel counting sort of the points by their bucket.
+ */
+class SpatialHashGrid {
+ private:
+  /** Cell coordinates are clamped to this range to avoid integer overflow. */
+  static constexpr float max_cell_coordinate = 1e9f;
+
+  float cell_size_ = 0.0f;
+  float inv_cell_size_ = 0.0f;
+  /** The number of buckets is a power of two, so the hash can be masked. */
+  uint32_t bucket_mask_ = 0;
+  /** The range of every bucket in #sorted_indices_ and #sorted_positions_. */
+  Array<int> bucket_offsets_;
+  /** Indices of the points, sorted by bucket. */
+  Array<int> sorted_indices_;
+  /** The positions of the points in the same order as #sorted_indices_. */
+  Array<float3> sorted_positions_;
+
+ public:
+  SpatialHashGrid() = default;
+
+  /**
+   * \param cell_size: Queries are fastest when their radius is about the same as the size of the
+   * cells. Must be larger than zero.
+   */
+  SpatialHashGrid(Span<float3> positions, const IndexMask &mask, float cell_size);
+
+  float cell_size() const
+  {
+    return cell_size_;
+  }
+
+  /**
+   * Check that points within \a bounds map to distinct cells. Otherwise, the coordinates of
+   * distant points are clamped to the same cells, which makes queries as slow as comparing all
+   * points.
+   */
+  static bool supports_bounds(const Bounds<float3> &bounds, float cell_size);
+
+  /**
+   * Call \a fn with the index and squared distance of every point within \a radius of
+   * \a position. The order of the points is not defined.
+   */
+  template<typename Fn>
+  void foreach_in_radius(const float3 &position, float radius, Fn &&fn) const;
+
+  /**
+   * Find the points within \a radius of many positions in parallel. \a fn is called from multiple
+   * threads with the index of the position and the indices of the points in range, sorted by
+   * index. The indices are stored in a buffer that is reused for the next query.
+   */
+  template<typename Fn>
+  void foreach_in_radius_batch(Span<float3> positions, float radius, Fn &&fn) const;
+
+  /**
+   * Find duplicate points in \a range, with the same result as #kdtree_calc_duplicates_fast
+   * with `use_index_order` enabled: the points are visited in the order of \a mask, and the
+   * points in range of a point that are not merged yet are merged into it. The neighbors of
+   * many points are found in parallel before the merges are applied in order. The memory used
+   * for that is bounded, the neighbors of the remaining points are found serially.
+   *
+   * \param range: Must be larger than zero.
+   * \param duplicates: Values initialized to -1 are candidates to be merged, see
+   * #kdtree_calc_duplicates_fast.
+   * \returns The number of merges found.
+   */
+  static int calc_duplicates(Span<float3> positions,
+                             const IndexMask &mask,
+                             float range,
+                             MutableSpan<int> duplicates);
+
+ private:
+  int3 cell_of(const float3 &position) const
+  {
+    /* Clamp to avoid overflow for points that are very far away compared to the cell size, see
+     * #supports_bounds. */
+    const float3 cell = math::floor(position * inv_cell_size_);
+    return int3(math::clamp(cell, float3(-max_cell_coordinate), float3(max_cell_coordinate)));
+  }
+
+  int bucket_of(const int3 &cell) const
+  {
+    /* Spatial hash from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+     * by Teschner et al. */
+    const uint32_t hash = (uint32_t(cell.x) * 73856093u) ^ (uint32_t(cell.y) * 19349663u) ^
+                          (uint32_t(cell.z) * 83492791u);
+    return int(hash & bucket_mask_);
+  }
+};
+
+/**
+ * Find duplicate points like #kdtree_calc_duplicates_fast, for the points in \a mask. Large
+ * inputs use #SpatialHashGrid::calc_duplicates, which finds the neighbors in parallel and
+ * always merges in index order. Small inputs, and inputs that don't fit into the grid, use a
+ * KD-tree.
+ *
+ * \param use_index_order: Merge in index order, like the KD-tree option. Otherwise the order
+ * is not defined and may depend on the number of points.
+ */
+int calc_duplicate_points(Span<float3> positions,
+                          const IndexMask &mask,
+                          float range,
+                          bool use_index_order,
+                          MutableSpan<int> duplicates);
+
+template<typename Fn>
+inline void SpatialHashGrid::foreach_in_radius(const float3 &position,
+                                               const float radius,
+                                               Fn &&fn) const
+{
+  if (sorted_indices_.is_empty()) {
+    return;
+  }
+  const OffsetIndices<int> buckets = bucket_offsets_.as_span();
+  const float radius_sq = radius * radius;
+  const auto foreach_in_bucket = [&](const int bucket) {
+    for (const int i : buckets[bucket]) {
+      const float dist_sq = math::distance_squared(sorted_positions_[i], position);
+      if (dist_sq <= radius_sq) {
+        fn(sorted_indices_[i], dist_sq);
+      }
+    }
+  };
+
+  const int3 min_cell = this->cell_of(position - radius);
+  const int3 max_cell = this->cell_of(position + radius);
+  const int64_t cells_num = int64_t(max_cell.x - min_cell.x + 1) *
+                            int64_t(max_cell.y - min_cell.y + 1) *
+                            int64_t(max_cell.z - min_cell.z + 1);
+  if (cells_num > buckets.size()) {
+    /* The radius is much larger than the cells, checking all points is faster. */
+    for (const int bucket : buckets.index_range()) {
+      foreach_in_bucket(bucket);
+    }
+    return;
+  }
+
+  /* Different cells can be mapped to the same bucket, every bucket must only be visited once. */
+  Vector<int, 27> cell_buckets;
+  for (int z = min_cell.z; z <= max_cell.z; z++) {
+    for (int y = min_cell.y; y <= max_cell.y; y++) {
+      for (int x = min_cell.x; x <= max_cell.x; x++) {
+        cell_buckets.append(this->bucket_of(int3(x, y, z)));
+      }
+    }
+  }
+  std::sort(cell_buckets.begin(), cell_buckets.end());
+  const int *buckets_end = std::unique(cell_buckets.begin(), cell_buckets.end());
+  for (const int *bucket = cell_buckets.begin(); bucket != buckets_end; bucket++) {
+    foreach_in_bucket(*bucket);
+  }
+}
+
+template<typename Fn>
+inline void SpatialHashGrid::foreach_in_radius_batch(const Span<float3> positions,
+                                                     const float radius,
+                                                     Fn &&fn) const
+{
+  threading::parallel_for(positions.index_range(), 512, [&](const IndexRange range) {
+    /* Reuse the buffer for all queries of this task to avoid allocations. */
+    Vector<int, 64> indices;
+    for (const int64_t i : range) {
+      indices.clear();
+      this->foreach_in_radius(
+          positions[i], radius, [&](const int index, const float /*dist_sq*/) {
+            indices.append(index);
+          });
+      std::sort(indices.begin(), indices.end());
+      fn(i, indices.as_span());
+    }
+  });
+}
+
+}  // namespace blender
@@ -28,11 +28,17 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_alloca.hh"
+#include "BLI_array.hh"
+#include "BLI_bounds.hh"
 #include "BLI_heap_simple.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_kdopbvh.hh"
 #include "BLI_math_geom_c.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_sort.hh"
 #include "BLI_stack_c.hh"
+#include "BLI_task.hh"
 #include "BLI_task_c.hh"
 #include "BLI_utildefines.hh"
 
@@ -851,6 +857,253 @@ static void non_recursive_bvh_div_nodes(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name SAH Tree Construction
+ *
+ * Binary tree built top-down with the binned surface area heuristic. Instead of splitting every
+ * branch at the median, the leafs are sorted into bins by their centroid and the split between
+ * two bins that minimizes the summed surface area of the children, weighted by their number of
+ * leafs, is chosen. This adapts the tree to the distribution of the primitives, which reduces the
+ * number of nodes visited by ray-casts on meshes with non-uniform density.
+ *
+ * Branches are stored in depth-first order: a sub-tree with N leafs always uses N - 1 branches,
+ * so the position of every sub-tree in the branches array is known before it is built. This
+ * allows building sub-trees on separate threads, keeps siblings close in memory and ensures that
+ * children always have a larger index than their parent, as #BLI_bvhtree_update_tree expects.
+ * \{ */
+
+#define BVH_SAH_BINS 16
+/** Build sub-trees with fewer leafs than this on a single thread. */
+#define BVH_SAH_THREAD_LEAF_THRESHOLD 4096
+/**
+ * Use median splits for branches deeper than this, the traversal functions are recursive and
+ * degenerate distributions could otherwise create very deep trees.
+ */
+#define BVH_SAH_MAX_DEPTH 48
+
+struct BVHSAHBins {
+  float3 min[BVH_SAH_BINS];
+  float3 max[BVH_SAH_BINS];
+  int count[BVH_SAH_BINS];
+};
+
+struct BVHSAHBuildData {
+  const BVHTree *tree;
+  BVHNode **leafs_array;
+  BVHNode *branches_array;
+};
+
+/** Only the x, y and z axes are used, see #BLI_bvhtree_balance_ex. */
+static float3 sah_leaf_centroid(const BVHNode *node)
+{
+  const float *bv = node->bv;
+  return float3(bv[0] + bv[1], bv[2] + bv[3], bv[4] + bv[5]) * 0.5f;
+}
+
+static float sah_half_area(const float3 &min, const float3 &max)
+{
+  const float3 size = max - min;
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+static int sah_bin_index(const float centroid, const float min, const float scale)
+{
+  return std::clamp(int((centroid - min) * scale), 0, BVH_SAH_BINS - 1);
+}
+
+/**
+ * Reorder the leafs in the given range so that the two children of the branch are
+ * `[begin, mid)` and `[mid, end)`.
+ *
+ * \return The position of the split.
+ */
+static int sah_split_leafs(
+    BVHNode **leafs, const int begin, const int end, const int depth, char *r_axis)
+{
+  float3 centroid_min(FLT_MAX);
+  float3 centroid_max(-FLT_MAX);
+  for (int i = begin; i < end; i++) {
+    const float3 centroid = sah_leaf_centroid(leafs[i]);
+    centroid_min = math::min(centroid_min, centroid);
+    centroid_max = math::max(centroid_max, centroid);
+  }
+
+  const float3 extent = centroid_max - centroid_min;
+  const int axis = math::dominant_axis(extent);
+  *r_axis = char(axis);
+
+  const int mid_median = (begin + end) / 2;
+  if (extent[axis] == 0.0f) {
+    /* All centroids are the same, any split is as good as the others. */
+    return mid_median;
+  }
+
+  const auto split_median = [&]() {
+    std::nth_element(leafs + begin,
+                     leafs + mid_median,
+                     leafs + end,
+                     [&](const BVHNode *a, const BVHNode *b) {
+                       return sah_leaf_centroid(a)[axis] < sah_leaf_centroid(b)[axis];
+                     });
+    return mid_median;
+  };
+
+  if (depth >= BVH_SAH_MAX_DEPTH || end - begin <= 2) {
+    return split_median();
+  }
+
+  const float min = centroid_min[axis];
+  /* Slightly shrink the scale so the largest centroid falls into the last bin. */
+  const float scale = float(BVH_SAH_BINS) * (1.0f - 1e-5f) / extent[axis];
+
+  const auto bin_leafs = [&](const IndexRange range, BVHSAHBins bins) {
+    for (const int64_t i : range) {
+      const BVHNode *node = leafs[i];
+      const int bin = sah_bin_index(sah_leaf_centroid(node)[axis], min, scale);
+      const float *bv = node->bv;
+      bins.min[bin] = math::min(bins.min[bin], float3(bv[0], bv[2], bv[4]));
+      bins.max[bin] = math::max(bins.max[bin], float3(bv[1], bv[3], bv[5]));
+      bins.count[bin]++;
+    }
+    return bins;
+  };
+
+  BVHSAHBins empty_bins;
+  std::fill_n(empty_bins.min, BVH_SAH_BINS, float3(FLT_MAX));
+  std::fill_n(empty_bins.max, BVH_SAH_BINS, float3(-FLT_MAX));
+  std::fill_n(empty_bins.count, BVH_SAH_BINS, 0);
+
+  const BVHSAHBins bins = threading::parallel_reduce(
+      IndexRange::from_begin_end(begin, end),
+      BVH_SAH_THREAD_LEAF_THRESHOLD,
+      empty_bins,
+      bin_leafs,
+      [](const BVHSAHBins &a, const BVHSAHBins &b) {
+        BVHSAHBins result;
+        for (int bin = 0; bin < BVH_SAH_BINS; bin++) {
+          result.min[bin] = math::min(a.min[bin], b.min[bin]);
+          result.max[bin] = math::max(a.max[bin], b.max[bin]);
+          result.count[bin] = a.count[bin] + b.count[bin];
+        }
+        return result;
+      });
+
+  /* Sweep from the right to get the cost of the right side of every split. */
+  float right_cost[BVH_SAH_BINS];
+  {
+    float3 right_min(FLT_MAX);
+    float3 right_max(-FLT_MAX);
+    int right_count = 0;
+    for (int bin = BVH_SAH_BINS - 1; bin > 0; bin--) {
+      right_min = math::min(right_min, bins.min[bin]);
+      right_max = math::max(right_max, bins.max[bin]);
+      right_count += bins.count[bin];
+      right_cost[bin] = right_count ? sah_half_area(right_min, right_max) * float(right_count) :
+                                      FLT_MAX;
+    }
+  }
+
+  /* The split is between `best_bin - 1` and `best_bin`. */
+  int best_bin = -1;
+  float best_cost = FLT_MAX;
+  {
+    float3 left_min(FLT_MAX);
+    float3 left_max(-FLT_MAX);
+    int left_count = 0;
+    for (int bin = 1; bin < BVH_SAH_BINS; bin++) {
+      left_min = math::min(left_min, bins.min[bin - 1]);
+      left_max = math::max(left_max, bins.max[bin - 1]);
+      left_count += bins.count[bin - 1];
+      if (left_count == 0 || right_cost[bin] == FLT_MAX) {
+        continue;
+      }
+      const float cost = sah_half_area(left_min, left_max) * float(left_count) + right_cost[bin];
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_bin = bin;
+      }
+    }
+  }
+
+  if (best_bin == -1) {
+    return split_median();
+  }
+
+  BVHNode **mid = std::partition(leafs + begin, leafs + end, [&](const BVHNode *node) {
+    return sah_bin_index(sah_leaf_centroid(node)[axis], min, scale) < best_bin;
+  });
+  return int(mid - leafs);
+}
+
+static void sah_build_branch(const BVHSAHBuildData &data,
+                             BVHNode *branch,
+                             const int begin,
+                             const int end,
+                             const int depth)
+{
+  const BVHTree *tree = data.tree;
+
+  refit_kdop_hull(tree, branch, begin, end);
+
+  char split_axis;
+  const int mid = sah_split_leafs(data.leafs_array, begin, end, depth, &split_axis);
+  BLI_assert(mid > begin && mid < end);
+
+  /* Save split axis (this can be used on ray-tracing to speedup the query time) */
+  branch->main_axis = split_axis;
+  branch->node_num = 2;
+
+  const IndexRange child_ranges[2] = {IndexRange::from_begin_end(begin, mid),
+                                      IndexRange::from_begin_end(mid, end)};
+  int child_branch_index = int(branch - data.branches_array) + 1;
+  for (int k = 0; k < 2; k++) {
+    if (child_ranges[k].size() == 1) {
+      branch->children[k] = data.leafs_array[child_ranges[k].first()];
+    }
+    else {
+      branch->children[k] = &data.branches_array[child_branch_index];
+      child_branch_index += int(child_ranges[k].size()) - 1;
+    }
+    branch->children[k]->parent = branch;
+  }
+
+  const auto build_child = [&](const int k) {
+    if (child_ranges[k].size() > 1) {
+      sah_build_branch(data,
+                       branch->children[k],
+                       int(child_ranges[k].first()),
+                       int(child_ranges[k].one_after_last()),
+                       depth + 1);
+    }
+  };
+  threading::parallel_invoke(
+      end - begin > BVH_SAH_THREAD_LEAF_THRESHOLD,
+      [&]() { build_child(0); },
+      [&]() { build_child(1); });
+}
+
+/**
+ * Build a binary tree with at least two leafs on `branches_array`, the root is the first branch.
+ */
+static void sah_bvh_div_nodes(const BVHTree *tree,
+                              BVHNode *branches_array,
+                              BVHNode **leafs_array,
+                              int leafs_num)
+{
+  BLI_assert(tree->tree_type == 2 && leafs_num > 1);
+
+  BVHSAHBuildData data;
+  data.tree = tree;
+  data.leafs_array = leafs_array;
+  data.branches_array = branches_array;
+
+  BVHNode *root = &branches_array[0];
+  root->parent = nullptr;
+  sah_build_branch(data, root, 0, leafs_num, 0);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree API
  * \{ */
@@ -939,6 +1192,11 @@ void BLI_bvhtree_free(BVHTree *tree)
 }
 
 void BLI_bvhtree_balance(BVHTree *tree)
+{
+  BLI_bvhtree_balance_ex(tree, 0);
+}
+
+void BLI_bvhtree_balance_ex(BVHTree *tree, const int flag)
 {
   BVHNode **leafs_array = tree->nodes;
 
@@ -946,9 +1204,19 @@ void BLI_bvhtree_balance(BVHTree *tree)
    * (some big bug goes here if its being called more than once per tree) */
   BLI_assert(tree->branch_num == 0);
 
-  /* Build the implicit tree */
-  non_recursive_bvh_div_nodes(
-      tree, tree->nodearray + (tree->leaf_num - 1), leafs_array, tree->leaf_num);
+  /* The SAH build uses the x, y and z axes, which are the first axes of the K-DOP. */
+  const bool use_sah = (flag & BVH_BALANCE_SAH) && tree->tree_type == 2 &&
+                       tree->start_axis == 0 && tree->leaf_num > 1;
+
+  if (use_sah) {
+    /* Both builds store the root as the first branch after the leafs. */
+    sah_bvh_div_nodes(tree, tree->nodearray + tree->leaf_num, leafs_array, tree->leaf_num);
+  }
+  else {
+    /* Build the implicit tree */
+    non_recursive_bvh_div_nodes(
+        tree, tree->nodearray + (tree->leaf_num - 1), leafs_array, tree->leaf_num);
+  }
 
   /* current code expects the branches to be linked to the nodes array
    * we perform that linkage here */
@@ -2102,6 +2370,150 @@ void BLI_bvhtree_ray_cast_all(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree batched queries
+ *
+ * Every query is still a separate traversal of the tree. The queries are sorted along a Morton
+ * curve over their positions though, so that the queries that are processed one after another
+ * by the same thread mostly traverse the same nodes, which are then still in the CPU caches.
+ *
+ * \{ */
+
+/** Queries are processed by a thread in groups of this size. */
+#define BVH_BATCH_GRAIN_SIZE 256
+
+struct BVHBatchQuery {
+  uint64_t key;
+  int index;
+};
+
+/** Spread the lower 21 bits of the value so that there are two zero bits between each bit. */
+static uint64_t morton_spread_bits(uint64_t value)
+{
+  value &= 0x1fffff;
+  value = (value | value << 32) & 0x1f00000000ffff;
+  value = (value | value << 16) & 0x1f0000ff0000ff;
+  value = (value | value << 8) & 0x100f00f00f00f00f;
+  value = (value | value << 4) & 0x10c30c30c30c30c3;
+  value = (value | value << 2) & 0x1249249249249249;
+  return value;
+}
+
+static uint64_t morton_quantize(const float value)
+{
+  /* Also handles NaN. */
+  if (!(value > 0.0f)) {
+    return 0;
+  }
+  return uint64_t(std::min(value, float(0x1fffff)));
+}
+
+static Array<int> bvhtree_batch_query_order(const IndexMask &mask, const Span<float3> positions)
+{
+  Array<int> order(mask.size());
+  mask.to_indices<int>(order);
+  if (mask.size() <= BVH_BATCH_GRAIN_SIZE) {
+    return order;
+  }
+  const std::optional<Bounds<float3>> bounds = bounds::min_max(mask, positions);
+  const float3 size = bounds->max - bounds->min;
+  const float max_size = std::max({size.x, size.y, size.z});
+  if (!(max_size > 0.0f)) {
+    return order;
+  }
+  const float scale = float(0x1fffff) / max_size;
+
+  Array<BVHBatchQuery> queries(mask.size());
+  threading::parallel_for(order.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const float3 co = (positions[order[i]] - bounds->min) * scale;
+      queries[i].key = morton_spread_bits(morton_quantize(co.x)) |
+                       morton_spread_bits(morton_quantize(co.y)) << 1 |
+                       morton_spread_bits(morton_quantize(co.z)) << 2;
+      queries[i].index = order[i];
+    }
+  });
+  parallel_sort(queries.begin(),
+                queries.end(),
+                [](const BVHBatchQuery &a, const BVHBatchQuery &b) { return a.key < b.key; });
+  threading::parallel_for(order.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      order[i] = queries[i].index;
+    }
+  });
+  return order;
+}
+
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                const Span<float3> origins,
+                                const Span<float3> directions,
+                                const float radius,
+                                MutableSpan<BVHTreeRayHit> hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                const int flag)
+{
+  BVHNode *root = tree.nodes[tree.leaf_num];
+  if (root == nullptr) {
+    return;
+  }
+  const Array<int> order = bvhtree_batch_query_order(mask, origins);
+  threading::parallel_for(order.index_range(), BVH_BATCH_GRAIN_SIZE, [&](const IndexRange range) {
+    BVHRayCastData data;
+    data.tree = &tree;
+    data.callback = callback;
+    data.userdata = userdata;
+    data.ray.radius = radius;
+    for (const int i : order.as_span().slice(range)) {
+      BLI_ASSERT_UNIT_V3(directions[i]);
+      copy_v3_v3(data.ray.origin, origins[i]);
+      copy_v3_v3(data.ray.direction, directions[i]);
+      bvhtree_ray_cast_data_precalc(&data, flag);
+      data.hit = hits[i];
+      dfs_raycast(&data, root);
+      hits[i] = data.hit;
+    }
+  });
+}
+
+void BLI_bvhtree_find_nearest_batch(const BVHTree &tree,
+                                    const IndexMask &mask,
+                                    const Span<float3> positions,
+                                    MutableSpan<BVHTreeNearest> nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    const int flag)
+{
+  BVHNode *root = tree.nodes[tree.leaf_num];
+  if (root == nullptr) {
+    return;
+  }
+  const Array<int> order = bvhtree_batch_query_order(mask, positions);
+  threading::parallel_for(order.index_range(), BVH_BATCH_GRAIN_SIZE, [&](const IndexRange range) {
+    BVHNearestData data;
+    data.tree = &tree;
+    data.callback = callback;
+    data.userdata = userdata;
+    for (const int i : order.as_span().slice(range)) {
+      data.co = positions[i];
+      for (axis_t axis_iter = tree.start_axis; axis_iter != tree.stop_axis; axis_iter++) {
+        data.proj[axis_iter] = dot_v3v3(data.co, bvhtree_kdop_axes[axis_iter]);
+      }
+      data.nearest = nearest[i];
+      if (flag & BVH_NEAREST_OPTIMAL_ORDER) {
+        heap_find_nearest_begin(&data, root);
+      }
+      else {
+        dfs_find_nearest_begin(&data, root);
+      }
+      nearest[i] = data.nearest;
+    }
+  });
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_range_query
  *
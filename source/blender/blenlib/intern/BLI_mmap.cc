@@ -43,6 +43,13 @@ struct BLI_mmap_file {
    * within the signal handler, which is not part of the normal execution flow. */
   volatile bool io_error;
 
+  /* Whether the mapped memory can be written to. */
+  bool writable;
+
+  /* Whether the mapped memory is referenced directly, see #BLI_mmap_tag_referenced.
+   * Protected by `mmap_mutex`. */
+  bool referenced;
+
   /* Used to break out of infinite loops when an error keeps occurring.
    * See the comments in #try_handle_error_for_address for details. */
   size_t id;
@@ -101,6 +108,13 @@ static bool try_handle_error_for_address(const void *address)
     return false;
   }
 
+  if (file->referenced) {
+    /* Replacing the memory with zeros would silently change data that uses it. */
+    file->io_error = true;
+    print_error("Error: IO error in mapped file with directly referenced data.");
+    return false;
+  }
+
   /* Check if we already handled this error. */
   if (file->io_error) {
     /* If `file->io_error` is true, either a different thread has
@@ -284,9 +298,10 @@ static void print_error(const char *message)
 
 static bool try_map_zeros(BLI_mmap_file *file)
 {
-  /* Replace the mapped memory with zeroes. */
+  /* Replace the mapped memory with zeroes. The protection flags must match #BLI_mmap_open. */
+  const int prot = file->writable ? PROT_READ | PROT_WRITE : PROT_READ;
   const void *mapped_memory = mmap(
-      file->memory, file->length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+      file->memory, file->length, prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
   if (mapped_memory == MAP_FAILED) {
     return false;
   }
@@ -366,7 +381,7 @@ static void error_handler_remove(BLI_mmap_file *file)
   open_mmaps_vector().remove_first_occurrence_and_reorder(file);
 }
 
-BLI_mmap_file *BLI_mmap_open(int fd)
+BLI_mmap_file *BLI_mmap_open(int fd, const bool writable)
 {
   static std::atomic_size_t id_counter = 0;
 
@@ -387,12 +402,19 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   }
 
 #ifndef WIN32
-  /* Map the given file to memory. */
-  memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  /* Map the given file to memory. The mapping is private and copy-on-write: when it is writable,
+   * writes are never carried through to the file. */
+  const int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+  memory = mmap(nullptr, length, prot, MAP_PRIVATE, fd, 0);
   if (memory == MAP_FAILED) {
     return nullptr;
   }
 #else  /* WIN32 */
+  /* Writable mappings are not supported. */
+  if (writable) {
+    return nullptr;
+  }
+
   /* Convert the POSIX-style file descriptor to a Windows handle. */
   void *file_handle = (void *)_get_osfhandle(fd);
 
@@ -455,6 +477,7 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   file->memory = static_cast<char *>(memory);
   file->handle = handle;
   file->length = length;
+  file->writable = writable;
   file->id = id_counter++;
 
   /* Register the file with the error handler. */
@@ -491,6 +514,12 @@ bool BLI_mmap_any_io_error(const BLI_mmap_file *file)
   return file->io_error;
 }
 
+void BLI_mmap_tag_referenced(BLI_mmap_file *file)
+{
+  std::unique_lock lock(mmap_mutex);
+  file->referenced = true;
+}
+
 void BLI_mmap_free(BLI_mmap_file *file)
 {
   error_handler_remove(file);
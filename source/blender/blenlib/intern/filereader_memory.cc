@@ -11,18 +11,60 @@
 
 #include "BLI_fileops.hh"
 #include "BLI_filereader.hh"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_mmap.hh"
 
 #include "MEM_guardedalloc.h"
 
 namespace blender {
 
+/**
+ * Owns a file mapping, which is freed once neither the reader nor any data referencing the mapped
+ * memory (see #FileReader::map) uses it anymore.
+ */
+class MappedFileSharingInfo : public ImplicitSharingInfo {
+ public:
+  BLI_mmap_file *mmap;
+
+  MappedFileSharingInfo(BLI_mmap_file *mmap) : mmap(mmap) {}
+
+ private:
+  void delete_self_with_data() override
+  {
+    BLI_mmap_free(mmap);
+    MEM_delete(this);
+  }
+};
+
+/**
+ * Shares a single range of a file mapping, so that the memory of every referenced range has its
+ * own users (which e.g. determine whether the data is mutable).
+ */
+class MappedRangeSharingInfo : public ImplicitSharingInfo {
+ public:
+  const MappedFileSharingInfo *file_sharing_info;
+
+  MappedRangeSharingInfo(const MappedFileSharingInfo *file_sharing_info)
+      : file_sharing_info(file_sharing_info)
+  {
+    file_sharing_info->add_user();
+  }
+
+ private:
+  void delete_self_with_data() override
+  {
+    file_sharing_info->remove_user_and_delete_if_last();
+    MEM_delete(this);
+  }
+};
+
 /* This file implements both memory-backed and memory-mapped-file-backed reading. */
 struct MemoryReader {
   FileReader reader;
 
   const char *data;
   BLI_mmap_file *mmap;
+  const MappedFileSharingInfo *mmap_sharing_info;
   size_t length;
 };
 
@@ -106,16 +148,45 @@ static int64_t memory_read_mmap(FileReader *reader, void *buffer, size_t size)
   return readsize;
 }
 
+#ifndef WIN32
+static const void *memory_map_mmap(FileReader *reader,
+                                   off64_t offset,
+                                   size_t size,
+                                   const ImplicitSharingInfo **r_sharing_info)
+{
+  MemoryReader *mem = reinterpret_cast<MemoryReader *>(reader);
+
+  if (offset < 0 || size > mem->length || size_t(offset) > mem->length - size) {
+    return nullptr;
+  }
+  /* From now on, IO errors can't be handled by replacing the mapping with zeros anymore. Don't
+   * hand out memory of a mapping that already failed, it may have been replaced by zeros. */
+  BLI_mmap_tag_referenced(mem->mmap);
+  if (BLI_mmap_any_io_error(mem->mmap)) {
+    return nullptr;
+  }
+
+  *r_sharing_info = MEM_new<MappedRangeSharingInfo>(__func__, mem->mmap_sharing_info);
+  return static_cast<const char *>(BLI_mmap_get_pointer(mem->mmap)) + offset;
+}
+#endif
+
 static void memory_close_mmap(FileReader *reader)
 {
   MemoryReader *mem = reinterpret_cast<MemoryReader *>(reader);
-  BLI_mmap_free(mem->mmap);
+  /* The mapping itself is only freed once all data referencing it is freed too. */
+  mem->mmap_sharing_info->remove_user_and_delete_if_last();
   MEM_delete(mem);
 }
 
 FileReader *BLI_filereader_new_mmap(int filedes)
 {
+#ifndef WIN32
+  /* Referenced memory is used as mutable data when it has a single user, see #memory_map_mmap. */
+  BLI_mmap_file *mmap = BLI_mmap_open(filedes, true);
+#else
   BLI_mmap_file *mmap = BLI_mmap_open(filedes);
+#endif
   if (mmap == nullptr) {
     return nullptr;
   }
@@ -123,11 +194,17 @@ FileReader *BLI_filereader_new_mmap(int filedes)
   MemoryReader *mem = MEM_new_zeroed<MemoryReader>(__func__);
 
   mem->mmap = mmap;
+  mem->mmap_sharing_info = MEM_new<MappedFileSharingInfo>(__func__, mmap);
   mem->length = BLI_mmap_get_length(mmap);
 
   mem->reader.read = memory_read_mmap;
   mem->reader.seek = memory_seek;
   mem->reader.close = memory_close_mmap;
+#ifndef WIN32
+  /* Not supported on Windows, where a file cannot be replaced (e.g. when saving over it) while it
+   * is still mapped. */
+  mem->reader.map = memory_map_mmap;
+#endif
 
   return reinterpret_cast<FileReader *>(mem);
 }
@@ -7,16 +7,47 @@
  */
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
 #include <zstd.h>
 
 #include "BLI_fileops.hh"
 #include "BLI_filereader.hh"
+#include "BLI_task_c.hh"
+#include "BLI_threads.hh"
+#include "BLI_vector.hh"
 
 #include "MEM_guardedalloc.h"
 
 namespace blender {
 
+/**
+ * Frames of a seekable file that are decompressed ahead of the reading position on worker
+ * threads. Reading a .blend file is mostly sequential, so this keeps decompression off the
+ * critical path of the #BHead parsing.
+ */
+struct ZstdFramePrefetch {
+  struct Slot {
+    /** Frame decompressed into this slot, -1 if the slot is unused. */
+    int frame = -1;
+    /** Decompressed frame content, null if decompression failed. */
+    char *content = nullptr;
+    bool is_done = false;
+  };
+
+  TaskPool *pool = nullptr;
+
+  /** Protects #slots. */
+  std::mutex mutex;
+  std::condition_variable condition;
+  /** Serializes access to the base reader, which is shared with the worker threads. */
+  std::mutex base_mutex;
+
+  /** Fixed size window of frames being (or already) decompressed. */
+  Vector<Slot> slots;
+};
+
 struct ZstdReader {
   FileReader reader;
 
@@ -33,6 +64,9 @@ struct ZstdReader {
 
     char *cached_content;
     int cached_frame;
+
+    /** May be null, e.g. when only a single thread is available. */
+    ZstdFramePrefetch *prefetch;
   } seek;
 };
 
@@ -155,41 +189,164 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+/**
+ * Read and decompress a whole frame, the returned buffer is owned by the caller.
+ * \param ctx: Decompression context, only used by a single thread at a time.
+ */
+static char *zstd_decompress_frame(ZstdReader *zstd, ZSTD_DCtx *ctx, int frame)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
-  }
-
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_DELETE(zstd->seek.cached_content);
-
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
   size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
                              zstd->seek.uncompressed_ofs[frame];
 
   char *uncompressed_data = MEM_new_array_uninitialized<char>(uncompressed_size, __func__);
   char *compressed_data = MEM_new_array_uninitialized<char>(compressed_size, __func__);
-  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
-      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
   {
-    MEM_delete(compressed_data);
-    MEM_delete(uncompressed_data);
-    return nullptr;
+    std::unique_lock<std::mutex> lock;
+    if (zstd->seek.prefetch) {
+      lock = std::unique_lock(zstd->seek.prefetch->base_mutex);
+    }
+    if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
+        zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
+    {
+      MEM_delete(compressed_data);
+      MEM_delete(uncompressed_data);
+      return nullptr;
+    }
   }
 
   size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+      ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
   MEM_delete(compressed_data);
   if (ZSTD_isError(res) || res < uncompressed_size) {
     MEM_delete(uncompressed_data);
     return nullptr;
   }
+  return uncompressed_data;
+}
+
+struct ZstdPrefetchTask {
+  ZstdReader *zstd;
+  int slot_index;
+  int frame;
+};
+
+static void zstd_prefetch_task_run(TaskPool * /*pool*/, void *taskdata)
+{
+  const ZstdPrefetchTask *task = static_cast<const ZstdPrefetchTask *>(taskdata);
+  ZstdFramePrefetch &prefetch = *task->zstd->seek.prefetch;
+
+  ZSTD_DCtx *ctx = ZSTD_createDCtx();
+  char *content = zstd_decompress_frame(task->zstd, ctx, task->frame);
+  ZSTD_freeDCtx(ctx);
+
+  std::unique_lock lock{prefetch.mutex};
+  ZstdFramePrefetch::Slot &slot = prefetch.slots[task->slot_index];
+  BLI_assert(slot.frame == task->frame);
+  slot.content = content;
+  slot.is_done = true;
+  prefetch.condition.notify_all();
+}
+
+/**
+ * Take ownership of the content of an already scheduled frame, waiting for its decompression to
+ * finish. Returns null if the frame was not scheduled or could not be decompressed.
+ */
+static char *zstd_prefetch_take(ZstdFramePrefetch &prefetch, const int frame)
+{
+  std::unique_lock lock{prefetch.mutex};
+  for (ZstdFramePrefetch::Slot &slot : prefetch.slots) {
+    if (slot.frame != frame) {
+      continue;
+    }
+    prefetch.condition.wait(lock, [&] { return slot.is_done; });
+    char *content = slot.content;
+    slot = {};
+    return content;
+  }
+  return nullptr;
+}
+
+/** Schedule decompression of the frames following the given one. */
+static void zstd_prefetch_schedule(ZstdReader *zstd, const int frame)
+{
+  ZstdFramePrefetch &prefetch = *zstd->seek.prefetch;
+  const int window_end = std::min(frame + int(prefetch.slots.size()), zstd->seek.frames_num - 1);
+
+  std::unique_lock lock{prefetch.mutex};
+  for (int next_frame = frame + 1; next_frame <= window_end; next_frame++) {
+    const bool is_scheduled = std::any_of(
+        prefetch.slots.begin(), prefetch.slots.end(), [&](const ZstdFramePrefetch::Slot &slot) {
+          return slot.frame == next_frame;
+        });
+    if (is_scheduled) {
+      continue;
+    }
+    /* Reuse a slot that is free, or whose frame is outside of the window (the reader skipped it
+     * or seeked elsewhere). Slots still being decompressed are never reused. */
+    int slot_index = -1;
+    for (const int i : prefetch.slots.index_range()) {
+      ZstdFramePrefetch::Slot &slot = prefetch.slots[i];
+      if (slot.frame == -1 || (slot.is_done && (slot.frame <= frame || slot.frame > window_end)))
+      {
+        slot_index = i;
+        break;
+      }
+    }
+    if (slot_index == -1) {
+      break;
+    }
+    ZstdFramePrefetch::Slot &slot = prefetch.slots[slot_index];
+    MEM_SAFE_DELETE(slot.content);
+    slot.frame = next_frame;
+    slot.is_done = false;
+
+    ZstdPrefetchTask *task = MEM_new_uninitialized<ZstdPrefetchTask>(__func__);
+    task->zstd = zstd;
+    task->slot_index = slot_index;
+    task->frame = next_frame;
+    BLI_task_pool_push(prefetch.pool, zstd_prefetch_task_run, task, true, nullptr);
+  }
+}
+
+static void zstd_prefetch_free(ZstdFramePrefetch *prefetch)
+{
+  BLI_task_pool_work_and_wait(prefetch->pool);
+  BLI_task_pool_free(prefetch->pool);
+  for (ZstdFramePrefetch::Slot &slot : prefetch->slots) {
+    MEM_SAFE_DELETE(slot.content);
+  }
+  MEM_delete(prefetch);
+}
+
+/* Ensure that the currently loaded frame is the correct one. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  if (zstd->seek.cached_frame == frame) {
+    /* Cached frame matches, so just return it. */
+    return zstd->seek.cached_content;
+  }
+
+  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
+  MEM_SAFE_DELETE(zstd->seek.cached_content);
+
+  char *uncompressed_data = nullptr;
+  if (zstd->seek.prefetch) {
+    uncompressed_data = zstd_prefetch_take(*zstd->seek.prefetch, frame);
+  }
+  if (uncompressed_data == nullptr) {
+    uncompressed_data = zstd_decompress_frame(zstd, zstd->ctx, frame);
+  }
+  if (uncompressed_data == nullptr) {
+    return nullptr;
+  }
 
   zstd->seek.cached_frame = frame;
   zstd->seek.cached_content = uncompressed_data;
+
+  if (zstd->seek.prefetch) {
+    zstd_prefetch_schedule(zstd, frame);
+  }
   return uncompressed_data;
 }
 
@@ -279,6 +436,11 @@ static void zstd_close(FileReader *reader)
 {
   ZstdReader *zstd = reinterpret_cast<ZstdReader *>(reader);
 
+  if (zstd->seek.prefetch) {
+    /* Wait for running tasks before the base reader is closed. */
+    zstd_prefetch_free(zstd->seek.prefetch);
+  }
+
   ZSTD_freeDCtx(zstd->ctx);
   if (zstd->reader.seek) {
     MEM_delete(zstd->seek.uncompressed_ofs);
@@ -306,6 +468,13 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   if (zstd_read_seek_table(zstd)) {
     zstd->reader.read = zstd_read_seekable;
     zstd->reader.seek = zstd_seek;
+
+    const int threads_num = BLI_system_thread_count();
+    if (threads_num > 1 && zstd->seek.frames_num > 1) {
+      zstd->seek.prefetch = MEM_new<ZstdFramePrefetch>(__func__);
+      zstd->seek.prefetch->pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_HIGH);
+      zstd->seek.prefetch->slots.resize(std::clamp(threads_num, 2, 16));
+    }
   }
   else {
     zstd->reader.read = zstd_read;
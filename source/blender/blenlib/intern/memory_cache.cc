@@ -71,28 +71,29 @@ static void set_new_logical_time(const StoredValue &stored_value, const int64_t
   static_assert(sizeof(int64_t) == sizeof(std::atomic<int64_t>));
 }
 
-std::shared_ptr<CachedValue> get_base(const GenericKey &key,
-                                      const FunctionRef<std::unique_ptr<CachedValue>()> compute_fn)
+/**
+ * Find the value and "touch" it so that we know that it is still used. This makes it less likely
+ * that it is removed.
+ */
+static std::shared_ptr<CachedValue> lookup_and_touch(Cache &cache,
+                                                     const GenericKey &key,
+                                                     const int64_t new_time)
 {
-  Cache &cache = get_cache();
-  /* "Touch" the cached value so that we know that it is still used. This makes it less likely that
-   * it is removed. */
-  const int64_t new_time = cache.logical_time.fetch_add(1, std::memory_order_relaxed);
-  {
-    /* Fast path when the value is already cached. */
-    CacheMap::ConstAccessor accessor;
-    if (cache.map.lookup(accessor, std::ref(key))) {
-      set_new_logical_time(accessor->second, new_time);
-      return accessor->second.value;
-    }
+  CacheMap::ConstAccessor accessor;
+  if (cache.map.lookup(accessor, std::ref(key))) {
+    set_new_logical_time(accessor->second, new_time);
+    return accessor->second.value;
   }
+  return nullptr;
+}
 
-  /* Compute value while no locks are held to avoid potential for dead-locks. Not using a lock also
-   * means that the value may be computed more than once, but that's still better than locking all
-   * the time. It may be possible to implement something smarter in the future. */
-  std::shared_ptr<CachedValue> result = compute_fn();
-  /* Result should be valid. Use exception to propagate error if necessary. */
-  BLI_assert(result);
+static std::shared_ptr<CachedValue> add_with_time(Cache &cache,
+                                                  const GenericKey &key,
+                                                  std::shared_ptr<CachedValue> value,
+                                                  const int64_t new_time)
+{
+  /* Value should be valid. Use exception to propagate error if necessary. */
+  BLI_assert(value);
 
   {
     CacheMap::MutableAccessor accessor;
@@ -110,7 +111,7 @@ std::shared_ptr<CachedValue> get_base(const GenericKey &key,
         *accessor->second.key);
 
     /* Store the value. Don't move, because we still want to return the value from the function. */
-    accessor->second.value = result;
+    accessor->second.value = value;
     /* Set initial logical time for the new cached entry. */
     set_new_logical_time(accessor->second, new_time);
 
@@ -126,7 +127,38 @@ std::shared_ptr<CachedValue> get_base(const GenericKey &key,
   /* Potentially free elements from the cache. Note, even if this would free the value we just
    * added, it would still work correctly, because we already have a shared_ptr to it. */
   try_enforce_limit();
-  return result;
+  return value;
+}
+
+std::shared_ptr<CachedValue> get_base(const GenericKey &key,
+                                      const FunctionRef<std::unique_ptr<CachedValue>()> compute_fn)
+{
+  Cache &cache = get_cache();
+  const int64_t new_time = cache.logical_time.fetch_add(1, std::memory_order_relaxed);
+  /* Fast path when the value is already cached. */
+  if (std::shared_ptr<CachedValue> value = lookup_and_touch(cache, key, new_time)) {
+    return value;
+  }
+
+  /* Compute value while no locks are held to avoid potential for dead-locks. Not using a lock also
+   * means that the value may be computed more than once, but that's still better than locking all
+   * the time. It may be possible to implement something smarter in the future. */
+  std::shared_ptr<CachedValue> result = compute_fn();
+  return add_with_time(cache, key, std::move(result), new_time);
+}
+
+std::shared_ptr<CachedValue> lookup_base(const GenericKey &key)
+{
+  Cache &cache = get_cache();
+  const int64_t new_time = cache.logical_time.fetch_add(1, std::memory_order_relaxed);
+  return lookup_and_touch(cache, key, new_time);
+}
+
+std::shared_ptr<CachedValue> add(const GenericKey &key, std::shared_ptr<CachedValue> value)
+{
+  Cache &cache = get_cache();
+  const int64_t new_time = cache.logical_time.fetch_add(1, std::memory_order_relaxed);
+  return add_with_time(cache, key, std::move(value), new_time);
 }
 
 void set_approximate_size_limit(const int64_t limit_in_bytes)
@@ -0,0 +1,206 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <optional>
+
+#include "BLI_bounds.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_kdtree.hh"
+#include "BLI_math_base_c.hh"
+#include "BLI_spatial_hash_grid.hh"
+
+namespace blender {
+
+SpatialHashGrid::SpatialHashGrid(const Span<float3> positions,
+                                 const IndexMask &mask,
+                                 const float cell_size)
+    : cell_size_(cell_size), inv_cell_size_(1.0f / cell_size)
+{
+  BLI_assert(cell_size > 0.0f);
+  const int points_num = int(mask.size());
+  if (points_num == 0) {
+    return;
+  }
+  bucket_mask_ = power_of_2_max_u(uint(points_num)) - 1;
+  const int buckets_num = int(bucket_mask_) + 1;
+
+  Array<int> point_buckets(points_num);
+  mask.foreach_index_optimized<int>(
+      [&](const int i, const int pos) {
+        point_buckets[pos] = this->bucket_of(this->cell_of(positions[i]));
+      },
+      exec_mode::grain_size(4096));
+
+  /* Counting sort of the points by their bucket. The order within a bucket is sorted, so the
+   * result is deterministic. */
+  bucket_offsets_.reinitialize(buckets_num + 1);
+  bucket_offsets_.fill(0);
+  const OffsetIndices<int> buckets = offset_indices::build_reverse_offsets(point_buckets,
+                                                                          bucket_offsets_);
+  Array<int> sorted_mask_positions(points_num);
+  offset_indices::reverse_indices_in_groups(point_buckets, buckets, sorted_mask_positions);
+
+  Array<int> mask_indices(points_num);
+  mask.to_indices<int>(mask_indices);
+
+  sorted_indices_.reinitialize(points_num);
+  sorted_positions_.reinitialize(points_num);
+  threading::parallel_for(IndexRange(points_num), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const int index = mask_indices[sorted_mask_positions[i]];
+      sorted_indices_[i] = index;
+      sorted_positions_[i] = positions[index];
+    }
+  });
+}
+
+bool SpatialHashGrid::supports_bounds(const Bounds<float3> &bounds, const float cell_size)
+{
+  const float max_coordinate = math::reduce_max(
+      math::max(math::abs(bounds.min), math::abs(bounds.max)));
+  /* Also false for infinite and NaN coordinates. */
+  return max_coordinate / cell_size < max_cell_coordinate;
+}
+
+/** Precomputed neighbors of the points processed by one task in #calc_duplicates. */
+struct DuplicatesTaskNeighbors {
+  /** Range in #neighbors for every point, or nothing if it has not been precomputed. */
+  Vector<std::optional<IndexRange>> ranges;
+  Vector<int> neighbors;
+};
+
+int SpatialHashGrid::calc_duplicates(const Span<float3> positions,
+                                     const IndexMask &mask,
+                                     const float range,
+                                     MutableSpan<int> duplicates)
+{
+  const SpatialHashGrid grid(positions, mask, range);
+
+  /* Every merge depends on the merges before it, so they have to be applied in order. Finding
+   * the neighbors is the expensive part though, so it is done in parallel for chunks of points
+   * before the merges of the chunk are applied. */
+  constexpr int64_t chunk_size = 64 * 1024;
+  constexpr int64_t task_size = 1024;
+  /* Limit the memory used by the precomputed neighbors. Once the budget of a task is used up,
+   * the merges of its remaining points are found when they are applied. This is important when
+   * there are many points in range of each other, then most of them are merged by the first
+   * points. Only neighbors that can still be merged are stored. */
+  constexpr int64_t max_task_neighbors = 64 * 1024;
+
+  const auto is_merge_target = [&](const int i) { return ELEM(duplicates[i], -1, i); };
+
+  int found = 0;
+  const auto merge_neighbor = [&](const int i, const int neighbor) {
+    if (neighbor != i && duplicates[neighbor] == -1) {
+      duplicates[neighbor] = i;
+      found++;
+      return true;
+    }
+    return false;
+  };
+
+  Array<DuplicatesTaskNeighbors> tasks((chunk_size + task_size - 1) / task_size);
+  for (int64_t chunk_start = 0; chunk_start < mask.size(); chunk_start += chunk_size) {
+    const IndexMask chunk = mask.slice(chunk_start,
+                                       std::min(chunk_size, mask.size() - chunk_start));
+    const int64_t tasks_num = (chunk.size() + task_size - 1) / task_size;
+    const auto task_mask = [&](const int64_t task) {
+      const int64_t start = task * task_size;
+      return chunk.slice(start, std::min(task_size, chunk.size() - start));
+    };
+
+    /* The merges of previous chunks are not changed while the neighbors are found. Points that
+     * are merged already stay merged, so they can be skipped. */
+    threading::parallel_for(IndexRange(tasks_num), 1, [&](const IndexRange tasks_range) {
+      for (const int64_t task : tasks_range) {
+        DuplicatesTaskNeighbors &data = tasks[task];
+        data.ranges.clear();
+        data.neighbors.clear();
+        bool budget_exceeded = false;
+        task_mask(task).foreach_index([&](const int i) {
+          if (!is_merge_target(i) || budget_exceeded) {
+            data.ranges.append(std::nullopt);
+            return;
+          }
+          const int64_t start = data.neighbors.size();
+          grid.foreach_in_radius(positions[i], range, [&](const int index, const float /*d*/) {
+            if (budget_exceeded || index == i || duplicates[index] != -1) {
+              return;
+            }
+            if (data.neighbors.size() >= max_task_neighbors) {
+              budget_exceeded = true;
+              return;
+            }
+            data.neighbors.append(index);
+          });
+          if (budget_exceeded) {
+            data.neighbors.resize(start);
+            data.ranges.append(std::nullopt);
+            return;
+          }
+          data.ranges.append(IndexRange::from_begin_end(start, data.neighbors.size()));
+        });
+      }
+    });
+
+    for (const int64_t task : IndexRange(tasks_num)) {
+      const DuplicatesTaskNeighbors &data = tasks[task];
+      task_mask(task).foreach_index([&](const int i, const int64_t pos) {
+        if (!is_merge_target(i)) {
+          return;
+        }
+        bool any_merged = false;
+        if (const std::optional<IndexRange> &neighbors_range = data.ranges[pos]) {
+          for (const int neighbor : data.neighbors.as_span().slice(*neighbors_range)) {
+            any_merged |= merge_neighbor(i, neighbor);
+          }
+        }
+        else {
+          grid.foreach_in_radius(positions[i], range, [&](const int index, const float /*d*/) {
+            any_merged |= merge_neighbor(i, index);
+          });
+        }
+        if (any_merged) {
+          /* Prevent chains of doubles. */
+          duplicates[i] = i;
+        }
+      });
+    }
+  }
+  return found;
+}
+
+/**
+ * Below this number of points, building the KD-tree and finding the duplicates serially is
+ * faster than building the grid and finding the neighbors in parallel.
+ */
+static constexpr int64_t spatial_hash_grid_min_points = 10000;
+
+int calc_duplicate_points(const Span<float3> positions,
+                          const IndexMask &mask,
+                          const float range,
+                          const bool use_index_order,
+                          MutableSpan<int> duplicates)
+{
+  if (range > 0.0f && mask.size() > spatial_hash_grid_min_points) {
+    const std::optional<Bounds<float3>> bounds = bounds::min_max(mask, positions);
+    if (bounds && SpatialHashGrid::supports_bounds(*bounds, range)) {
+      return SpatialHashGrid::calc_duplicates(positions, mask, range, duplicates);
+    }
+  }
+  KDTree<float3> *tree = kdtree_new<float3>(uint(mask.size()));
+  mask.foreach_index_optimized<int>(
+      [&](const int i) { kdtree_insert<float3>(tree, i, positions[i]); });
+  kdtree_balance<float3>(tree);
+  const int found = kdtree_calc_duplicates_fast<float3>(
+      tree, range, use_index_order, duplicates.data());
+  kdtree_free<float3>(tree);
+  return found;
+}
+
+}  // namespace blender
@@ -8,8 +8,11 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_compiler_attrs.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_kdopbvh.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_c.hh"
 #include "BLI_rand_c.hh"
 
@@ -70,11 +73,17 @@ static void optimal_check_callback(void *userdata,
  * Note that a small epsilon is added to the BVH nodes bounds, even if we pass in zero.
  * Use rounding to ensure very close nodes don't cause the wrong node to be found as nearest.
  */
-static void find_nearest_points_test(
-    int points_len, float scale, int round, int random_seed, bool optimal = false)
+static void find_nearest_points_test(int points_len,
+                                     float scale,
+                                     int round,
+                                     int random_seed,
+                                     bool optimal = false,
+                                     bool use_sah = false)
 {
   RNG *rng = BLI_rng_new(random_seed);
-  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+  /* The SAH build is only supported for binary trees. */
+  BVHTree *tree = use_sah ? BLI_bvhtree_new(points_len, 0.0, 2, 6) :
+                            BLI_bvhtree_new(points_len, 0.0, 8, 8);
 
   void *mem = MEM_new_array_uninitialized<float[3]>(size_t(points_len), __func__);
   float (*points)[3] = static_cast<float (*)[3]>(mem);
@@ -83,7 +92,7 @@ static void find_nearest_points_test(
     rng_v3_round(points[i], 3, rng, round, scale);
     BLI_bvhtree_insert(tree, i, points[i], 1);
   }
-  BLI_bvhtree_balance(tree);
+  BLI_bvhtree_balance_ex(tree, use_sah ? BVH_BALANCE_SAH : 0);
 
   /* first find each point */
   BVHTree_NearestPointCallback callback = optimal ? optimal_check_callback : nullptr;
@@ -137,4 +146,111 @@ TEST(kdopbvh, OptimalFindNearest_500)
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
 
+TEST(kdopbvh, SAHFindNearest_1)
+{
+  find_nearest_points_test(1, 1.0, 1000, 1234, false, true);
+}
+TEST(kdopbvh, SAHFindNearest_2)
+{
+  find_nearest_points_test(2, 1.0, 1000, 123, false, true);
+}
+TEST(kdopbvh, SAHFindNearest_500)
+{
+  find_nearest_points_test(500, 1.0, 1000, 12, false, true);
+}
+
+TEST(kdopbvh, SAHUpdateTree)
+{
+  const int points_len = 500;
+  RNG *rng = BLI_rng_new(42);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 2, 6);
+
+  Array<float3> points(points_len);
+  for (const int i : points.index_range()) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance_ex(tree, BVH_BALANCE_SAH);
+
+  /* Moving the points requires refitting the branches bottom-up, which relies on the order in
+   * which the branches are stored. */
+  for (const int i : points.index_range()) {
+    points[i] = points[i] * 2.0f + float3(10.0f, 0.0f, 0.0f);
+    BLI_bvhtree_update_node(tree, i, points[i], nullptr, 1);
+  }
+  BLI_bvhtree_update_tree(tree);
+
+  for (const int i : points.index_range()) {
+    const int j = BLI_bvhtree_find_nearest(tree, points[i], nullptr, nullptr, nullptr);
+    EXPECT_GE(j, 0);
+    EXPECT_LT(j, points_len);
+    EXPECT_EQ(points[i], points[j]);
+  }
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+}
+
+TEST(kdopbvh, BatchQueriesMatchSingleQueries)
+{
+  const int points_len = 2000;
+  const int queries_len = 5000;
+  RNG *rng = BLI_rng_new(42);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 4, 8);
+  Array<float3> points(points_len);
+  for (const int i : points.index_range()) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  Array<float3> positions(queries_len);
+  Array<float3> directions(queries_len);
+  for (const int i : positions.index_range()) {
+    rng_v3_round(positions[i], 3, rng, 1000, 2.0f);
+    rng_v3_round(directions[i], 3, rng, 1000, 1.0f);
+    directions[i] = math::normalize(directions[i] + float3(0.0f, 0.0f, 2.0f));
+  }
+  /* Skip some queries to check that the mask is respected. */
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      positions.index_range(), memory, [](const int i) { return i % 3 != 0; });
+
+  Array<BVHTreeNearest> nearest(queries_len);
+  Array<BVHTreeRayHit> hits(queries_len);
+  for (const int i : positions.index_range()) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+    hits[i].index = -1;
+    hits[i].dist = BVH_RAYCAST_DIST_MAX;
+  }
+  BLI_bvhtree_find_nearest_batch(*tree, mask, positions, nearest, nullptr, nullptr);
+  BLI_bvhtree_ray_cast_batch(*tree, mask, positions, directions, 0.0f, hits, nullptr, nullptr);
+
+  for (const int i : positions.index_range()) {
+    if (!mask.contains(i)) {
+      EXPECT_EQ(nearest[i].index, -1);
+      EXPECT_EQ(hits[i].index, -1);
+      continue;
+    }
+    BVHTreeNearest expected_nearest;
+    expected_nearest.index = -1;
+    expected_nearest.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, positions[i], &expected_nearest, nullptr, nullptr);
+    EXPECT_EQ(nearest[i].index, expected_nearest.index);
+    EXPECT_EQ(nearest[i].dist_sq, expected_nearest.dist_sq);
+
+    BVHTreeRayHit expected_hit;
+    expected_hit.index = -1;
+    expected_hit.dist = BVH_RAYCAST_DIST_MAX;
+    BLI_bvhtree_ray_cast(tree, positions[i], directions[i], 0.0f, &expected_hit, nullptr, nullptr);
+    EXPECT_EQ(hits[i].index, expected_hit.index);
+    if (expected_hit.index != -1) {
+      EXPECT_EQ(hits[i].dist, expected_hit.dist);
+    }
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+}
+
 }  // namespace blender
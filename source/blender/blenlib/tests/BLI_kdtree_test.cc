@@ -0,0 +1,95 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_kdtree.hh"
+#include "BLI_spatial_test_utils.hh"
+
+namespace blender::tests {
+
+static KDTree<float3> *build_tree(const Span<float3> positions)
+{
+  KDTree<float3> *tree = kdtree_new<float3>(uint(positions.size()));
+  for (const int i : positions.index_range()) {
+    kdtree_insert<float3>(tree, i, positions[i]);
+  }
+  kdtree_balance<float3>(tree);
+  return tree;
+}
+
+TEST(kdtree, FindNearestBatch)
+{
+  const Array<float3> positions = random_positions(50000, 0);
+  const Array<float3> queries = random_positions(500, 1);
+  KDTree<float3> *tree = build_tree(positions);
+
+  Array<int> indices(queries.size());
+  Array<KDTreeNearest<float3>> nearest(queries.size());
+  kdtree_find_nearest_batch<float3>(tree, queries, indices, nearest);
+
+  for (const int i : queries.index_range()) {
+    float best_dist_sq = FLT_MAX;
+    for (const float3 &position : positions) {
+      best_dist_sq = std::min(best_dist_sq, math::distance_squared(position, queries[i]));
+    }
+    EXPECT_EQ(indices[i], nearest[i].index);
+    EXPECT_FLOAT_EQ(math::distance_squared(positions[indices[i]], queries[i]), best_dist_sq);
+  }
+  kdtree_free<float3>(tree);
+}
+
+TEST(kdtree, FindNearestNBatch)
+{
+  const Array<float3> positions = random_positions(20000, 2);
+  const Array<float3> queries = random_positions(1000, 3);
+  KDTree<float3> *tree = build_tree(positions);
+
+  const uint nearest_num = 4;
+  Array<KDTreeNearest<float3>> nearest(queries.size() * nearest_num);
+  Array<int> nearest_len(queries.size());
+  kdtree_find_nearest_n_batch<float3>(tree, queries, nearest_num, nearest, nearest_len);
+
+  for (const int i : queries.index_range()) {
+    KDTreeNearest<float3> expected[nearest_num];
+    const int expected_len = kdtree_find_nearest_n<float3>(
+        tree, queries[i], expected, nearest_num);
+    EXPECT_EQ(nearest_len[i], expected_len);
+    for (const int j : IndexRange(nearest_len[i])) {
+      EXPECT_EQ(nearest[i * nearest_num + j].index, expected[j].index);
+    }
+  }
+  kdtree_free<float3>(tree);
+}
+
+TEST(kdtree, RangeSearchBatch)
+{
+  const Array<float3> positions = random_positions(20000, 4);
+  const Array<float3> queries = random_positions(200, 5);
+  const float range = 0.05f;
+  KDTree<float3> *tree = build_tree(positions);
+
+  Array<int> found_num(queries.size(), 0);
+  kdtree_range_search_batch<float3>(
+      tree, queries, range, [&](const int64_t i, const Span<KDTreeNearest<float3>> nearest) {
+        for (const int j : nearest.index_range().drop_front(1)) {
+          EXPECT_LE(nearest[j - 1].dist, nearest[j].dist);
+        }
+        found_num[i] = int(nearest.size());
+      });
+
+  for (const int i : queries.index_range()) {
+    int expected_num = 0;
+    for (const float3 &position : positions) {
+      if (math::distance_squared(position, queries[i]) <= range * range) {
+        expected_num++;
+      }
+    }
+    EXPECT_EQ(found_num[i], expected_num);
+  }
+  kdtree_free<float3>(tree);
+}
+
+}  // namespace blender::tests
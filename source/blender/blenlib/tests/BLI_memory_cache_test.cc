@@ -105,4 +105,20 @@ TEST(memory_cache, RemoveIf)
                })->value);
 }
 
+TEST(memory_cache, LookupAndAdd)
+{
+  memory_cache::clear();
+
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(3)), nullptr);
+  memory_cache::add(GenericIntKey(3), std::make_shared<CachedInt>(3));
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(3))->value, 3);
+
+  /* The first added value is kept. */
+  memory_cache::add(GenericIntKey(3), std::make_shared<CachedInt>(4));
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(3))->value, 3);
+  EXPECT_EQ(3, memory_cache::get<CachedInt>(GenericIntKey(3), [&]() {
+                 return std::make_unique<CachedInt>(10);
+               })->value);
+}
+
 }  // namespace blender::memory_cache::tests
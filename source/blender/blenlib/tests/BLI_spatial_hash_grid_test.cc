@@ -0,0 +1,176 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <limits>
+
+#include "BLI_bounds.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_kdtree.hh"
+#include "BLI_spatial_hash_grid.hh"
+#include "BLI_spatial_test_utils.hh"
+
+namespace blender::tests {
+
+TEST(spatial_hash_grid, Empty)
+{
+  const SpatialHashGrid grid({}, IndexMask(), 0.1f);
+  int found = 0;
+  grid.foreach_in_radius(float3(0.0f), 1.0f, [&](const int /*index*/, const float /*d*/) {
+    found++;
+  });
+  EXPECT_EQ(found, 0);
+}
+
+TEST(spatial_hash_grid, RadiusBatch)
+{
+  const Array<float3> positions = random_positions(10000, 0);
+  const Array<float3> queries = random_positions(200, 1);
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      positions.index_range(), memory, [](const int i) { return i % 3 != 0; });
+
+  const float radius = 0.05f;
+  const SpatialHashGrid grid(positions, mask, radius);
+
+  Array<Vector<int>> found(queries.size());
+  grid.foreach_in_radius_batch(
+      queries, radius, [&](const int64_t i, const Span<int> indices) { found[i] = indices; });
+
+  for (const int i : queries.index_range()) {
+    Vector<int> expected;
+    mask.foreach_index([&](const int index) {
+      if (math::distance_squared(positions[index], queries[i]) <= radius * radius) {
+        expected.append(index);
+      }
+    });
+    EXPECT_EQ(found[i].as_span(), expected.as_span());
+  }
+
+  /* A radius that is much larger than the cells. */
+  int found_num = 0;
+  grid.foreach_in_radius(float3(0.5f), 10.0f, [&](const int /*index*/, const float /*d*/) {
+    found_num++;
+  });
+  EXPECT_EQ(found_num, mask.size());
+}
+
+static Array<int> calc_duplicates_kdtree(const Span<float3> positions,
+                                         const IndexMask &mask,
+                                         const float range,
+                                         int &r_duplicates_num)
+{
+  Array<int> duplicates(positions.size(), -1);
+  KDTree<float3> *tree = kdtree_new<float3>(uint(mask.size()));
+  mask.foreach_index([&](const int i) { kdtree_insert<float3>(tree, i, positions[i]); });
+  kdtree_balance<float3>(tree);
+  r_duplicates_num = kdtree_calc_duplicates_fast<float3>(tree, range, true, duplicates.data());
+  kdtree_free<float3>(tree);
+  return duplicates;
+}
+
+TEST(spatial_hash_grid, CalcDuplicatesMatchesKDTree)
+{
+  const Array<float3> positions = random_positions(5000, 2);
+  const float range = 0.02f;
+
+  int expected_num;
+  const Array<int> expected = calc_duplicates_kdtree(
+      positions, positions.index_range(), range, expected_num);
+
+  Array<int> duplicates(positions.size(), -1);
+  const int duplicates_num = SpatialHashGrid::calc_duplicates(
+      positions, positions.index_range(), range, duplicates);
+
+  EXPECT_EQ(duplicates_num, expected_num);
+  EXPECT_EQ(duplicates.as_span(), expected.as_span());
+}
+
+TEST(spatial_hash_grid, CalcDuplicatesDenseCluster)
+{
+  /* More points than fit into one chunk, with a cluster that has more points in range of each
+   * other than the neighbors that can be stored per task. */
+  Array<float3> positions = random_positions(250000, 3);
+  const Array<float3> cluster_offsets = random_positions(positions.size(), 4);
+  for (const int i : IndexRange::from_begin_end(70000, 210000)) {
+    if (i % 2 == 0) {
+      positions[i] = float3(0.5f) + cluster_offsets[i] * 0.001f;
+    }
+  }
+  const float range = 0.01f;
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      positions.index_range(), memory, [](const int i) { return i % 7 != 0; });
+
+  int expected_num;
+  const Array<int> expected = calc_duplicates_kdtree(positions, mask, range, expected_num);
+
+  Array<int> duplicates(positions.size(), -1);
+  const int duplicates_num = SpatialHashGrid::calc_duplicates(
+      positions, mask, range, duplicates);
+
+  EXPECT_EQ(duplicates_num, expected_num);
+  EXPECT_EQ(duplicates.as_span(), expected.as_span());
+}
+
+TEST(spatial_hash_grid, SupportsBounds)
+{
+  EXPECT_TRUE(SpatialHashGrid::supports_bounds({float3(-10.0f), float3(10.0f)}, 0.001f));
+  EXPECT_FALSE(SpatialHashGrid::supports_bounds({float3(0.0f), float3(1e9f)}, 0.01f));
+  EXPECT_FALSE(SpatialHashGrid::supports_bounds({float3(-1e9f), float3(0.0f)}, 0.01f));
+  EXPECT_FALSE(SpatialHashGrid::supports_bounds(
+      {float3(0.0f), float3(0.0f, std::numeric_limits<float>::infinity(), 0.0f)}, 1.0f));
+}
+
+TEST(spatial_hash_grid, CalcDuplicatePoints)
+{
+  /* Enough points for the spatial hash grid to be used. */
+  const Array<float3> positions = random_positions(30000, 5);
+  const float range = 0.005f;
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      positions.index_range(), memory, [](const int i) { return i % 5 != 0; });
+
+  int expected_num;
+  const Array<int> expected = calc_duplicates_kdtree(positions, mask, range, expected_num);
+
+  Array<int> duplicates(positions.size(), -1);
+  const int duplicates_num = calc_duplicate_points(positions, mask, range, true, duplicates);
+
+  EXPECT_GT(duplicates_num, 0);
+  EXPECT_EQ(duplicates_num, expected_num);
+  EXPECT_EQ(duplicates.as_span(), expected.as_span());
+}
+
+TEST(spatial_hash_grid, CalcDuplicatePointsLargeCoordinates)
+{
+  /* The coordinates of the points are too large compared to the range for the cells of the
+   * grid, they would all be clamped into a few cells. The KD-tree is used instead. */
+  const Array<float3> offsets = random_positions(30000, 6);
+  Array<float3> positions(offsets.size());
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(2e9f) + offsets[i] * 1e8f;
+    if (i % 3 == 1) {
+      /* Exact duplicates, since the distances between other points are much larger than the
+       * range at this precision. */
+      positions[i] = positions[i - 1];
+    }
+  }
+  const float range = 0.01f;
+  const IndexMask mask = positions.index_range();
+  EXPECT_FALSE(SpatialHashGrid::supports_bounds(*bounds::min_max(positions.as_span()), range));
+
+  int expected_num;
+  const Array<int> expected = calc_duplicates_kdtree(positions, mask, range, expected_num);
+
+  Array<int> duplicates(positions.size(), -1);
+  const int duplicates_num = calc_duplicate_points(positions, mask, range, true, duplicates);
+
+  EXPECT_EQ(duplicates_num, positions.size() / 3);
+  EXPECT_EQ(duplicates_num, expected_num);
+  EXPECT_EQ(duplicates.as_span(), expected.as_span());
+}
+
+}  // namespace blender::tests
@@ -0,0 +1,24 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
+
+namespace blender::tests {
+
+/** Positions that are uniformly distributed in the unit cube. */
+inline Array<float3> random_positions(const int num, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float3> positions(num);
+  for (float3 &position : positions) {
+    position = float3(rng.get_float(), rng.get_float(), rng.get_float());
+  }
+  return positions;
+}
+
+}  // namespace blender::tests
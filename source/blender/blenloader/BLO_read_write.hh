@@ -539,6 +539,42 @@ const ImplicitSharingInfo *BLO_read_shared(BlendDataReader *reader,
   return shared_data.sharing_info;
 }
 
+ImplicitSharingInfoAndData blo_read_shared_mapped_impl(
+    BlendDataReader *reader,
+    const void **ptr_p,
+    const char *struct_name,
+    int64_t size_in_bytes,
+    int64_t alignment,
+    FunctionRef<const ImplicitSharingInfo *()> read_fn);
+
+/**
+ * Same as #BLO_read_shared, but for an array of trivial data of `size_in_bytes` bytes. When the
+ * blend-file is memory-mapped and the array was stored in the same layout it has in memory, the
+ * returned data references the mapped file directly instead of a copy. It is then only read from
+ * disk when it is accessed. The mapped memory is copy-on-write, so the data can be treated like
+ * any other shared data. Otherwise the provided function is called to read the data as usual.
+ *
+ * \param struct_name: Name of the DNA struct the array was written with, or null for arrays
+ * written with #BlendWriter::write_raw (e.g. #BlendWriter::write_float_array). The mapped memory is
+ * only used when the stored block has that type.
+ * \param alignment: The required alignment of the data, the mapped memory is only used when it
+ * is aligned accordingly.
+ */
+template<typename T>
+const ImplicitSharingInfo *BLO_read_shared_mapped(
+    BlendDataReader *reader,
+    T **data_ptr,
+    const char *struct_name,
+    const int64_t size_in_bytes,
+    const int64_t alignment,
+    FunctionRef<const ImplicitSharingInfo *()> read_fn)
+{
+  ImplicitSharingInfoAndData shared_data = blo_read_shared_mapped_impl(
+      reader, (const void **)data_ptr, struct_name, size_in_bytes, alignment, read_fn);
+  *data_ptr = const_cast<T *>(static_cast<const T *>(shared_data.data));
+  return shared_data.sharing_info;
+}
+
 int BLO_read_fileversion_get(BlendDataReader *reader);
 bool BLO_read_data_is_undo(BlendDataReader *reader);
 void BLO_read_data_globmap_add(BlendDataReader *reader, void *oldaddr, void *newaddr);
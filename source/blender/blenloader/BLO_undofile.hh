@@ -18,6 +18,8 @@
 namespace blender {
 
 struct Main;
+struct MemFileCompression;
+struct MemFileStoredChunk;
 struct Scene;
 struct WriteData;
 struct WriteDataStableAddressIDs;
@@ -38,6 +40,18 @@ struct MemFileChunk {
   size_t size;
   /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
   bool is_identical;
+  /**
+   * When true, the memory is owned by the content-addressed chunk storage shared by all memfiles,
+   * and this chunk holds one reference to #stored_chunk (independent of #is_identical). #buf is
+   * null while the memfile is compressed, the storage may then only keep the data compressed.
+   */
+  bool is_content_addressed;
+  MemFileStoredChunk *stored_chunk;
+  /**
+   * When non-zero, #buf holds the compressed data of this chunk, of that size in bytes (see
+   * #BLO_memfile_compress). Only chunks that own their buffer are compressed this way.
+   */
+  size_t compressed_size;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
    * Defined when writing the next step (i.e. last undo step has those always false). */
@@ -55,6 +69,8 @@ struct MemFile {
    * without making a copy. This is faster and requires less memory.
    */
   MemFileSharedStorage *shared_storage;
+  /** Compression of the chunks running in the background, see #BLO_memfile_compress. */
+  MemFileCompression *compression;
 };
 
 struct MemFileWriteData {
@@ -111,6 +127,27 @@ void BLO_memfile_merge(MemFile *first, MemFile *second);
  * Clear is_identical_future before adding next memfile.
  */
 void BLO_memfile_clear_future(MemFile *memfile);
+/**
+ * Start compressing the chunks of the memfile in a background task, to reduce the memory used by
+ * undo steps that are not active. Only the buffers that are not shared with other chunks
+ * are compressed, so it should be called after the next step has been written with
+ * \a memfile as reference (which defines #MemFileChunk.is_identical_future). Buffers in the
+ * content-addressed storage are compressed once no uncompressed memfile references them.
+ *
+ * The chunks are decompressed on demand, when the memfile is read or used as reference for
+ * writing the next step.
+ */
+void BLO_memfile_compress(MemFile *memfile);
+/**
+ * Finish the background compression if it is done, updating #MemFile.size accordingly. This may
+ * also change the size of other memfiles, when they carry the size of stored buffers that were
+ * compressed. Does not wait for a compression that is still running.
+ */
+void BLO_memfile_compress_update(MemFile *memfile);
+/**
+ * Wait for the background compression and decompress all chunks of the memfile.
+ */
+void BLO_memfile_decompress(MemFile *memfile);
 
 /* Utilities. */
 
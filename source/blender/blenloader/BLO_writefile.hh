@@ -65,6 +65,12 @@ extern bool BLO_write_file(Main *mainvar,
  */
 extern bool BLO_write_file_mem(Main *mainvar, MemFile *compare, MemFile *current, int write_flags);
 
+/**
+ * \return The number of compressed frames that the last save to \a filepath copied from the
+ * previous version of the file instead of compressing them again. Mainly useful for tests.
+ */
+extern int BLO_write_file_reused_frames_num(const char *filepath);
+
 /** \} */
 
 }  // namespace blender
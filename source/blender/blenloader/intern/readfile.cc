@@ -62,6 +62,7 @@
 #include "BLI_string_ref.hh"
 #include "BLI_string_utf8.hh"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 #include "BLI_threads.hh"
 #include "BLI_time.hh"
 #include "BLI_utildefines.hh"
@@ -1268,6 +1269,8 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   FileData *fd = filedata_new(reports);
   fd->file = file;
+  fd->use_mapped_data = file->map != nullptr &&
+                        USER_DEVELOPER_TOOL_TEST(&U, use_mapped_blend_file_data);
 
   BLI_stat_t stat;
   if (BLI_stat(filepath, &stat) != -1) {
@@ -1458,15 +1461,37 @@ short BLO_version_from_file(const char *filepath)
 /** \name Old/New Pointer Map
  * \{ */
 
+/**
+ * Read a data-block that was deferred by #read_data_into_datamap, because it is accessed as
+ * regular data after all.
+ */
+static void datamap_read_deferred(FileData *fd, const void *adr)
+{
+  if (fd->deferred_datamap.is_empty()) {
+    return;
+  }
+  const std::optional<DeferredDataBlock> deferred = fd->deferred_datamap.pop_try(adr);
+  if (!deferred) {
+    return;
+  }
+  if (void *data = read_struct(
+          fd, deferred->bhead, deferred->allocname, deferred->id_type_index))
+  {
+    oldnewmap_insert(fd->datamap, adr, data, 0);
+  }
+}
+
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
+  datamap_read_deferred(fd, adr);
   return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
+  datamap_read_deferred(fd, adr);
   return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
 }
 
@@ -1906,6 +1931,40 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname, const i
   return temp;
 }
 
+/**
+ * Check whether the block can be converted with #read_struct_reconstruct_on_thread, i.e. it is
+ * valid and needs DNA reconstruction. Blocks for which this is false go through #read_struct,
+ * which handles all error cases.
+ */
+static bool read_struct_needs_reconstruct(const FileData *fd, const BHead *bh)
+{
+  if (bh->len == 0 || bh->SDNAnr <= SDNA_RAW_DATA_STRUCT_INDEX ||
+      bh->SDNAnr >= fd->filesdna->structs.size())
+  {
+    return false;
+  }
+  if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+    return false;
+  }
+  if (fd->compflags[bh->SDNAnr] != SDNA_CMP_NOT_EQUAL) {
+    return false;
+  }
+  const int64_t old_struct_size = DNA_struct_size(fd->filesdna.get(), bh->SDNAnr);
+  return bh->nr >= 0 && (old_struct_size == 0 || bh->nr <= bh->len / old_struct_size);
+}
+
+/**
+ * Same as the DNA reconstruction done in #read_struct, for a block whose data is in memory.
+ * Only reads from \a fd, so it can be called from multiple threads concurrently.
+ */
+static void *read_struct_reconstruct_on_thread(const FileData *fd,
+                                               const BHead *bh,
+                                               const char *alloc_name)
+{
+  BLI_assert(read_struct_needs_reconstruct(fd, bh));
+  return DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1), alloc_name);
+}
+
 static ID *read_id_struct(FileData *fd, BHead *bh, const char *blockname, const int id_type_index)
 {
   ID *id = static_cast<ID *>(read_struct(fd, bh, blockname, id_type_index));
@@ -2797,7 +2856,45 @@ static bool direct_link_id(FileData *fd,
   return success;
 }
 
-/* Read all data associated with a datablock into datamap. */
+/**
+ * Blocks of at least this size are not read into the datamap directly when they may be referenced
+ * from the file mapping instead, see #read_data_into_datamap.
+ */
+static constexpr int64_t MAPPED_DATA_MIN_SIZE = 64 * 1024;
+
+static bool read_data_can_be_deferred(FileData *fd, BHead *bh, const int id_type_index)
+{
+  if (!fd->use_mapped_data || id_type_index == INDEX_ID_NULL) {
+    return false;
+  }
+  if (bh->len < MAPPED_DATA_MIN_SIZE) {
+    return false;
+  }
+  if (bh->SDNAnr < 0 || bh->SDNAnr >= fd->filesdna->structs.size()) {
+    /* Let #read_struct handle the error. */
+    return false;
+  }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  /* The data is referenced by its offset in the file. */
+  if (BHEADN_FROM_BHEAD(bh)->has_data) {
+    return false;
+  }
+  return fd->compflags[bh->SDNAnr] == SDNA_CMP_EQUAL;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Read all data associated with a datablock into datamap.
+ *
+ * File access and all bookkeeping happen on the calling thread, but the DNA reconstruction of
+ * blocks written with a different struct layout (the most expensive part for files from other
+ * Blender versions) is done in parallel.
+ *
+ * Large blocks that may be referenced from the file mapping are not read here, but added to
+ * #FileData::deferred_datamap.
+ */
 static BHead *read_data_into_datamap(FileData *fd,
                                      BHead *bhead,
                                      const char *allocname,
@@ -2805,19 +2902,72 @@ static BHead *read_data_into_datamap(FileData *fd,
 {
   bhead = blo_bhead_next(fd, bhead);
 
+  Vector<BHead *, 64> data_bheads;
   while (bhead && bhead->code == BLO_CODE_DATA) {
-    void *data = read_struct(fd, bhead, allocname, id_type_index);
-    if (data) {
-      const bool is_new = oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+    data_bheads.append(bhead);
+    bhead = blo_bhead_next(fd, bhead);
+  }
+
+  Array<void *, 64> data(data_bheads.size(), nullptr);
+
+  /* Blocks to reconstruct in parallel. Their data is read in memory beforehand if needed. */
+  Vector<int64_t, 64> reconstruct_indices;
+  Array<BHead *, 64> reconstruct_bheads(data_bheads.size(), nullptr);
+  Array<const char *, 64> reconstruct_alloc_names(data_bheads.size(), nullptr);
+  for (const int64_t i : data_bheads.index_range()) {
+    BHead *bh = data_bheads[i];
+    if (read_data_can_be_deferred(fd, bh, id_type_index)) {
+      fd->deferred_datamap.add_overwrite(bh->old, {bh, allocname, id_type_index});
+      continue;
+    }
+    if (!read_struct_needs_reconstruct(fd, bh)) {
+      data[i] = read_struct(fd, bh, allocname, id_type_index);
+      continue;
+    }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
+      bh = blo_bhead_read_full(fd, bh);
+      if (bh == nullptr) [[unlikely]] {
+        fd->flags &= ~FD_FLAGS_FILE_OK;
+        continue;
+      }
+    }
+#endif
+    reconstruct_indices.append(i);
+    reconstruct_bheads[i] = bh;
+    reconstruct_alloc_names[i] = get_alloc_name(fd, bh, allocname, id_type_index);
+  }
+
+  threading::parallel_for(
+      reconstruct_indices.index_range(),
+      64 * 1024,
+      [&](const IndexRange range) {
+        for (const int64_t i : reconstruct_indices.as_span().slice(range)) {
+          data[i] = read_struct_reconstruct_on_thread(
+              fd, reconstruct_bheads[i], reconstruct_alloc_names[i]);
+        }
+      },
+      threading::individual_task_sizes(
+          [&](const int64_t index) { return reconstruct_bheads[reconstruct_indices[index]]->len; }));
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  for (const int64_t i : reconstruct_indices) {
+    if (reconstruct_bheads[i] != data_bheads[i]) {
+      MEM_delete(BHEADN_FROM_BHEAD(reconstruct_bheads[i]));
+    }
+  }
+#endif
+
+  for (const int64_t i : data_bheads.index_range()) {
+    if (data[i]) {
+      const bool is_new = oldnewmap_insert(fd->datamap, data_bheads[i]->old, data[i], 0);
       if (!is_new) {
         CLOG_ERROR(&LOG,
                    "Blendfile corruption: Invalid, or multiple `bhead` with same old address "
                    "value (%p) for a given ID.",
-                   bhead->old);
+                   data_bheads[i]->old);
       }
     }
-
-    bhead = blo_bhead_next(fd, bhead);
   }
 
   return bhead;
@@ -3543,6 +3693,7 @@ static BHead *read_libblock(FileData *fd,
   bhead = read_data_into_datamap(fd, bhead, blockname, id_type_index);
   const bool success = direct_link_id(fd, main, id_tag, id_read_tags, id, id_old);
   oldnewmap_clear(fd->datamap);
+  fd->deferred_datamap.clear();
 
   if (!success) {
     /* XXX This is probably working OK currently given the very limited scope of that flag.
@@ -6246,6 +6397,86 @@ ImplicitSharingInfoAndData blo_read_shared_impl(
   return shared_data;
 }
 
+/**
+ * Check that the data-block was written with the given DNA struct, or as raw data when the struct
+ * name is null. The struct is looked up by its name, like in #DNA_struct_reconstruct.
+ */
+static bool mapped_data_has_struct_type(const FileData *fd,
+                                        const BHead *bh,
+                                        const char *struct_name)
+{
+  if (struct_name == nullptr) {
+    return bh->SDNAnr == SDNA_RAW_DATA_STRUCT_INDEX;
+  }
+  if (bh->SDNAnr == SDNA_RAW_DATA_STRUCT_INDEX) {
+    return false;
+  }
+  const SDNA *sdna = fd->filesdna.get();
+  return sdna->types[sdna->structs[bh->SDNAnr]->type_index] == struct_name;
+}
+
+/**
+ * Reference a deferred data-block from the file mapping, see #read_data_into_datamap.
+ * \return The sharing info owning the mapped memory, or null if the data has to be read normally.
+ */
+static const ImplicitSharingInfo *read_data_from_mapping(FileData *fd,
+                                                         const void **ptr_p,
+                                                         const char *struct_name,
+                                                         const int64_t size_in_bytes,
+                                                         const int64_t alignment)
+{
+  const DeferredDataBlock *deferred = fd->deferred_datamap.lookup_ptr(*ptr_p);
+  if (deferred == nullptr) {
+    return nullptr;
+  }
+  BHead *bh = deferred->bhead;
+  /* Fall back to the regular reading, which reports invalid sizes. */
+  if (size_in_bytes <= 0 || size_in_bytes > bh->len) {
+    return nullptr;
+  }
+  /* The block only has the expected layout if it was written with the expected struct. Otherwise
+   * the regular reading converts the data (or reports the error). */
+  if (!mapped_data_has_struct_type(fd, bh, struct_name)) {
+    return nullptr;
+  }
+
+  const ImplicitSharingInfo *sharing_info = nullptr;
+  const void *data = nullptr;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  data = fd->file->map(
+      fd->file, BHEADN_FROM_BHEAD(bh)->file_offset, size_t(size_in_bytes), &sharing_info);
+#endif
+  if (data == nullptr) {
+    return nullptr;
+  }
+  if (alignment > 1 && uintptr_t(data) % uintptr_t(alignment) != 0) {
+    sharing_info->remove_user_and_delete_if_last();
+    return nullptr;
+  }
+
+  fd->deferred_datamap.remove(*ptr_p);
+  *ptr_p = data;
+  return sharing_info;
+}
+
+ImplicitSharingInfoAndData blo_read_shared_mapped_impl(
+    BlendDataReader *reader,
+    const void **ptr_p,
+    const char *struct_name,
+    const int64_t size_in_bytes,
+    const int64_t alignment,
+    const FunctionRef<const ImplicitSharingInfo *()> read_fn)
+{
+  return blo_read_shared_impl(reader, ptr_p, [&]() -> const ImplicitSharingInfo * {
+    if (const ImplicitSharingInfo *sharing_info = read_data_from_mapping(
+            reader->fd, ptr_p, struct_name, size_in_bytes, alignment))
+    {
+      return sharing_info;
+    }
+    return read_fn();
+  });
+}
+
 bool BLO_read_data_is_undo(BlendDataReader *reader)
 {
   return (reader->fd->flags & FD_FLAGS_IS_MEMFILE);
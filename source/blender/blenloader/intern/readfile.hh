@@ -73,6 +73,16 @@ ENUM_OPERATORS(eFileDataFlag)
 #  pragma GCC poison off_t
 #endif
 
+/**
+ * A data-block that was not read yet, because it may be referenced from the memory-mapped file
+ * directly instead, see #BLO_read_shared_mapped.
+ */
+struct DeferredDataBlock {
+  BHead *bhead;
+  const char *allocname;
+  int id_type_index;
+};
+
 /**
  * General data used during a blend-file reading.
  *
@@ -150,6 +160,16 @@ struct FileData {
   int id_tag_extra = 0;
 
   OldNewMap *datamap = nullptr;
+  /**
+   * Data-blocks of the ID being read that are not in #datamap yet. They are read on first access
+   * through the datamap, unless they are referenced from the file mapping directly.
+   */
+  Map<const void *, DeferredDataBlock> deferred_datamap;
+  /**
+   * Large data-blocks which don't need any conversion may be referenced from the file mapping,
+   * see #FileReader::map.
+   */
+  bool use_mapped_data = false;
   OldNewMap *globmap = nullptr;
   /** Used to keep track of already loaded packed IDs to avoid loading them multiple times. */
   std::shared_ptr<Map<IDHash, ID *>> id_by_deep_hash;
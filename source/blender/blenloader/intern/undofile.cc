@@ -22,8 +22,14 @@
 
 #include "DNA_listBase.h"
 
+#include "BLI_compression.hh"
+#include "BLI_enumerable_thread_specific.hh"
 #include "BLI_implicit_sharing.hh"
 #include "BLI_listbase.hh"
+#include "BLI_mutex.hh"
+#include "BLI_task.hh"
+#include "BLI_task_c.hh"
+#include "BLI_vector.hh"
 
 #include "BLO_readfile.hh"
 #include "BLO_undofile.hh"
@@ -34,16 +40,466 @@
 
 #include "BLI_strict_flags.hh" /* IWYU pragma: keep. Keep last. */
 
+#include "undofile.hh"
 #include "writefile.hh"
 
+#include <atomic>
+#include <xxhash.h>
+#include <zstd.h>
+
 namespace blender {
 
+/* **************** chunk compression *************** */
+
+/** Chunks smaller than this are not worth compressing, the zstd frame overhead dominates. */
+#define MEMFILE_COMPRESS_MIN_SIZE 256
+
+/**
+ * Chunks mostly contain arrays of 4 byte values (floats and integers), the transpose-delta filter
+ * makes these much more compressible. Other data still compresses fine with it.
+ */
+#define MEMFILE_COMPRESS_ITEM_SIZE 4
+
+static size_t memfile_buffer_filter_item_size(const size_t size)
+{
+  return size % MEMFILE_COMPRESS_ITEM_SIZE == 0 ? MEMFILE_COMPRESS_ITEM_SIZE : 1;
+}
+
+/** Temporary buffers reused for compressing multiple chunks on the same thread. */
+struct MemFileCompressBuffers {
+  Vector<uint8_t> filtered;
+  Vector<uint8_t> compressed;
+};
+
+/**
+ * \return The newly allocated compressed data, or null when compressing does not save a
+ * significant amount of memory.
+ */
+static char *memfile_buffer_compress(const char *buf,
+                                     const size_t size,
+                                     MemFileCompressBuffers &buffers,
+                                     size_t *r_compressed_size)
+{
+  const size_t item_size = memfile_buffer_filter_item_size(size);
+  buffers.filtered.resize(int64_t(size));
+  filter_transpose_delta(reinterpret_cast<const uint8_t *>(buf),
+                         buffers.filtered.data(),
+                         size / item_size,
+                         item_size);
+
+  /* Level 3 gives a good balance of compression performance and ratio, and is also used
+   * elsewhere across Blender for calls to #ZSTD_compress. */
+  constexpr int zstd_level = 3;
+  buffers.compressed.resize(int64_t(ZSTD_compressBound(size)));
+  const size_t compressed_size = ZSTD_compress(buffers.compressed.data(),
+                                               size_t(buffers.compressed.size()),
+                                               buffers.filtered.data(),
+                                               size,
+                                               zstd_level);
+  if (ZSTD_isError(compressed_size) || compressed_size > size - size / 8) {
+    return nullptr;
+  }
+
+  char *buf_new = MEM_new_array_uninitialized<char>(compressed_size, "Chunk compressed");
+  memcpy(buf_new, buffers.compressed.data(), compressed_size);
+  *r_compressed_size = compressed_size;
+  return buf_new;
+}
+
+/** \return The newly allocated uncompressed data of a buffer from #memfile_buffer_compress. */
+static char *memfile_buffer_decompress(const char *compressed_buf,
+                                       const size_t compressed_size,
+                                       const size_t size,
+                                       Vector<uint8_t> &buffer)
+{
+  buffer.resize(int64_t(size));
+  const size_t result = ZSTD_decompress(buffer.data(), size, compressed_buf, compressed_size);
+  /* The data was compressed in memory by #memfile_buffer_compress, this cannot fail. */
+  BLI_assert(!ZSTD_isError(result) && result == size);
+  UNUSED_VARS_NDEBUG(result);
+
+  const size_t item_size = memfile_buffer_filter_item_size(size);
+  char *buf_new = MEM_new_array_uninitialized<char>(size, "Chunk buffer");
+  unfilter_transpose_delta(
+      buffer.data(), reinterpret_cast<uint8_t *>(buf_new), size / item_size, item_size);
+  return buf_new;
+}
+
+/* **************** content-addressed chunk storage *************** */
+
+MemFileChunkContentKey memfile_chunk_content_key(const char *buf, const size_t size)
+{
+  return {XXH3_64bits(buf, size), size};
+}
+
+MemFileChunkStorage &memfile_chunk_storage()
+{
+  static MemFileChunkStorage storage;
+  return storage;
+}
+
+static size_t memfile_stored_chunk_memory(const MemFileStoredChunk &stored)
+{
+  return (stored.buf ? stored.key.size : 0) + (stored.compressed_buf ? stored.compressed_size : 0);
+}
+
+/**
+ * Update the size of the owner memfile after the memory used by the buffers changed. Expects the
+ * lock to be held. Like all other changes of #MemFile::size, this only happens on the main
+ * thread, changes made by the background compression are accounted for once it is finished.
+ */
+static void memfile_stored_chunk_update_owner_size(MemFileStoredChunk *stored)
+{
+  const size_t size = memfile_stored_chunk_memory(*stored);
+  BLI_assert(stored->owner->size >= stored->owner_size);
+  stored->owner->size = stored->owner->size - stored->owner_size + size;
+  stored->owner_size = size;
+}
+
+/** Free the uncompressed data when it is not needed anymore. Expects the lock to be held. */
+static void memfile_chunk_storage_try_free_raw(MemFileStoredChunk *stored)
+{
+  if (stored->raw_users > 0 || stored->buf == nullptr || stored->compressed_buf == nullptr ||
+      stored->is_compressing)
+  {
+    return;
+  }
+  MEM_delete(stored->buf);
+  stored->buf = nullptr;
+}
+
+/**
+ * Find a stored buffer with the given content, or add a copy of it to the storage. The returned
+ * chunk has one more user in \a memfile, which needs its uncompressed data.
+ * Returns null when the content cannot be stored (in the rare case of a hash collision).
+ */
+static MemFileStoredChunk *memfile_chunk_storage_add(MemFile *memfile,
+                                                     const char *buf,
+                                                     const size_t size)
+{
+  const MemFileChunkContentKey key = memfile_chunk_content_key(buf, size);
+
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  std::lock_guard lock(storage.mutex);
+  if (MemFileStoredChunk *stored = storage.chunk_by_content.lookup_default(key, nullptr)) {
+    if (stored->buf == nullptr) {
+      /* Rare enough (the data is usually still used by the reference memfile) to decompress while
+       * holding the lock. */
+      Vector<uint8_t> buffer;
+      stored->buf = memfile_buffer_decompress(
+          stored->compressed_buf, stored->compressed_size, size, buffer);
+    }
+    if (memcmp(stored->buf, buf, size) != 0) {
+      memfile_chunk_storage_try_free_raw(stored);
+      return nullptr;
+    }
+    stored->users_by_memfile.lookup_or_add(memfile, 0)++;
+    stored->raw_users++;
+    memfile_stored_chunk_update_owner_size(stored);
+    return stored;
+  }
+
+  char *buf_new = MEM_new_array_uninitialized<char>(size, "Chunk buffer");
+  memcpy(buf_new, buf, size);
+  MemFileStoredChunk *stored = MEM_new<MemFileStoredChunk>(__func__);
+  stored->key = key;
+  stored->buf = buf_new;
+  stored->users_by_memfile.add_new(memfile, 1);
+  stored->raw_users = 1;
+  stored->owner = memfile;
+  storage.chunk_by_content.add_new(key, stored);
+  memfile_stored_chunk_update_owner_size(stored);
+  return stored;
+}
+
+/** Add a user in \a memfile that needs the uncompressed data, which must be available already. */
+static void memfile_chunk_storage_add_user(MemFileStoredChunk *stored, MemFile *memfile)
+{
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  std::lock_guard lock(storage.mutex);
+  BLI_assert(stored->buf != nullptr);
+  stored->users_by_memfile.lookup_or_add(memfile, 0)++;
+  stored->raw_users++;
+}
+
+/**
+ * \param uses_raw: The removed user needed the uncompressed data.
+ */
+static void memfile_chunk_storage_remove_user(MemFileStoredChunk *stored,
+                                              MemFile *memfile,
+                                              const bool uses_raw)
+{
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  std::lock_guard lock(storage.mutex);
+  if (uses_raw) {
+    BLI_assert(stored->raw_users > 0);
+    stored->raw_users--;
+  }
+  int &memfile_users = stored->users_by_memfile.lookup(memfile);
+  BLI_assert(memfile_users > 0);
+  if (--memfile_users == 0) {
+    stored->users_by_memfile.remove(memfile);
+    if (stored->owner == memfile) {
+      memfile->size -= stored->owner_size;
+      stored->owner_size = 0;
+      if (stored->users_by_memfile.is_empty()) {
+        BLI_assert(!stored->is_compressing);
+        storage.chunk_by_content.remove(stored->key);
+        MEM_SAFE_DELETE(stored->buf);
+        MEM_SAFE_DELETE(stored->compressed_buf);
+        MEM_delete(stored);
+        return;
+      }
+      stored->owner = *stored->users_by_memfile.keys().begin();
+    }
+  }
+  /* When the last user that needs the uncompressed data is freed without having been compressed
+   * (e.g. steps that could be redone), the data stays uncompressed. */
+  memfile_chunk_storage_try_free_raw(stored);
+  memfile_stored_chunk_update_owner_size(stored);
+}
+
+/**
+ * Remove the need for uncompressed data of a user, compressing the data when it was the last
+ * user needing it. Called from the background compression of the user's memfile.
+ */
+static void memfile_chunk_storage_release_raw(MemFileStoredChunk *stored,
+                                              MemFileCompressBuffers &buffers)
+{
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  {
+    std::lock_guard lock(storage.mutex);
+    BLI_assert(stored->raw_users > 0);
+    stored->raw_users--;
+    if (stored->raw_users > 0 || stored->compressed_buf != nullptr || stored->is_compressing ||
+        stored->is_incompressible)
+    {
+      memfile_chunk_storage_try_free_raw(stored);
+      return;
+    }
+    stored->is_compressing = true;
+  }
+
+  /* The uncompressed data cannot be freed while compressing, and the stored chunk still has the
+   * user that is being released. */
+  size_t compressed_size = 0;
+  const char *compressed_buf = memfile_buffer_compress(
+      stored->buf, stored->key.size, buffers, &compressed_size);
+
+  std::lock_guard lock(storage.mutex);
+  stored->is_compressing = false;
+  if (compressed_buf == nullptr) {
+    stored->is_incompressible = true;
+    return;
+  }
+  stored->compressed_buf = compressed_buf;
+  stored->compressed_size = compressed_size;
+  /* The data may have been needed again by another memfile in the meantime. */
+  memfile_chunk_storage_try_free_raw(stored);
+}
+
+/** Get the uncompressed data for a user that did not need it anymore, decompressing if needed. */
+static const char *memfile_chunk_storage_acquire_raw(MemFileStoredChunk *stored,
+                                                     Vector<uint8_t> &buffer)
+{
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  {
+    std::lock_guard lock(storage.mutex);
+    stored->raw_users++;
+    if (stored->buf != nullptr) {
+      return stored->buf;
+    }
+  }
+
+  /* The compressed data is never freed while the stored chunk has users. */
+  char *buf_new = memfile_buffer_decompress(
+      stored->compressed_buf, stored->compressed_size, stored->key.size, buffer);
+
+  std::lock_guard lock(storage.mutex);
+  if (stored->buf != nullptr) {
+    /* Decompressed by another memfile in the meantime. */
+    MEM_delete(buf_new);
+    return stored->buf;
+  }
+  stored->buf = buf_new;
+  return buf_new;
+}
+
+/**
+ * Account for changes of the memory used by the stored buffers of these chunks, which may have
+ * been made on other threads.
+ */
+static void memfile_chunk_storage_update_owner_sizes(const Span<MemFileChunk *> chunks)
+{
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  std::lock_guard lock(storage.mutex);
+  for (const MemFileChunk *chunk : chunks) {
+    if (chunk->is_content_addressed) {
+      memfile_stored_chunk_update_owner_size(chunk->stored_chunk);
+    }
+  }
+}
+
+/* **************** background compression *************** */
+
+struct MemFileCompression {
+  TaskPool *task_pool = nullptr;
+  Vector<MemFileChunk *> chunks;
+  /**
+   * Memory saved by compressing the buffers owned by #chunks, only valid once #is_ready is set.
+   * Changes to the memory of stored buffers are accounted for separately.
+   */
+  size_t saved_size = 0;
+  std::atomic<bool> is_ready = false;
+};
+
+static void memfile_compress_fn(TaskPool * /*pool*/, void *task_data)
+{
+  MemFileCompression *compression = static_cast<MemFileCompression *>(task_data);
+  struct CompressLocalData {
+    MemFileCompressBuffers buffers;
+    size_t saved_size = 0;
+  };
+  threading::EnumerableThreadSpecific<CompressLocalData> all_tls;
+  threading::isolate_task([&]() {
+    threading::parallel_for(compression->chunks.index_range(), 16, [&](const IndexRange range) {
+      CompressLocalData &local_data = all_tls.local();
+      for (MemFileChunk *chunk : compression->chunks.as_span().slice(range)) {
+        if (chunk->is_content_addressed) {
+          /* The stored data is compressed once no memfile needs it uncompressed anymore. */
+          memfile_chunk_storage_release_raw(chunk->stored_chunk, local_data.buffers);
+          chunk->buf = nullptr;
+          continue;
+        }
+        size_t compressed_size = 0;
+        char *buf_new = memfile_buffer_compress(
+            chunk->buf, chunk->size, local_data.buffers, &compressed_size);
+        /* Keep the data uncompressed when that does not save a significant amount of memory. */
+        if (buf_new == nullptr) {
+          continue;
+        }
+        MEM_delete(chunk->buf);
+        chunk->buf = buf_new;
+        chunk->compressed_size = compressed_size;
+        local_data.saved_size += chunk->size - compressed_size;
+      }
+    });
+  });
+
+  for (const CompressLocalData &local_data : all_tls) {
+    compression->saved_size += local_data.saved_size;
+  }
+  compression->is_ready.store(true, std::memory_order_release);
+}
+
+/** Wait for the background compression of the memfile (if any) and apply its result. */
+static void memfile_compress_finish(MemFile *memfile)
+{
+  MemFileCompression *compression = memfile->compression;
+  if (compression == nullptr) {
+    return;
+  }
+  BLI_task_pool_work_and_wait(compression->task_pool);
+  BLI_task_pool_free(compression->task_pool);
+  BLI_assert(compression->is_ready);
+  BLI_assert(memfile->size >= compression->saved_size);
+  memfile->size -= compression->saved_size;
+  memfile_chunk_storage_update_owner_sizes(compression->chunks);
+  MEM_delete(compression);
+  memfile->compression = nullptr;
+}
+
+void BLO_memfile_compress(MemFile *memfile)
+{
+  memfile_compress_finish(memfile);
+
+  MemFileCompression *compression = MEM_new<MemFileCompression>(__func__);
+  for (MemFileChunk &chunk : memfile->chunks) {
+    /* Stored chunks are compressed in the storage, when no other memfile needs them. */
+    if (chunk.is_content_addressed) {
+      if (chunk.buf != nullptr) {
+        compression->chunks.append(&chunk);
+      }
+      continue;
+    }
+    /* Buffers shared with other chunks (possibly in other memfiles) are left untouched, so that
+     * decompressing a memfile never affects other ones. Buffers shared with the next step are
+     * still needed uncompressed to write further steps. */
+    if (chunk.is_identical || chunk.is_identical_future || chunk.compressed_size != 0 ||
+        chunk.size < MEMFILE_COMPRESS_MIN_SIZE)
+    {
+      continue;
+    }
+    compression->chunks.append(&chunk);
+  }
+  if (compression->chunks.is_empty()) {
+    MEM_delete(compression);
+    return;
+  }
+
+  compression->task_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+  BLI_task_pool_push(compression->task_pool, memfile_compress_fn, compression, false, nullptr);
+  memfile->compression = compression;
+}
+
+void BLO_memfile_compress_update(MemFile *memfile)
+{
+  if (memfile->compression && memfile->compression->is_ready.load(std::memory_order_acquire)) {
+    memfile_compress_finish(memfile);
+  }
+}
+
+void BLO_memfile_decompress(MemFile *memfile)
+{
+  memfile_compress_finish(memfile);
+
+  Vector<MemFileChunk *> chunks;
+  for (MemFileChunk &chunk : memfile->chunks) {
+    if (chunk.compressed_size != 0 || (chunk.is_content_addressed && chunk.buf == nullptr)) {
+      chunks.append(&chunk);
+    }
+  }
+  if (chunks.is_empty()) {
+    return;
+  }
+
+  struct DecompressLocalData {
+    Vector<uint8_t> buffer;
+    size_t added_size = 0;
+  };
+  threading::EnumerableThreadSpecific<DecompressLocalData> all_tls;
+  threading::parallel_for(chunks.index_range(), 16, [&](const IndexRange range) {
+    DecompressLocalData &local_data = all_tls.local();
+    for (MemFileChunk *chunk : chunks.as_span().slice(range)) {
+      if (chunk->is_content_addressed) {
+        chunk->buf = memfile_chunk_storage_acquire_raw(chunk->stored_chunk, local_data.buffer);
+        continue;
+      }
+      char *buf_new = memfile_buffer_decompress(
+          chunk->buf, chunk->compressed_size, chunk->size, local_data.buffer);
+      local_data.added_size += chunk->size - chunk->compressed_size;
+      MEM_delete(chunk->buf);
+      chunk->buf = buf_new;
+      chunk->compressed_size = 0;
+    }
+  });
+
+  for (const DecompressLocalData &local_data : all_tls) {
+    memfile->size += local_data.added_size;
+  }
+  memfile_chunk_storage_update_owner_sizes(chunks);
+}
+
 /* **************** support for memory-write, for undo buffers *************** */
 
 void BLO_memfile_free(MemFile *memfile)
 {
+  memfile_compress_finish(memfile);
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
+    if (chunk->is_content_addressed) {
+      memfile_chunk_storage_remove_user(chunk->stored_chunk, memfile, chunk->buf != nullptr);
+    }
+    else if (chunk->is_identical == false) {
       MEM_delete(chunk->buf);
     }
     MEM_delete(chunk);
@@ -66,9 +522,17 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
    * by it (i.e. shared with some previous memory steps). */
   Map<const char *, MemFileChunk *> buffer_to_second_memchunk;
 
-  /* First, detect all memchunks in second memfile that are not owned by it. */
+  /* Compressed buffers are never shared, but the chunks must not be modified in the background
+   * while transferring ownership. */
+  memfile_compress_finish(first);
+  memfile_compress_finish(second);
+
+  /* First, detect all memchunks in second memfile that are not owned by it. Chunks in the
+   * content-addressed storage own a reference each, there is no ownership to transfer for them.
+   * When the first memfile carries the size of stored buffers, freeing it moves that size to
+   * another memfile still using them, usually the second one (see #MemFileStoredChunk::owner). */
   for (MemFileChunk &sc : second->chunks) {
-    if (sc.is_identical) {
+    if (sc.is_identical && !sc.is_content_addressed) {
       buffer_to_second_memchunk.add(sc.buf, &sc);
     }
   }
@@ -76,7 +540,7 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
   /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
    * it is also used by the second memfile, transfer the ownership. */
   for (MemFileChunk &fc : first->chunks) {
-    if (!fc.is_identical) {
+    if (!fc.is_identical && !fc.is_content_addressed) {
       if (MemFileChunk *sc = buffer_to_second_memchunk.lookup_default(fc.buf, nullptr)) {
         BLI_assert(sc->is_identical);
         sc->is_identical = false;
@@ -105,6 +569,11 @@ void BLO_memfile_write_init(WriteData *wd,
 {
   wd->use_memfile = true;
 
+  /* The reference chunks are compared with the new data. */
+  if (reference_memfile != nullptr) {
+    BLO_memfile_decompress(reference_memfile);
+  }
+
   mem_data->written_memfile = written_memfile;
   mem_data->reference_memfile = reference_memfile;
   mem_data->reference_current_chunk = reference_memfile ? static_cast<MemFileChunk *>(
@@ -141,6 +610,9 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   curchunk->size = size;
   curchunk->buf = nullptr;
   curchunk->is_identical = false;
+  curchunk->is_content_addressed = false;
+  curchunk->stored_chunk = nullptr;
+  curchunk->compressed_size = 0;
   /* This is unsafe in the sense that an app handler or other code that does not
    * perform an undo push may make changes after the last undo push that
    * will then not be undo. Though it's not entirely clear that is wrong behavior. */
@@ -156,11 +628,27 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
         curchunk->buf = compchunk->buf;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
+        if (compchunk->is_content_addressed) {
+          memfile_chunk_storage_add_user(compchunk->stored_chunk, memfile);
+          curchunk->is_content_addressed = true;
+          curchunk->stored_chunk = compchunk->stored_chunk;
+        }
       }
     }
     *compchunk_step = static_cast<MemFileChunk *>(compchunk->next);
   }
 
+  /* Not equal to the previous step, but the same data may still be stored already. Note that
+   * the chunk is not considered identical in that case, since that is used to detect unchanged
+   * IDs. */
+  if (curchunk->buf == nullptr && size >= MEMFILE_CONTENT_ADDRESSED_MIN_SIZE) {
+    if (MemFileStoredChunk *stored = memfile_chunk_storage_add(memfile, buf, size)) {
+      curchunk->buf = stored->buf;
+      curchunk->is_content_addressed = true;
+      curchunk->stored_chunk = stored;
+    }
+  }
+
   /* not equal... */
   if (curchunk->buf == nullptr) {
     char *buf_new = MEM_new_array_uninitialized<char>(size, "Chunk buffer");
@@ -245,6 +733,7 @@ static int64_t undo_read(FileReader *reader, void *buffer, size_t size)
         readsize = chunk->size - chunkoffset;
       }
 
+      BLI_assert(chunk->compressed_size == 0);
       memcpy(POINTER_OFFSET(buffer, totread), chunk->buf + chunkoffset, readsize);
       totread += readsize;
       undo->reader.offset += off64_t(readsize);
@@ -271,6 +760,9 @@ static void undo_close(FileReader *reader)
 
 FileReader *BLO_memfile_new_filereader(MemFile *memfile, int undo_direction)
 {
+  /* Compressed chunks are only decompressed when the undo step is actually read. */
+  BLO_memfile_decompress(memfile);
+
   UndoReader *undo = MEM_new_zeroed<UndoReader>(__func__);
 
   undo->memfile = memfile;
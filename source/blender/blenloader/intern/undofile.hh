@@ -0,0 +1,86 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup blenloader
+ * Content-addressed storage of large memfile chunks, shared by all memfiles.
+ */
+
+#pragma once
+
+#include "BLI_map.hh"
+#include "BLI_mutex.hh"
+
+#include "BLO_undofile.hh"
+
+namespace blender {
+
+/**
+ * Chunks at least this large are stored in the content-addressed storage when they don't match
+ * the chunk at the same position in the previous step. Typically these are parts of large arrays
+ * (which are written in chunks of a fixed size), that may have moved or may exist multiple times
+ * (e.g. in meshes that were duplicated).
+ */
+#define MEMFILE_CONTENT_ADDRESSED_MIN_SIZE (1 << 14) /* 16kb */
+
+struct MemFileChunkContentKey {
+  uint64_t content_hash;
+  size_t size;
+
+  uint64_t hash() const
+  {
+    return content_hash;
+  }
+
+  friend bool operator==(const MemFileChunkContentKey &a, const MemFileChunkContentKey &b)
+  {
+    return a.content_hash == b.content_hash && a.size == b.size;
+  }
+};
+
+MemFileChunkContentKey memfile_chunk_content_key(const char *buf, size_t size);
+
+/**
+ * A buffer in the content-addressed storage. It is compressed once none of the memfiles that
+ * reference it need its uncompressed data anymore (see #BLO_memfile_compress).
+ */
+struct MemFileStoredChunk {
+  MemFileChunkContentKey key;
+  /** Uncompressed data, null while it is only available compressed. */
+  const char *buf = nullptr;
+  /** Compressed data, kept once created so that compressing again is free. */
+  const char *compressed_buf = nullptr;
+  size_t compressed_size = 0;
+  /** Number of #MemFileChunk referencing the buffer in each memfile. */
+  Map<MemFile *, int> users_by_memfile;
+  /**
+   * The memfile whose #MemFile::size includes the memory used by the buffers, initially the one
+   * that added them. When it stops referencing the buffers (e.g. when it is merged into the next
+   * step with #BLO_memfile_merge), the size is moved to another memfile that still references
+   * them, so that it is always accounted for exactly once.
+   */
+  MemFile *owner = nullptr;
+  /** Memory of the buffers that is currently included in the size of #owner. */
+  size_t owner_size = 0;
+  /** Number of users that need the uncompressed data (their memfile is not compressed). */
+  int raw_users = 0;
+  /** The uncompressed data is being compressed, it must not be freed in the meantime. */
+  bool is_compressing = false;
+  /** Compressing the data doesn't save enough memory, it is always kept uncompressed. */
+  bool is_incompressible = false;
+};
+
+/**
+ * Stores the buffers of large chunks by their content, so that identical data is only stored
+ * once in the undo history.
+ */
+struct MemFileChunkStorage {
+  Mutex mutex;
+  Map<MemFileChunkContentKey, MemFileStoredChunk *> chunk_by_content;
+};
+
+/** The storage shared by all memfiles. */
+MemFileChunkStorage &memfile_chunk_storage();
+
+}  // namespace blender
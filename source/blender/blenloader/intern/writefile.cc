@@ -68,6 +68,7 @@
 #include <fcntl.h>
 #include <iomanip>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <xxhash.h>
 
@@ -104,9 +105,11 @@
 #include "BLI_math_base_c.hh"
 #include "BLI_math_matrix_c.hh"
 #include "BLI_multi_value_map.hh"
+#include "BLI_mutex.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_set.hh"
 #include "BLI_string.hh"
+#include "BLI_task.hh"
 #include "BLI_task_c.hh"
 #include "BLI_threads.hh"
 #include "BLI_time.hh"
@@ -167,6 +170,14 @@ namespace blender {
 #define ZSTD_CHUNK_SIZE (1 << 20)  /* 1mb */
 
 #define ZSTD_COMPRESSION_LEVEL 3
+/**
+ * Buffered data is written as a separate frame at the end of an ID once at least this much is
+ * buffered. Aligning frames with IDs keeps them identical between saves when unrelated IDs
+ * changed, so that they can be reused (see #ZstdWrittenFile).
+ */
+#define ZSTD_ID_FRAME_MIN_SIZE (1 << 18) /* 256kb */
+/** Number of written files for which the frames are remembered. */
+#define ZSTD_WRITTEN_FILES_MAX 4
 
 static CLG_LogRef LOG = {"blend.writefile"};
 static CLG_LogRef LOG_UNDO = {"undo"};
@@ -193,6 +204,11 @@ class WriteWrap {
 
   /** Buffer output (we only want when output isn't already buffered). */
   bool use_buf = true;
+  /**
+   * When non-zero, buffered output is written at the end of an ID once at least this many bytes
+   * are buffered.
+   */
+  size_t id_flush_min_size = 0;
 };
 
 class RawWriteWrap : public WriteWrap {
@@ -227,6 +243,66 @@ bool RawWriteWrap::write(const void *buf, size_t buf_len)
   return ::write(file_handle, buf, buf_len) == buf_len;
 }
 
+/** Identifies the uncompressed content of a frame. */
+struct ZstdFrameKey {
+  XXH128_hash_t content_hash;
+  uint32_t uncompressed_size;
+
+  uint64_t hash() const
+  {
+    return content_hash.low64;
+  }
+
+  friend bool operator==(const ZstdFrameKey &a, const ZstdFrameKey &b)
+  {
+    return XXH128_isEqual(a.content_hash, b.content_hash) &&
+           a.uncompressed_size == b.uncompressed_size;
+  }
+};
+
+struct ZstdWrittenFrame {
+  uint64_t file_offset;
+  uint32_t compressed_size;
+};
+
+/**
+ * The frames of a compressed file written earlier. When saving to the same path again, frames
+ * with identical content are copied from the previous file (which is only replaced once the new
+ * file has been written completely), instead of being compressed again. This makes repeated saves
+ * of large files where little changed (like auto-save) much cheaper.
+ */
+struct ZstdWrittenFile {
+  /** Used to detect if the file was modified or replaced since it was written. */
+  int64_t size = 0;
+  int64_t mtime = 0;
+  uint64_t inode = 0;
+
+  Map<ZstdFrameKey, ZstdWrittenFrame> frames;
+  /** Number of frames that were copied from the previous version of the file. */
+  int reused_frames_num = 0;
+
+  bool matches_file_stat(const BLI_stat_t &st) const
+  {
+    return size == int64_t(st.st_size) && mtime == int64_t(st.st_mtime) &&
+           inode == uint64_t(st.st_ino);
+  }
+};
+
+static Mutex zstd_written_files_mutex;
+
+static Map<std::string, ZstdWrittenFile> &zstd_written_files()
+{
+  static Map<std::string, ZstdWrittenFile> written_files;
+  return written_files;
+}
+
+int BLO_write_file_reused_frames_num(const char *filepath)
+{
+  std::unique_lock lock(zstd_written_files_mutex);
+  const ZstdWrittenFile *written_file = zstd_written_files().lookup_ptr_as(StringRef(filepath));
+  return written_file ? written_file->reused_frames_num : 0;
+}
+
 class ZstdWriteWrap : public WriteWrap {
   struct ZstdWriteBlockTask;
 
@@ -243,17 +319,36 @@ class ZstdWriteWrap : public WriteWrap {
 
   bool write_error = false;
 
+  /** Final path of the written file, where a previous version of the file may exist. */
+  std::string filepath_final;
+  /** Frames of the previous version of the file, and the opened file to copy them from. */
+  std::optional<ZstdWrittenFile> previous_file;
+  int previous_file_handle = -1;
+  /** Frames of the file being written. */
+  ZstdWrittenFile written_file;
+  uint64_t written_size = 0;
+
  public:
-  ZstdWriteWrap(WriteWrap &base_wrap) : base_wrap(base_wrap) {}
+  ZstdWriteWrap(WriteWrap &base_wrap, StringRefNull filepath_final = "")
+      : base_wrap(base_wrap), filepath_final(filepath_final)
+  {
+    if (!this->filepath_final.empty()) {
+      id_flush_min_size = ZSTD_ID_FRAME_MIN_SIZE;
+    }
+  }
 
   bool open(const char *filepath) override;
   bool close() override;
   bool write(const void *buf, size_t buf_len) override;
 
+  /** Remember the frames of the written file, once it has been moved to its final path. */
+  void remember_written_file();
+
  private:
   static void compress_task_run(TaskPool *pool, void *taskdata);
   void write_u32_le(uint32_t val);
   void write_seekable_frames();
+  void *read_previous_frame(const ZstdFrameKey &key, const ZstdWrittenFrame &frame);
 };
 
 struct ZstdWriteWrap::ZstdWriteBlockTask {
@@ -268,14 +363,37 @@ void ZstdWriteWrap::compress_task_run(TaskPool * /*pool*/, void *taskdata)
   ZstdWriteBlockTask *task = static_cast<ZstdWriteBlockTask *>(taskdata);
   ZstdWriteWrap *ww = task->ww;
 
-  size_t out_buf_len = ZSTD_compressBound(task->size);
-  void *out_buf = MEM_new_uninitialized(out_buf_len, "Zstd out buffer");
-  size_t out_size = ZSTD_compress(
-      out_buf, out_buf_len, task->data, task->size, ZSTD_COMPRESSION_LEVEL);
-  MEM_delete_void(task->data);
+  const ZstdFrameKey key{XXH3_128bits(task->data, task->size), uint32_t(task->size)};
+  const ZstdWrittenFrame *previous_frame = ww->previous_file ?
+                                               ww->previous_file->frames.lookup_ptr(key) :
+                                               nullptr;
+
+  void *out_buf = nullptr;
+  size_t out_size = 0;
+  if (previous_frame == nullptr) {
+    size_t out_buf_len = ZSTD_compressBound(task->size);
+    out_buf = MEM_new_uninitialized(out_buf_len, "Zstd out buffer");
+    out_size = ZSTD_compress(out_buf, out_buf_len, task->data, task->size, ZSTD_COMPRESSION_LEVEL);
+  }
 
   std::unique_lock lock{ww->mutex};
   ww->condition.wait(lock, [&] { return ww->next_frame == task->frame_number; });
+  if (previous_frame != nullptr) {
+    /* Reading is done in order, as part of writing the frame. */
+    out_buf = ww->read_previous_frame(key, *previous_frame);
+    if (out_buf != nullptr) {
+      out_size = previous_frame->compressed_size;
+      ww->written_file.reused_frames_num++;
+    }
+    else {
+      size_t out_buf_len = ZSTD_compressBound(task->size);
+      out_buf = MEM_new_uninitialized(out_buf_len, "Zstd out buffer");
+      out_size = ZSTD_compress(
+          out_buf, out_buf_len, task->data, task->size, ZSTD_COMPRESSION_LEVEL);
+    }
+  }
+  MEM_delete_void(task->data);
+
   if (ZSTD_isError(out_size)) {
     ww->write_error = true;
   }
@@ -284,6 +402,9 @@ void ZstdWriteWrap::compress_task_run(TaskPool * /*pool*/, void *taskdata)
     frameinfo->uncompressed_size = task->size;
     frameinfo->compressed_size = out_size;
     BLI_addtail(&ww->frames, frameinfo);
+
+    ww->written_file.frames.add(key, {ww->written_size, uint32_t(out_size)});
+    ww->written_size += out_size;
   }
   else {
     ww->write_error = true;
@@ -294,17 +415,50 @@ void ZstdWriteWrap::compress_task_run(TaskPool * /*pool*/, void *taskdata)
   ww->condition.notify_all();
 }
 
+void *ZstdWriteWrap::read_previous_frame(const ZstdFrameKey &key, const ZstdWrittenFrame &frame)
+{
+  void *buf = MEM_new_uninitialized(frame.compressed_size, "Zstd reused frame");
+  if (BLI_lseek(previous_file_handle, int64_t(frame.file_offset), SEEK_SET) != -1 &&
+      BLI_read(previous_file_handle, buf, frame.compressed_size) ==
+          int64_t(frame.compressed_size) &&
+      /* Sanity check that the data is still the expected frame. */
+      ZSTD_findFrameCompressedSize(buf, frame.compressed_size) == frame.compressed_size &&
+      ZSTD_getFrameContentSize(buf, frame.compressed_size) == key.uncompressed_size)
+  {
+    return buf;
+  }
+  MEM_delete_void(buf);
+  return nullptr;
+}
+
 bool ZstdWriteWrap::open(const char *filepath)
 {
   if (!base_wrap.open(filepath)) {
     return false;
   }
 
+  if (!filepath_final.empty()) {
+    std::unique_lock lock(zstd_written_files_mutex);
+    /* The frames will be replaced by the ones of the new file anyway. */
+    previous_file = zstd_written_files().pop_try(filepath_final);
+  }
+  if (previous_file) {
+    BLI_stat_t st;
+    if (BLI_stat(filepath_final.c_str(), &st) == -1 || !previous_file->matches_file_stat(st)) {
+      previous_file.reset();
+    }
+    else {
+      previous_file_handle = BLI_open(filepath_final.c_str(), O_BINARY | O_RDONLY, 0);
+      if (previous_file_handle == -1) {
+        previous_file.reset();
+      }
+    }
+  }
+
   pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_HIGH);
 
   return true;
 }
-
 void ZstdWriteWrap::write_u32_le(uint32_t val)
 {
   /* NOTE: this is endianness-sensitive.
@@ -352,12 +506,37 @@ bool ZstdWriteWrap::close()
   BLI_task_pool_free(pool);
   pool = nullptr;
 
+  if (previous_file_handle != -1) {
+    ::close(previous_file_handle);
+    previous_file_handle = -1;
+  }
+  previous_file.reset();
+
   write_seekable_frames();
   frames.free_no_destruct();
 
   return base_wrap.close() && !write_error;
 }
 
+void ZstdWriteWrap::remember_written_file()
+{
+  BLI_assert(!filepath_final.empty());
+  BLI_stat_t st;
+  if (write_error || BLI_stat(filepath_final.c_str(), &st) == -1) {
+    return;
+  }
+  written_file.size = int64_t(st.st_size);
+  written_file.mtime = int64_t(st.st_mtime);
+  written_file.inode = uint64_t(st.st_ino);
+
+  std::unique_lock lock(zstd_written_files_mutex);
+  Map<std::string, ZstdWrittenFile> &written_files = zstd_written_files();
+  if (written_files.size() >= ZSTD_WRITTEN_FILES_MAX) {
+    written_files.clear();
+  }
+  written_files.add_overwrite(filepath_final, std::move(written_file));
+}
+
 bool ZstdWriteWrap::write(const void *buf, const size_t buf_len)
 {
   if (write_error) {
@@ -407,6 +586,27 @@ static WriteData *writedata_new(WriteWrap *ww)
   return wd;
 }
 
+/**
+ * Create a #WriteData that records everything written to it into \a recording, to be replayed
+ * later on \a parent_wd. It can be used from a worker thread, \a parent_wd is only read from.
+ */
+static WriteData *writedata_new_for_recording(const WriteData &parent_wd,
+                                              WriteDataRecording &recording)
+{
+  BLI_assert(!parent_wd.use_memfile);
+  WriteData *wd = MEM_new<WriteData>(__func__);
+
+  wd->timestamp_init = parent_wd.timestamp_init;
+
+  wd->sdna = parent_wd.sdna;
+  wd->stable_address_ids.sdna_pointers = parent_wd.stable_address_ids.sdna_pointers;
+  wd->parent_stable_address_ids = &parent_wd.stable_address_ids;
+
+  wd->recording = &recording;
+
+  return wd;
+}
+
 static void writedata_do_write(WriteData *wd, const void *mem, const size_t memlen)
 {
   if ((wd == nullptr) || wd->validation_data.critical_error || (mem == nullptr) || memlen < 1) {
@@ -479,6 +679,12 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
   wd->write_len += len;
 #endif
 
+  if (wd->recording) {
+    wd->recording->data.extend(Span(static_cast<const uchar *>(adr), int64_t(len)));
+    wd->recording->segment_sizes.append(int64_t(len));
+    return;
+  }
+
   if (wd->buffer.buf == nullptr) {
     writedata_do_write(wd, adr, len);
   }
@@ -648,12 +854,20 @@ static void mywrite_id_begin(WriteData *wd, ID *id)
 }
 
 /**
- * Start writing of data related to a single ID.
+ * End writing of data related to a single ID.
  *
- * Only does something when storing an undo step.
+ * When saving with compression, the buffered data is flushed once it reaches
+ * #WriteWrap::id_flush_min_size, so that compressed frames end at ID boundaries and can be
+ * reused by the next save. When storing an undo step, the data is always flushed, so that the
+ * chunks of each ID can be compared with the previous step.
  */
 static void mywrite_id_end(WriteData *wd, ID * /*id*/)
 {
+  if (!wd->use_memfile && wd->ww && wd->ww->id_flush_min_size != 0 &&
+      wd->buffer.used_len >= wd->ww->id_flush_min_size)
+  {
+    mywrite_flush(wd);
+  }
   if (wd->use_memfile) {
     /* Very important to do it after every ID write now, otherwise we cannot know whether a
      * specific ID changed or not. */
@@ -774,10 +988,18 @@ static uint64_t stable_id_from_hint(const uint64_t hint)
   return stable_id;
 }
 
+static bool stable_address_id_is_used_by_parent(const WriteData &wd, const uint64_t stable_id)
+{
+  return wd.parent_stable_address_ids &&
+         wd.parent_stable_address_ids->used_ids.contains(stable_id);
+}
+
 static uint64_t get_next_stable_address_id(WriteData &wd, uint64_t &hint)
 {
   uint64_t stable_id = stable_id_from_hint(hint);
-  while (!wd.stable_address_ids.used_ids.add(stable_id)) {
+  while (stable_address_id_is_used_by_parent(wd, stable_id) ||
+         !wd.stable_address_ids.used_ids.add(stable_id))
+  {
     /* Generate a new hint because there is a collision. Collisions are generally expected to be
      * very rare. It can happen when #get_stable_pointer_hint_for_id produces values that are very
      * close for different IDs. */
@@ -800,6 +1022,12 @@ static uint64_t get_address_id_int(WriteData &wd, const void *address)
     return wd.stable_address_ids.pointer_map.lookup_default_as(
         address, reinterpret_cast<uint64_t>(address));
   }
+  if (wd.parent_stable_address_ids) {
+    if (const uint64_t *address_id = wd.parent_stable_address_ids->pointer_map.lookup_ptr(address))
+    {
+      return *address_id;
+    }
+  }
   /* Either reuse an existing identifier or create a new one. */
   return wd.stable_address_ids.pointer_map.lookup_or_add_cb(address, [&]() {
     return get_next_stable_address_id(wd, wd.stable_address_ids.next_id_hint);
@@ -1284,6 +1512,141 @@ static void write_id(WriteData *wd, ID *id)
   mywrite_id_end(wd, id);
 }
 
+/**
+ * Data-blocks whose #IDTypeInfo.blend_write only modifies its own copy of the ID (see
+ * #BLO_Write_IDBuffer) and data owned by that ID, and otherwise only reads data and writes through
+ * its #BlendWriter. Each of them is written into its own #WriteData, so these can be written from
+ * worker threads.
+ *
+ * Other types (e.g. objects, scenes and node trees) call many callbacks of their own (modifiers,
+ * nodes, tools...) whose side effects are not known, they are always written from the main
+ * thread.
+ */
+static bool id_can_be_written_in_parallel(const ID &id)
+{
+  return ELEM(GS(id.name),
+              ID_ME,
+              ID_CV,
+              ID_PT,
+              ID_GP,
+              ID_VO,
+              ID_AC,
+              ID_KE,
+              ID_LT,
+              ID_CU_LEGACY,
+              ID_MB,
+              ID_TXT,
+              ID_IM,
+              ID_SO,
+              ID_VF);
+}
+
+/** Output of writing a single data-block into its own #WriteData. */
+struct IDWriteRecording {
+  WriteDataRecording recording;
+  /** Stable address ids generated while writing the data-block. */
+  Map<const void *, uint64_t> pointer_map;
+  Set<uint64_t> used_ids;
+  bool is_valid = false;
+};
+
+static void write_id_recorded(const WriteData &parent_wd, ID *id, IDWriteRecording &r_result)
+{
+  WriteData *wd = writedata_new_for_recording(parent_wd, r_result.recording);
+  write_id(wd, id);
+  r_result.pointer_map = std::move(wd->stable_address_ids.pointer_map);
+  r_result.used_ids = std::move(wd->stable_address_ids.used_ids);
+  r_result.is_valid = !wd->validation_data.critical_error;
+  writedata_free(wd);
+}
+
+/**
+ * A recorded data-block only matches what a serial write would have produced if none of its
+ * stable address ids were generated by previously written data-blocks. Otherwise the serial write
+ * would have reused (or rehashed) them, and the data-block has to be written again serially.
+ */
+static bool recorded_address_ids_match_serial_write(const WriteData &wd,
+                                                    const IDWriteRecording &result)
+{
+  for (const void *address : result.pointer_map.keys()) {
+    if (wd.stable_address_ids.pointer_map.contains(address)) {
+      return false;
+    }
+  }
+  for (const uint64_t stable_id : result.used_ids) {
+    if (wd.stable_address_ids.used_ids.contains(stable_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void write_id_recording_replay(WriteData *wd, ID *id, const IDWriteRecording &result)
+{
+  mywrite_id_begin(wd, id);
+
+  for (const auto item : result.pointer_map.items()) {
+    wd->stable_address_ids.pointer_map.add_new(item.key, item.value);
+  }
+  for (const uint64_t stable_id : result.used_ids) {
+    wd->stable_address_ids.used_ids.add_new(stable_id);
+  }
+
+  const uchar *data = result.recording.data.data();
+  for (const int64_t size : result.recording.segment_sizes) {
+    mywrite(wd, data, size_t(size));
+    data += size;
+  }
+
+  mywrite_id_end(wd, id);
+}
+
+/**
+ * Write all given local data-blocks. When writing to a file, data-blocks are serialized on worker
+ * threads into their own buffers, which are then merged in order. The result is byte-identical to
+ * a serial write.
+ */
+static void write_local_ids(WriteData *wd, const Span<ID *> ids)
+{
+  const int threads_num = BLI_system_thread_count();
+  if (wd->use_memfile || wd->debug_dst || threads_num == 1 || ids.size() < 2) {
+    /* Undo steps rely on the writing order to detect unchanged chunks, and are written in memory
+     * anyway. */
+    for (ID *id : ids) {
+      write_id(wd, id);
+    }
+    return;
+  }
+
+  /* Bound the amount of data kept in memory before it is passed on to the file. */
+  const int64_t batch_size = int64_t(threads_num) * 4;
+  for (int64_t batch_start = 0; batch_start < ids.size(); batch_start += batch_size) {
+    const Span<ID *> batch = ids.slice(batch_start,
+                                       std::min(batch_size, ids.size() - batch_start));
+
+    Array<IDWriteRecording> results(batch.size());
+    threading::parallel_for(batch.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        if (id_can_be_written_in_parallel(*batch[i])) {
+          write_id_recorded(*wd, batch[i], results[i]);
+        }
+      }
+    });
+
+    for (const int64_t i : batch.index_range()) {
+      IDWriteRecording &result = results[i];
+      if (result.is_valid && recorded_address_ids_match_serial_write(*wd, result)) {
+        write_id_recording_replay(wd, batch[i], result);
+      }
+      else {
+        write_id(wd, batch[i]);
+      }
+      /* Free the recorded data early. */
+      result = {};
+    }
+  }
+}
+
 static void write_id_placeholder(WriteData *wd, ID *id)
 {
   mywrite_id_begin(wd, id);
@@ -1774,9 +2137,7 @@ static bool write_file_handle(Main *mainvar,
   }
 
   /* Actually write local data-blocks to the file. */
-  for (ID *id : local_ids_to_write) {
-    write_id(wd, id);
-  }
+  write_local_ids(wd, local_ids_to_write);
 
   /* Write libraries about libraries and linked data-blocks. */
   write_libraries(wd, mainvar);
@@ -2099,8 +2460,12 @@ bool BLO_write_file(Main *mainvar,
   RawWriteWrap raw_wrap;
 
   if (write_flags & G_FILE_COMPRESS) {
-    ZstdWriteWrap zstd_wrap(raw_wrap);
-    return BLO_write_file_impl(mainvar, filepath, write_flags, params, reports, zstd_wrap);
+    ZstdWriteWrap zstd_wrap(raw_wrap, filepath);
+    if (!BLO_write_file_impl(mainvar, filepath, write_flags, params, reports, zstd_wrap)) {
+      return false;
+    }
+    zstd_wrap.remember_written_file();
+    return true;
   }
 
   return BLO_write_file_impl(mainvar, filepath, write_flags, params, reports, raw_wrap);
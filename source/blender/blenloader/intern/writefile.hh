@@ -16,6 +16,7 @@
 
 #include "BLI_map.hh"
 #include "BLI_set.hh"
+#include "BLI_vector.hh"
 
 #include "BLO_undofile.hh"
 
@@ -76,6 +77,21 @@ struct WriteDataStableAddressIDs {
   uint64_t next_id_hint = 0;
 };
 
+/**
+ * Data written by a #WriteData that records its output instead of passing it to a #WriteWrap.
+ * Used to serialize data-blocks on worker threads, the recording is then replayed on the main
+ * #WriteData in the original order.
+ */
+struct WriteDataRecording {
+  /** All written bytes, in write order. */
+  Vector<uchar> data;
+  /**
+   * Size of each #mywrite call. Calls are replayed one by one, so that buffering and chunking of
+   * the final output is exactly the same as when writing serially.
+   */
+  Vector<int64_t> segment_sizes;
+};
+
 struct WriteData {
   const SDNA *sdna;
   std::ostream *debug_dst = nullptr;
@@ -122,6 +138,12 @@ struct WriteData {
    * #BLO_memfile_write_init and #BLO_memfile_write_finalize).
    */
   WriteDataStableAddressIDs stable_address_ids;
+  /**
+   * Stable address ids of the #WriteData this one records data for, if any. Only read from, it is
+   * shared by all threads. Its addresses and ids are taken into account when generating new
+   * stable address ids, so that they match the ones a serial write would generate.
+   */
+  const WriteDataStableAddressIDs *parent_stable_address_ids;
 
   /**
    * Keeps track of which shared data has been written for the current ID. This is necessary to
@@ -140,6 +162,8 @@ struct WriteData {
    * Will be nullptr for UNDO.
    */
   WriteWrap *ww;
+  /** When set, all written data is appended to this recording instead of being written out. */
+  WriteDataRecording *recording;
 
   /**
    * Timestamp info defined when creating the new WriteData. Used for performance logging.
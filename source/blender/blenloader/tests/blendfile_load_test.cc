@@ -3,8 +3,34 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 #include "blendfile_loading_base_test.h"
 
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array_utils.hh"
+#include "BLI_fileops.hh"
+#include "BLI_implicit_sharing.hh"
+#include "BLI_listbase.hh"
 #include "BLI_path_utils.hh"
 
+#include "BKE_appdir.hh"
+#include "BKE_attribute.hh"
+#include "BKE_attribute_storage.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.h"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
+#include "BKE_packedFile.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_packedFile_types.h"
+#include "DNA_userdef_types.h"
+#include "DNA_vfont_types.h"
+
+#include "BLO_readfile.hh"
+#include "BLO_writefile.hh"
+
 namespace blender {
 
 class BlendfileLoadingTest : public BlendfileLoadingBaseTest {};
@@ -19,4 +45,182 @@ TEST_F(BlendfileLoadingTest, CanaryTest)
   EXPECT_NE(nullptr, this->depsgraph);
 }
 
+/**
+ * Write the main to an uncompressed file, and read it back with and without referencing large
+ * arrays from the file mapping.
+ */
+class MappedDataTest : public BlendfileLoadingTest {
+ protected:
+  std::string filepath;
+  BlendFileData *bfd_copied = nullptr;
+  BlendFileData *bfd_mapped = nullptr;
+
+  void write_and_read(Main *bmain)
+  {
+    BKE_tempdir_init(nullptr);
+    filepath = std::string(BKE_tempdir_base()) + SEP_STR + "blendfile_mapped_data_test.blend";
+    const BlendFileWriteParams params{};
+    /* Only data of uncompressed files can be mapped. */
+    ASSERT_TRUE(BLO_write_file(bmain, filepath.c_str(), 0, &params, nullptr));
+
+    const UserDef userdef_backup = dna::shallow_copy(U);
+    BlendFileReadReport reports = {};
+    bfd_copied = BLO_read_from_file(filepath.c_str(), BLO_READ_SKIP_NONE, &reports);
+    U.flag |= USER_DEVELOPER_UI;
+    U.experimental.use_mapped_blend_file_data = 1;
+    bfd_mapped = BLO_read_from_file(filepath.c_str(), BLO_READ_SKIP_NONE, &reports);
+    U = dna::shallow_copy(userdef_backup);
+    ASSERT_NE(bfd_copied, nullptr);
+    ASSERT_NE(bfd_mapped, nullptr);
+  }
+
+  void TearDown() override
+  {
+    if (bfd_copied) {
+      BLO_blendfiledata_free(bfd_copied);
+    }
+    if (bfd_mapped) {
+      BLO_blendfiledata_free(bfd_mapped);
+    }
+    if (!filepath.empty()) {
+      BLI_delete(filepath.c_str(), false, false);
+    }
+    BlendfileLoadingTest::TearDown();
+  }
+};
+
+/** Add a font with packed data that is large enough to be referenced from the file mapping. */
+static void add_packed_font(Main *bmain, const char *name, const int seed)
+{
+  constexpr int size = 256 * 1024;
+  uchar *data = static_cast<uchar *>(MEM_new_uninitialized(size, __func__));
+  for (const int i : IndexRange(size)) {
+    data[i] = uchar((i * 31 + seed) % 251);
+  }
+  VFont *vfont = static_cast<VFont *>(BKE_libblock_alloc(bmain, ID_VF, name, 0));
+  vfont->packedfile = BKE_packedfile_new_from_memory(data, size);
+}
+
+static Vector<const PackedFile *> packed_fonts(const Main &bmain)
+{
+  Vector<const PackedFile *> result;
+  for (const VFont &vfont : bmain.fonts) {
+    result.append(vfont.packedfile);
+  }
+  return result;
+}
+
+TEST_F(MappedDataTest, PackedFileData)
+{
+#ifdef WIN32
+  GTEST_SKIP() << "Referencing mapped blend-file data is not supported on Windows";
+#endif
+  Main *bmain = BKE_main_new();
+  add_packed_font(bmain, "FontA", 0);
+  add_packed_font(bmain, "FontB", 1);
+  write_and_read(bmain);
+  if (HasFatalFailure()) {
+    BKE_main_free(bmain);
+    return;
+  }
+
+  const Vector<const PackedFile *> expected = packed_fonts(*bmain);
+  const Vector<const PackedFile *> copied = packed_fonts(*bfd_copied->main);
+  const Vector<const PackedFile *> mapped = packed_fonts(*bfd_mapped->main);
+  ASSERT_EQ(copied.size(), 2);
+  ASSERT_EQ(mapped.size(), 2);
+  for (const int i : expected.index_range()) {
+    ASSERT_EQ(copied[i]->size, expected[i]->size);
+    ASSERT_EQ(mapped[i]->size, expected[i]->size);
+    EXPECT_EQ(memcmp(copied[i]->data, expected[i]->data, expected[i]->size), 0);
+    EXPECT_EQ(memcmp(mapped[i]->data, expected[i]->data, expected[i]->size), 0);
+  }
+
+  /* Copied data is owned by each packed file, while all mapped data is owned by the mapping. */
+  EXPECT_NE(copied[0]->sharing_info, copied[1]->sharing_info);
+  ASSERT_NE(mapped[0]->sharing_info, nullptr);
+  EXPECT_EQ(mapped[0]->sharing_info, mapped[1]->sharing_info);
+
+  /* The mapping stays valid after the file data is freed, as long as it is referenced. */
+  const ImplicitSharingInfo *mapping_sharing_info = mapped[0]->sharing_info;
+  const void *mapped_data = mapped[0]->data;
+  mapping_sharing_info->add_user();
+  BLO_blendfiledata_free(bfd_mapped);
+  bfd_mapped = nullptr;
+  EXPECT_EQ(memcmp(mapped_data, expected[0]->data, expected[0]->size), 0);
+  mapping_sharing_info->remove_user_and_delete_if_last();
+
+  BKE_main_free(bmain);
+}
+
+static const bke::Attribute::ArrayData &attribute_array(const Mesh &mesh, const StringRef name)
+{
+  const bke::Attribute *attribute = mesh.attribute_storage.wrap().lookup(name);
+  BLI_assert(attribute);
+  return std::get<bke::Attribute::ArrayData>(attribute->data());
+}
+
+TEST_F(MappedDataTest, MeshAttributes)
+{
+#ifdef WIN32
+  GTEST_SKIP() << "Referencing mapped blend-file data is not supported on Windows";
+#endif
+  /* Large enough for all arrays to be referenced from the mapping. */
+  constexpr int size = 100000;
+  Main *bmain = BKE_main_new();
+  Mesh *mesh = BKE_mesh_add(bmain, "Mesh");
+  mesh->verts_num = size;
+  mesh->faces_num = size;
+  mesh->corners_num = size * 3;
+  BKE_mesh_face_offsets_ensure_alloc(mesh);
+  array_utils::fill_index_range(mesh->face_offsets_for_write());
+  for (int &offset : mesh->face_offsets_for_write()) {
+    offset *= 3;
+  }
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  bke::MutableAttributeAccessor attributes = mesh->attributes_for_write();
+  bke::SpanAttributeWriter weights = attributes.lookup_or_add_for_write_only_span<float>(
+      "weight", bke::AttrDomain::Point);
+  bke::SpanAttributeWriter flags = attributes.lookup_or_add_for_write_only_span<bool>(
+      "flag", bke::AttrDomain::Point);
+  for (const int i : IndexRange(size)) {
+    positions[i] = float3(float(i), float(i % 7), float(i % 13));
+    weights.span[i] = float(i) * 0.5f;
+    flags.span[i] = i % 3 == 0;
+  }
+  weights.finish();
+  flags.finish();
+
+  write_and_read(bmain);
+  if (HasFatalFailure()) {
+    BKE_main_free(bmain);
+    return;
+  }
+
+  const Mesh &mesh_copied = *static_cast<const Mesh *>(bfd_copied->main->meshes.first);
+  const Mesh &mesh_mapped = *static_cast<const Mesh *>(bfd_mapped->main->meshes.first);
+  EXPECT_EQ_SPAN<int>(mesh_copied.face_offsets(), mesh->face_offsets());
+  EXPECT_EQ_SPAN<int>(mesh_mapped.face_offsets(), mesh->face_offsets());
+
+  const ImplicitSharingInfo *mapping_sharing_info =
+      mesh_mapped.runtime->face_offsets_sharing_info;
+  EXPECT_NE(mapping_sharing_info, mesh_copied.runtime->face_offsets_sharing_info);
+  for (const StringRef name : {"position", "weight", "flag"}) {
+    SCOPED_TRACE(name);
+    const bke::Attribute::ArrayData &expected = attribute_array(*mesh, name);
+    const bke::Attribute::ArrayData &copied = attribute_array(mesh_copied, name);
+    const bke::Attribute::ArrayData &mapped = attribute_array(mesh_mapped, name);
+    ASSERT_EQ(copied.size, expected.size);
+    ASSERT_EQ(mapped.size, expected.size);
+    const int64_t size_in_bytes = MEM_allocN_len(expected.data);
+    EXPECT_EQ(memcmp(copied.data, expected.data, size_in_bytes), 0);
+    EXPECT_EQ(memcmp(mapped.data, expected.data, size_in_bytes), 0);
+    /* All mapped arrays are owned by the file mapping. */
+    EXPECT_NE(copied.sharing_info.get(), mapping_sharing_info);
+    EXPECT_EQ(mapped.sharing_info.get(), mapping_sharing_info);
+  }
+
+  BKE_main_free(bmain);
+}
+
 }  // namespace blender
@@ -0,0 +1,120 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+#include "blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_threads.hh"
+
+#include "BKE_appdir.hh"
+#include "BKE_global.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.h"
+#include "BKE_object.hh"
+#include "BKE_text.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_object_types.h"
+
+#include "BLO_writefile.hh"
+
+namespace blender {
+
+class BlendfileWritingTest : public BlendfileLoadingBaseTest {};
+
+static void fill_positions(Mesh &mesh, const int seed)
+{
+  MutableSpan<float3> positions = mesh.vert_positions_for_write();
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(float(i % 1000), float(i / 1000), float(seed));
+  }
+}
+
+TEST_F(BlendfileWritingTest, ReuseCompressedFrames)
+{
+  constexpr int meshes_num = 8;
+  /* Large enough for every mesh to end up in its own compressed frames. */
+  constexpr int verts_num = 100000;
+
+  Main *bmain = BKE_main_new();
+  Vector<Mesh *> meshes;
+  for (const int i : IndexRange(meshes_num)) {
+    Mesh *mesh = BKE_mesh_add(bmain, ("Mesh" + std::to_string(i)).c_str());
+    mesh->verts_num = verts_num;
+    fill_positions(*mesh, i);
+    meshes.append(mesh);
+  }
+
+  BKE_tempdir_init(nullptr);
+  const std::string filepath = std::string(BKE_tempdir_base()) + SEP_STR +
+                               "blendfile_write_test.blend";
+  const BlendFileWriteParams params{};
+
+  ASSERT_TRUE(BLO_write_file(bmain, filepath.c_str(), G_FILE_COMPRESS, &params, nullptr));
+  EXPECT_EQ(BLO_write_file_reused_frames_num(filepath.c_str()), 0);
+
+  /* Only the frames of the modified mesh have to be compressed again. */
+  fill_positions(*meshes[3], meshes_num);
+  ASSERT_TRUE(BLO_write_file(bmain, filepath.c_str(), G_FILE_COMPRESS, &params, nullptr));
+  EXPECT_GE(BLO_write_file_reused_frames_num(filepath.c_str()), meshes_num - 2);
+
+  BKE_main_free(bmain);
+  BLI_delete(filepath.c_str(), false, false);
+}
+
+static std::string read_file(const std::string &filepath)
+{
+  size_t size = 0;
+  void *data = BLI_file_read_binary_as_mem(filepath.c_str(), 0, &size);
+  std::string result(static_cast<const char *>(data), size);
+  MEM_delete_void(data);
+  return result;
+}
+
+TEST_F(BlendfileWritingTest, ParallelWriteMatchesSerialWrite)
+{
+  Main *bmain = BKE_main_new();
+  for (const int i : IndexRange(16)) {
+    const std::string name = std::to_string(i);
+    Mesh *mesh = BKE_mesh_add(bmain, ("Mesh" + name).c_str());
+    mesh->verts_num = 1000 * (i + 1);
+    fill_positions(*mesh, i);
+    /* Objects are written on the main thread, in between the data-blocks written in parallel. */
+    Object *ob = BKE_object_add_only_object(bmain, OB_MESH, ("Object" + name).c_str());
+    ob->data = id_cast<ID *>(mesh);
+    BKE_text_add(bmain, ("Text" + name).c_str());
+  }
+
+  BKE_tempdir_init(nullptr);
+  const std::string filepath = std::string(BKE_tempdir_base()) + SEP_STR +
+                               "blendfile_parallel_write_test.blend";
+  const BlendFileWriteParams params{};
+
+  for (const int file_flags : {0, int(G_FILE_COMPRESS)}) {
+    SCOPED_TRACE(file_flags);
+    BLI_system_num_threads_override_set(1);
+    ASSERT_TRUE(BLO_write_file(bmain, filepath.c_str(), file_flags, &params, nullptr));
+    const std::string serial_file = read_file(filepath);
+    BLI_delete(filepath.c_str(), false, false);
+
+    /* Use several threads even on machines with a single core. */
+    BLI_system_num_threads_override_set(8);
+    ASSERT_TRUE(BLO_write_file(bmain, filepath.c_str(), file_flags, &params, nullptr));
+    const std::string parallel_file = read_file(filepath);
+    BLI_delete(filepath.c_str(), false, false);
+    BLI_system_num_threads_override_set(0);
+
+    EXPECT_FALSE(serial_file.empty());
+    EXPECT_EQ(serial_file.size(), parallel_file.size());
+    /* Not compared with #EXPECT_EQ to avoid printing the whole files. */
+    EXPECT_TRUE(serial_file == parallel_file);
+  }
+
+  BKE_main_free(bmain);
+}
+
+}  // namespace blender
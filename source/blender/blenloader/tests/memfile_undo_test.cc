@@ -0,0 +1,297 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <thread>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_filereader.hh"
+#include "BLI_threads.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_undo_system.hh"
+
+#include "BLO_undofile.hh"
+
+#include "../intern/undofile.hh"
+
+namespace blender::tests {
+
+class MemFileUndoTest : public testing::Test {
+ protected:
+  void SetUp() override
+  {
+    BLI_threadapi_init();
+  }
+
+  void TearDown() override
+  {
+    BLI_threadapi_exit();
+  }
+};
+
+/** Large enough to be stored in the content-addressed storage. */
+constexpr size_t chunk_size = MEMFILE_CONTENT_ADDRESSED_MIN_SIZE * 2;
+
+/** Compressible data that is different for every seed. */
+static Vector<char> create_buffer(const int seed)
+{
+  Vector<char> buffer;
+  buffer.resize(int64_t(chunk_size));
+  for (const int64_t i : IndexRange(int64_t(chunk_size / sizeof(int)))) {
+    const int value = seed * 1000 + int(i / 64);
+    memcpy(buffer.data() + i * sizeof(int), &value, sizeof(int));
+  }
+  return buffer;
+}
+
+/** Write the buffers as consecutive chunks of the memfile, like an undo push. */
+static void write_memfile(MemFile &memfile,
+                          MemFile *reference_memfile,
+                          const Span<const Vector<char> *> buffers)
+{
+  if (reference_memfile) {
+    BLO_memfile_decompress(reference_memfile);
+  }
+  MemFileWriteData mem_data{};
+  mem_data.written_memfile = &memfile;
+  mem_data.reference_memfile = reference_memfile;
+  mem_data.reference_current_chunk = reference_memfile ? static_cast<MemFileChunk *>(
+                                                             reference_memfile->chunks.first) :
+                                                         nullptr;
+  for (const Vector<char> *buffer : buffers) {
+    BLO_memfile_chunk_add(&mem_data, buffer->data(), size_t(buffer->size()));
+  }
+}
+
+static Vector<MemFileChunk *> memfile_chunks(MemFile &memfile)
+{
+  Vector<MemFileChunk *> chunks;
+  for (MemFileChunk &chunk : memfile.chunks) {
+    chunks.append(&chunk);
+  }
+  return chunks;
+}
+
+static void wait_for_compression(MemFile &memfile)
+{
+  while (memfile.compression != nullptr) {
+    std::this_thread::yield();
+    BLO_memfile_compress_update(&memfile);
+  }
+}
+
+static Vector<char> read_memfile(MemFile &memfile, const size_t size)
+{
+  Vector<char> result;
+  result.resize(int64_t(size));
+  FileReader *reader = BLO_memfile_new_filereader(&memfile, STEP_UNDO);
+  EXPECT_EQ(reader->read(reader, result.data(), size), int64_t(size));
+  reader->close(reader);
+  return result;
+}
+
+static bool is_stored(const MemFileChunkContentKey &key)
+{
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  std::lock_guard lock(storage.mutex);
+  return storage.chunk_by_content.contains(key);
+}
+
+TEST_F(MemFileUndoTest, CompressStoredChunk)
+{
+  const Vector<char> buffer = create_buffer(0);
+  MemFile memfile_a = {};
+  MemFile memfile_b = {};
+  write_memfile(memfile_a, nullptr, {&buffer});
+  write_memfile(memfile_b, &memfile_a, {&buffer});
+
+  MemFileChunk &chunk_a = *memfile_chunks(memfile_a)[0];
+  MemFileChunk &chunk_b = *memfile_chunks(memfile_b)[0];
+  ASSERT_TRUE(chunk_a.is_content_addressed);
+  ASSERT_TRUE(chunk_b.is_content_addressed);
+  EXPECT_TRUE(chunk_b.is_identical);
+  MemFileStoredChunk &stored = *chunk_a.stored_chunk;
+  const MemFileChunkContentKey key = stored.key;
+  EXPECT_EQ(chunk_b.stored_chunk, &stored);
+  EXPECT_EQ(stored.users_by_memfile.lookup(&memfile_a), 1);
+  EXPECT_EQ(stored.users_by_memfile.lookup(&memfile_b), 1);
+  EXPECT_EQ(stored.raw_users, 2);
+  /* The memfile that added the data carries its size. */
+  EXPECT_EQ(stored.owner, &memfile_a);
+  EXPECT_EQ(memfile_a.size, chunk_size);
+  EXPECT_EQ(memfile_b.size, size_t(0));
+
+  /* The other memfile still needs the uncompressed data. */
+  BLO_memfile_compress(&memfile_a);
+  wait_for_compression(memfile_a);
+  EXPECT_EQ(chunk_a.buf, nullptr);
+  EXPECT_EQ(stored.raw_users, 1);
+  EXPECT_FALSE(stored.is_compressing);
+  EXPECT_NE(stored.buf, nullptr);
+  EXPECT_EQ(stored.compressed_buf, nullptr);
+  EXPECT_EQ(memfile_a.size, chunk_size);
+
+  /* Compressing the last memfile using the uncompressed data compresses the stored data, which
+   * changes the size of the memfile that carries it. */
+  BLO_memfile_compress(&memfile_b);
+  wait_for_compression(memfile_b);
+  EXPECT_EQ(stored.raw_users, 0);
+  EXPECT_FALSE(stored.is_compressing);
+  EXPECT_EQ(stored.buf, nullptr);
+  ASSERT_NE(stored.compressed_buf, nullptr);
+  EXPECT_LT(stored.compressed_size, chunk_size);
+  EXPECT_EQ(memfile_a.size, stored.compressed_size);
+  EXPECT_EQ(memfile_b.size, size_t(0));
+
+  /* Reading decompresses the data again, the compressed data is kept. */
+  EXPECT_EQ(read_memfile(memfile_a, chunk_size), buffer);
+  EXPECT_EQ(stored.raw_users, 1);
+  EXPECT_EQ(chunk_a.buf, stored.buf);
+  EXPECT_EQ(memfile_a.size, chunk_size + stored.compressed_size);
+
+  /* Compressing again frees the uncompressed data without compressing it again. */
+  BLO_memfile_compress(&memfile_a);
+  wait_for_compression(memfile_a);
+  EXPECT_EQ(stored.raw_users, 0);
+  EXPECT_EQ(stored.buf, nullptr);
+  EXPECT_EQ(memfile_a.size, stored.compressed_size);
+
+  BLO_memfile_free(&memfile_b);
+  EXPECT_TRUE(is_stored(key));
+  EXPECT_EQ(memfile_a.size, stored.compressed_size);
+  BLO_memfile_free(&memfile_a);
+  EXPECT_FALSE(is_stored(key));
+}
+
+TEST_F(MemFileUndoTest, MergeMovesStoredChunkSize)
+{
+  const Vector<char> buffer = create_buffer(0);
+  const Vector<char> buffer_other = create_buffer(1);
+  MemFile memfile_a = {};
+  MemFile memfile_b = {};
+  write_memfile(memfile_a, nullptr, {&buffer, &buffer_other});
+  write_memfile(memfile_b, &memfile_a, {&buffer});
+  const MemFileChunkContentKey key = memfile_chunks(memfile_b)[0]->stored_chunk->key;
+  const MemFileChunkContentKey key_other = memfile_chunks(memfile_a)[1]->stored_chunk->key;
+  EXPECT_EQ(memfile_a.size, chunk_size * 2);
+  EXPECT_EQ(memfile_b.size, size_t(0));
+
+  BLO_memfile_compress(&memfile_a);
+  wait_for_compression(memfile_a);
+  const MemFileStoredChunk &stored_other = *memfile_chunks(memfile_a)[1]->stored_chunk;
+  ASSERT_NE(stored_other.compressed_buf, nullptr);
+  EXPECT_EQ(memfile_a.size, chunk_size + stored_other.compressed_size);
+
+  /* The second memfile carries the size of the data it shares with the first one, data that is
+   * only used by the first memfile is freed. */
+  BLO_memfile_merge(&memfile_a, &memfile_b);
+  EXPECT_EQ(memfile_a.size, size_t(0));
+  EXPECT_EQ(memfile_b.size, chunk_size);
+  EXPECT_TRUE(is_stored(key));
+  EXPECT_FALSE(is_stored(key_other));
+  const MemFileStoredChunk &stored = *memfile_chunks(memfile_b)[0]->stored_chunk;
+  EXPECT_EQ(stored.owner, &memfile_b);
+  EXPECT_EQ(stored.raw_users, 1);
+
+  EXPECT_EQ(read_memfile(memfile_b, chunk_size), buffer);
+  BLO_memfile_free(&memfile_b);
+  EXPECT_FALSE(is_stored(key));
+}
+
+TEST_F(MemFileUndoTest, DuplicatedChunkIsStoredOnce)
+{
+  const Vector<char> buffer = create_buffer(0);
+  const Vector<char> buffer_other = create_buffer(1);
+  MemFile memfile_a = {};
+  write_memfile(memfile_a, nullptr, {&buffer, &buffer_other, &buffer});
+  const Vector<MemFileChunk *> chunks_a = memfile_chunks(memfile_a);
+  ASSERT_TRUE(chunks_a[0]->is_content_addressed);
+  EXPECT_EQ(chunks_a[0]->stored_chunk, chunks_a[2]->stored_chunk);
+  EXPECT_NE(chunks_a[0]->stored_chunk, chunks_a[1]->stored_chunk);
+  EXPECT_EQ(chunks_a[0]->stored_chunk->users_by_memfile.lookup(&memfile_a), 2);
+  EXPECT_EQ(memfile_a.size, chunk_size * 2);
+
+  /* Moved data does not match the chunk at the same position in the previous step, but is found
+   * in the storage. */
+  MemFile memfile_b = {};
+  write_memfile(memfile_b, &memfile_a, {&buffer_other, &buffer});
+  const Vector<MemFileChunk *> chunks_b = memfile_chunks(memfile_b);
+  EXPECT_FALSE(chunks_b[0]->is_identical);
+  EXPECT_FALSE(chunks_b[1]->is_identical);
+  EXPECT_EQ(chunks_b[0]->stored_chunk, chunks_a[1]->stored_chunk);
+  EXPECT_EQ(chunks_b[1]->stored_chunk, chunks_a[0]->stored_chunk);
+  EXPECT_EQ(chunks_b[1]->buf, chunks_a[0]->buf);
+  EXPECT_EQ(memfile_b.size, size_t(0));
+
+  Vector<char> expected = buffer_other;
+  expected.extend(buffer);
+  EXPECT_EQ(read_memfile(memfile_b, chunk_size * 2), expected);
+
+  BLO_memfile_free(&memfile_a);
+  EXPECT_EQ(memfile_b.size, chunk_size * 2);
+  BLO_memfile_free(&memfile_b);
+}
+
+TEST_F(MemFileUndoTest, StoredChunkHashCollision)
+{
+  const Vector<char> buffer = create_buffer(0);
+  const Vector<char> buffer_other = create_buffer(1);
+
+  /* Store other data with the key of the buffer. */
+  const MemFileChunkContentKey key = memfile_chunk_content_key(buffer.data(), chunk_size);
+  MemFile memfile_other = {};
+  MemFileStoredChunk *stored_other = MEM_new<MemFileStoredChunk>(__func__);
+  char *buf_other = MEM_new_array_uninitialized<char>(chunk_size, __func__);
+  memcpy(buf_other, buffer_other.data(), chunk_size);
+  stored_other->key = key;
+  stored_other->buf = buf_other;
+  stored_other->users_by_memfile.add_new(&memfile_other, 1);
+  stored_other->raw_users = 1;
+  stored_other->owner = &memfile_other;
+  MemFileChunkStorage &storage = memfile_chunk_storage();
+  storage.chunk_by_content.add_new(key, stored_other);
+
+  /* The chunk gets its own copy of the data instead. */
+  MemFile memfile = {};
+  write_memfile(memfile, nullptr, {&buffer});
+  const MemFileChunk &chunk = *memfile_chunks(memfile)[0];
+  EXPECT_FALSE(chunk.is_content_addressed);
+  EXPECT_EQ(chunk.stored_chunk, nullptr);
+  EXPECT_NE(chunk.buf, buf_other);
+  EXPECT_EQ(memfile.size, chunk_size);
+  EXPECT_EQ(read_memfile(memfile, chunk_size), buffer);
+  EXPECT_EQ(stored_other->users_by_memfile.size(), 1);
+  EXPECT_EQ(memcmp(stored_other->buf, buffer_other.data(), chunk_size), 0);
+  BLO_memfile_free(&memfile);
+
+  storage.chunk_by_content.remove(key);
+  MEM_delete(stored_other->buf);
+  MEM_delete(stored_other);
+}
+
+TEST_F(MemFileUndoTest, StoredChunkFreedWithLastUser)
+{
+  const Vector<char> buffer = create_buffer(0);
+  MemFile memfile_a = {};
+  MemFile memfile_b = {};
+  MemFile memfile_c = {};
+  write_memfile(memfile_a, nullptr, {&buffer});
+  write_memfile(memfile_b, &memfile_a, {&buffer});
+  write_memfile(memfile_c, &memfile_b, {&buffer});
+  const MemFileChunkContentKey key = memfile_chunks(memfile_a)[0]->stored_chunk->key;
+
+  BLO_memfile_merge(&memfile_a, &memfile_b);
+  EXPECT_TRUE(is_stored(key));
+  BLO_memfile_merge(&memfile_b, &memfile_c);
+  EXPECT_TRUE(is_stored(key));
+  EXPECT_EQ(memfile_c.size, chunk_size);
+  BLO_memfile_free(&memfile_c);
+  EXPECT_FALSE(is_stored(key));
+}
+
+}  // namespace blender::tests
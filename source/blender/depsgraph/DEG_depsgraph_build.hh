@@ -72,6 +72,15 @@ void DEG_graph_relations_update(Depsgraph *graph);
 /** Tag all relations in the database for update. */
 void DEG_relations_tag_update(Main *bmain);
 
+/**
+ * Tag relations of the given ID for update in all graphs of the database.
+ *
+ * With the incremental relations update enabled in the experimental preferences, graphs only
+ * build again the nodes and relations of the tagged objects when possible. Otherwise this is the
+ * same as #DEG_relations_tag_update().
+ */
+void DEG_id_tag_relations_update(Main *bmain, ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /**
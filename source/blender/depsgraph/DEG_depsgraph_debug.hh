@@ -55,6 +55,20 @@ void DEG_debug_stats_gnuplot(const Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Tracing */
+
+/**
+ * Record the start and end time, thread and name of every operation evaluated by any dependency
+ * graph, until #DEG_debug_trace_end() writes them to the given file.
+ *
+ * The file uses the Chrome trace-event JSON format, which can be opened in Perfetto.
+ */
+void DEG_debug_trace_begin(const char *filepath);
+
+/** Write the trace started by #DEG_debug_trace_begin(), does nothing if tracing is not enabled. */
+void DEG_debug_trace_end();
+
 /* ************************************************ */
 
 /** Compare two dependency graphs. */
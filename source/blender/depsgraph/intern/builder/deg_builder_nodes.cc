@@ -149,22 +149,20 @@ IDNode *DepsgraphNodeBuilder::add_id_node(ID *id)
   const ID_Type id_type = GS(id->name);
   IDNode *id_node = nullptr;
   ID *id_cow = nullptr;
-  IDComponentsMask previously_visible_components_mask = 0;
-  uint32_t previous_eval_flags = 0;
-  DEGCustomDataMeshMasks previous_customdata_masks;
   IDInfo *id_info = id_info_hash_.lookup_ptr(id->session_uid);
   if (id_info != nullptr) {
     id_cow = id_info->id_cow;
-    previously_visible_components_mask = id_info->previously_visible_components_mask;
-    previous_eval_flags = id_info->previous_eval_flags;
-    previous_customdata_masks = id_info->previous_customdata_masks;
     /* Tag ID info to not free the evaluated ID pointer. */
     id_info->id_cow = nullptr;
   }
   id_node = graph_->add_id_node(id, id_cow);
-  id_node->previously_visible_components_mask = previously_visible_components_mask;
-  id_node->previous_eval_flags = previous_eval_flags;
-  id_node->previous_customdata_masks = previous_customdata_masks;
+  /* NOTE: Nodes without ID info keep their state, which is the default state of a new node, or
+   * the state of a node which is kept by the incremental relations update. */
+  if (id_info != nullptr) {
+    id_node->previously_visible_components_mask = id_info->previously_visible_components_mask;
+    id_node->previous_eval_flags = id_info->previous_eval_flags;
+    id_node->previous_customdata_masks = id_info->previous_customdata_masks;
+  }
 
   /* NOTE: Zero number of components indicates that ID node was just created. */
   const bool is_newly_created = id_node->components.is_empty();
@@ -413,6 +411,57 @@ void DepsgraphNodeBuilder::begin_build()
   graph_->entry_tags.clear();
 }
 
+void DepsgraphNodeBuilder::begin_incremental_build(Span<IDNode *> id_nodes_to_rebuild)
+{
+  Set<const IDNode *> rebuild_set;
+  for (IDNode *id_node : id_nodes_to_rebuild) {
+    rebuild_set.add(id_node);
+  }
+
+  /* Nodes which are kept only compare evaluation flags and masks with the ones they had before
+   * this update, so that only additions done by the re-built IDs lead to an update. */
+  for (IDNode *id_node : graph_->id_nodes) {
+    if (rebuild_set.contains(id_node)) {
+      continue;
+    }
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+    built_map_.tag_built(id_node->id_orig);
+  }
+
+  for (IDNode *id_node : id_nodes_to_rebuild) {
+    /* Same as in #begin_build(), but only for the nodes which are removed. */
+    IDInfo id_info{};
+    if (deg_eval_copy_is_needed(id_node->id_type) && id_node->id_orig != id_node->id_cow) {
+      if (deg_eval_copy_is_expanded(id_node->id_cow)) {
+        id_info.id_cow = id_node->id_cow;
+      }
+      else {
+        MEM_SAFE_DELETE(id_node->id_cow);
+      }
+    }
+    id_info.previously_visible_components_mask = id_node->visible_components_mask;
+    id_info.previous_eval_flags = id_node->eval_flags;
+    id_info.previous_customdata_masks = id_node->customdata_masks;
+    id_info_hash_.add_new(id_node->id_orig_session_uid, std::move(id_info));
+    id_node->id_cow = nullptr;
+
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        if (graph_->entry_tags.contains(op_node)) {
+          saved_entry_tags_.append_as(op_node);
+        }
+        if (op_node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
+          needs_update_operations_.append_as(op_node);
+        }
+      }
+    }
+
+    incremental_ids_.append(id_node->id_orig);
+    graph_->remove_id_node(id_node);
+  }
+}
+
 /* Utility callbacks for `BKE_library_foreach_ID_link`, used to detect when an evaluated ID is
  * using ID pointers that are either:
  *  - evaluated ID pointers that do not exist anymore in current depsgraph.
@@ -489,44 +538,49 @@ void DepsgraphNodeBuilder::update_invalid_cow_pointers()
    * code), but cannot really be avoided currently. */
 
   for (const IDNode *id_node : graph_->id_nodes) {
-    if (ELEM(id_node->id_cow, id_node->id_orig, nullptr)) {
-      /* Node/ID with no copy-on-eval data, no need to check it. */
-      continue;
-    }
-    if (!deg_eval_copy_is_expanded(id_node->id_cow)) {
-      /* Copy-on-eval data is not expanded yet, so this is a newly added node/ID that has not been
-       * evaluated yet. */
-      continue;
-    }
-    if ((id_node->id_cow->recalc & ID_RECALC_SYNC_TO_EVAL) != 0) {
-      /* Node/ID already tagged for copy-on-eval flush, no need to check it. */
-      continue;
-    }
-    if ((id_node->id_cow->flag & ID_FLAG_EMBEDDED_DATA) != 0) {
-      /* For now, we assume embedded data are managed by their owner IDs and do not need to be
-       * checked here.
-       *
-       * NOTE: This exception somewhat weak, and ideally should not be needed. Currently however,
-       * embedded data are handled as full local (private) data of their owner IDs in part of
-       * Blender (like read/write code, including undo/redo), while depsgraph generally treat them
-       * as regular independent IDs. This leads to inconsistencies that can lead to bad level
-       * memory accesses.
-       *
-       * E.g. when undoing creation/deletion of a collection directly child of a scene's master
-       * collection, the scene itself is re-read in place, but its master collection becomes a
-       * completely new different pointer, and the existing copy-on-eval of the old master
-       * collection in the matching deg node is therefore pointing to fully invalid (freed) memory.
-       */
-      continue;
-    }
-    BKE_library_foreach_ID_link(nullptr,
-                                id_node->id_cow,
-                                deg::foreach_id_cow_detect_need_for_update_callback,
-                                this,
-                                IDWALK_IGNORE_EMBEDDED_ID | IDWALK_READONLY);
+    update_invalid_cow_pointers(id_node);
   }
 }
 
+void DepsgraphNodeBuilder::update_invalid_cow_pointers(const IDNode *id_node)
+{
+  if (ELEM(id_node->id_cow, id_node->id_orig, nullptr)) {
+    /* Node/ID with no copy-on-eval data, no need to check it. */
+    return;
+  }
+  if (!deg_eval_copy_is_expanded(id_node->id_cow)) {
+    /* Copy-on-eval data is not expanded yet, so this is a newly added node/ID that has not been
+     * evaluated yet. */
+    return;
+  }
+  if ((id_node->id_cow->recalc & ID_RECALC_SYNC_TO_EVAL) != 0) {
+    /* Node/ID already tagged for copy-on-eval flush, no need to check it. */
+    return;
+  }
+  if ((id_node->id_cow->flag & ID_FLAG_EMBEDDED_DATA) != 0) {
+    /* For now, we assume embedded data are managed by their owner IDs and do not need to be
+     * checked here.
+     *
+     * NOTE: This exception somewhat weak, and ideally should not be needed. Currently however,
+     * embedded data are handled as full local (private) data of their owner IDs in part of
+     * Blender (like read/write code, including undo/redo), while depsgraph generally treat them
+     * as regular independent IDs. This leads to inconsistencies that can lead to bad level
+     * memory accesses.
+     *
+     * E.g. when undoing creation/deletion of a collection directly child of a scene's master
+     * collection, the scene itself is re-read in place, but its master collection becomes a
+     * completely new different pointer, and the existing copy-on-eval of the old master
+     * collection in the matching deg node is therefore pointing to fully invalid (freed) memory.
+     */
+    return;
+  }
+  BKE_library_foreach_ID_link(nullptr,
+                              id_node->id_cow,
+                              deg::foreach_id_cow_detect_need_for_update_callback,
+                              this,
+                              IDWALK_IGNORE_EMBEDDED_ID | IDWALK_READONLY);
+}
+
 void DepsgraphNodeBuilder::tag_previously_tagged_nodes()
 {
   for (const OperationKey &operation_key : saved_entry_tags_) {
@@ -558,6 +612,18 @@ void DepsgraphNodeBuilder::end_build()
   update_invalid_cow_pointers();
 }
 
+void DepsgraphNodeBuilder::end_incremental_build()
+{
+  /* Light linking is not supported by the incremental update, so the cache is left as-is. */
+  tag_previously_tagged_nodes();
+  /* Only the re-built IDs can use evaluated copies which were not in the graph before. */
+  for (ID *id : incremental_ids_) {
+    if (const IDNode *id_node = find_id_node(id)) {
+      update_invalid_cow_pointers(id_node);
+    }
+  }
+}
+
 void DepsgraphNodeBuilder::build_id(ID *id, const bool force_be_visible)
 {
   if (id == nullptr) {
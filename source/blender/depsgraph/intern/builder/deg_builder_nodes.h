@@ -11,6 +11,7 @@
 #include "BKE_lib_query.hh" /* For LibraryForeachIDCallbackFlag enum. */
 
 #include "BLI_set.hh"
+#include "BLI_span.hh"
 
 #include "DNA_armature_types.h"
 #include "DNA_listBase.h"
@@ -97,6 +98,14 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void begin_build();
   virtual void end_build();
 
+  /**
+   * Counterpart of #begin_build() for the incremental relations update: only the nodes of the
+   * given IDs are removed from the graph to be built again. All other IDs are kept as-is and are
+   * considered to be built already.
+   */
+  virtual void begin_incremental_build(Span<IDNode *> id_nodes_to_rebuild);
+  virtual void end_incremental_build();
+
   /**
    * `id_cow_self` is the user of `id_pointer`,
    * see also `LibraryIDLinkCallbackData` struct definition.
@@ -184,6 +193,12 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void build_view_layer(Scene *scene,
                                 ViewLayer *view_layer,
                                 eDepsNode_LinkedState_Type linked_state);
+  /* Build an object of the view layer on its own, as if it was built from its base. */
+  virtual void build_view_layer_object(Scene *scene,
+                                       ViewLayer *view_layer,
+                                       Object *object,
+                                       eDepsNode_LinkedState_Type linked_state,
+                                       bool is_visible);
   virtual void build_collection(LayerCollection *from_layer_collection, Collection *collection);
   virtual void build_object(int base_index,
                             Object *object,
@@ -336,6 +351,7 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
    * because the depsgraph itself created or removed some of their evaluated dependencies.
    */
   void update_invalid_cow_pointers();
+  void update_invalid_cow_pointers(const IDNode *id_node);
 
   /* State which demotes currently built entities. */
   Scene *scene_;
@@ -354,6 +370,9 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   /* Set of IDs which were already build. Makes it easier to keep track of
    * what was already built and what was not. */
   BuilderMap built_map_;
+
+  /* IDs whose nodes are built again by the incremental relations update. */
+  Vector<ID *> incremental_ids_;
 };
 
 }  // namespace deg
@@ -167,4 +167,35 @@ void DepsgraphNodeBuilder::build_view_layer(Scene *scene,
   }
 }
 
+void DepsgraphNodeBuilder::build_view_layer_object(Scene *scene,
+                                                   ViewLayer *view_layer,
+                                                   Object *object,
+                                                   eDepsNode_LinkedState_Type linked_state,
+                                                   bool is_visible)
+{
+  /* Same state as set up by #build_view_layer(). */
+  view_layer_index_ = 0;
+  scene_ = scene;
+  view_layer_ = view_layer;
+  /* The base index needs to match the one the object gets when the whole view layer is built. */
+  int base_index = 0;
+  int object_base_index = -1;
+  BKE_view_layer_synced_ensure(*bmain_, scene, view_layer);
+  for (Base &base : *BKE_view_layer_object_bases_get(view_layer)) {
+    if (!need_pull_base_into_graph(&base)) {
+      continue;
+    }
+    if (base.object == object) {
+      object_base_index = base_index;
+      break;
+    }
+    base_index++;
+  }
+  BLI_assert(object_base_index != -1);
+  build_object(object_base_index, object, linked_state, is_visible);
+  if (!graph_->has_animated_visibility) {
+    graph_->has_animated_visibility |= is_object_visibility_animated(object);
+  }
+}
+
 }  // namespace blender::deg
@@ -243,7 +243,10 @@ bool object_have_geometry_component(const Object *object)
 DepsgraphRelationBuilder::DepsgraphRelationBuilder(Main *bmain,
                                                    Depsgraph *graph,
                                                    DepsgraphBuilderCache *cache)
-    : DepsgraphBuilder(bmain, graph, cache), scene_(nullptr), rna_node_query_(graph, this)
+    : DepsgraphBuilder(bmain, graph, cache),
+      scene_(nullptr),
+      relation_flags_(0),
+      rna_node_query_(graph, this)
 {
 }
 
@@ -372,7 +375,7 @@ Relation *DepsgraphRelationBuilder::add_time_relation(TimeSourceNode *timesrc,
                                                       int flags)
 {
   if (timesrc && node_to) {
-    return graph_->add_new_relation(timesrc, node_to, description, flags);
+    return graph_->add_new_relation(timesrc, node_to, description, flags | relation_flags_);
   }
 
   DEG_DEBUG_PRINTF((blender::Depsgraph *)graph_,
@@ -400,7 +403,7 @@ Relation *DepsgraphRelationBuilder::add_operation_relation(OperationNode *node_f
                                                            int flags)
 {
   if (node_from && node_to) {
-    return graph_->add_new_relation(node_from, node_to, description, flags);
+    return graph_->add_new_relation(node_from, node_to, description, flags | relation_flags_);
   }
 
   DEG_DEBUG_PRINTF((blender::Depsgraph *)graph_,
@@ -515,6 +518,19 @@ Depsgraph *DepsgraphRelationBuilder::getGraph()
 
 void DepsgraphRelationBuilder::begin_build() {}
 
+void DepsgraphRelationBuilder::begin_incremental_build(const Set<const ID *> &ids_to_rebuild)
+{
+  for (IDNode *id_node : graph_->id_nodes) {
+    if (!ids_to_rebuild.contains(id_node->id_orig)) {
+      built_map_.tag_built(id_node->id_orig,
+                           BuilderMap::TAG_COMPLETE |
+                               BuilderMap::TAG_COLLECTION_CHILDREN_HIERARCHY);
+    }
+  }
+  /* Builders of the kept IDs re-create relations which are still in the graph. */
+  relation_flags_ |= RELATION_CHECK_BEFORE_ADD;
+}
+
 void DepsgraphRelationBuilder::build_id(ID *id)
 {
   if (id == nullptr) {
@@ -3713,16 +3729,18 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
      * copy of ID. */
     OperationNode *op_entry = comp_node->get_entry_operation();
     if (op_entry != nullptr) {
-      Relation *rel = graph_->add_new_relation(op_cow, op_entry, "Copy-on-Eval Dependency");
+      Relation *rel = graph_->add_new_relation(
+          op_cow, op_entry, "Copy-on-Eval Dependency", relation_flags_);
       rel->flag |= rel_flag;
     }
     /* All dangling operations should also be executed after copy-on-evaluation. */
-    for (OperationNode *op_node : comp_node->operations_map->values()) {
+    auto add_dangling_operation_relation = [&](OperationNode *op_node) {
       if (op_node == op_entry) {
-        continue;
+        return;
       }
       if (op_node->inlinks.is_empty()) {
-        Relation *rel = graph_->add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
+        Relation *rel = graph_->add_new_relation(
+            op_cow, op_node, "Copy-on-Eval Dependency", relation_flags_);
         rel->flag |= rel_flag;
       }
       else {
@@ -3738,10 +3756,22 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
           }
         }
         if (!has_same_comp_dependency) {
-          Relation *rel = graph_->add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
+          Relation *rel = graph_->add_new_relation(
+              op_cow, op_node, "Copy-on-Eval Dependency", relation_flags_);
           rel->flag |= rel_flag;
         }
       }
+    };
+    if (comp_node->operations_map != nullptr) {
+      for (OperationNode *op_node : comp_node->operations_map->values()) {
+        add_dangling_operation_relation(op_node);
+      }
+    }
+    else {
+      /* Component of an existing graph which got operations by the incremental update. */
+      for (OperationNode *op_node : comp_node->operations) {
+        add_dangling_operation_relation(op_node);
+      }
     }
     /* NOTE: We currently ignore implicit relations to an external
      * data-blocks for copy-on-evaluation operations. This means, for example,
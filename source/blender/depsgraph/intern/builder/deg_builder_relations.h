@@ -86,6 +86,12 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   DepsgraphRelationBuilder(Main *bmain, Depsgraph *graph, DepsgraphBuilderCache *cache);
 
   void begin_build();
+  /**
+   * Counterpart of #begin_build() for the incremental relations update: all IDs of the graph
+   * apart from the given ones are considered to be built, and relations which already exist in
+   * the graph are not added again.
+   */
+  void begin_incremental_build(const Set<const ID *> &ids_to_rebuild);
 
   template<typename KeyFrom, typename KeyTo>
   Relation *add_relation(const KeyFrom &key_from,
@@ -146,6 +152,11 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   virtual void build_collection(LayerCollection *from_layer_collection, Collection *collection);
   virtual void build_object(Object *object);
   virtual void build_object_from_view_layer_base(Object *object);
+  /* Relations of an object built by #DepsgraphNodeBuilder::build_view_layer_object(). */
+  virtual void build_view_layer_object(Scene *scene, Object *object);
+  /* Re-create relations which an ID that is kept in the graph had with objects whose nodes were
+   * re-created by the incremental relations update. */
+  virtual void build_id_relations_with_objects(ID *id, Span<Object *> objects);
   virtual void build_object_layer_component_relations(Object *object);
   virtual void build_object_modifiers(Object *object);
   virtual void build_object_data(Object *object);
@@ -348,6 +359,9 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   /* State which demotes currently built entities. */
   Scene *scene_;
 
+  /* Flags added to all relations created by the builder. */
+  int relation_flags_;
+
   BuilderMap built_map_;
   RNANodeQuery rna_node_query_;
   BuilderStack stack_;
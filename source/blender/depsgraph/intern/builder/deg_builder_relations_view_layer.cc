@@ -18,6 +18,7 @@
 
 #include "BLI_listbase.hh"
 
+#include "BKE_collection.hh"
 #include "BKE_layer.hh"
 #include "BKE_main.hh"
 #include "BKE_node.hh"
@@ -164,4 +165,48 @@ void DepsgraphRelationBuilder::build_view_layer(Scene *scene,
   }
 }
 
+void DepsgraphRelationBuilder::build_view_layer_object(Scene *scene, Object *object)
+{
+  scene_ = scene;
+  build_object_from_view_layer_base(object);
+}
+
+void DepsgraphRelationBuilder::build_id_relations_with_objects(ID *id, Span<Object *> objects)
+{
+  switch (GS(id->name)) {
+    case ID_SCE:
+      /* The scene is connected to its objects by the view layer relations, which are re-created
+       * by #build_view_layer_object(). */
+      break;
+    case ID_GR: {
+      /* Only re-create the relations with the given objects, building the whole collection again
+       * would check all relations of its objects. Relations match the ones of
+       * #build_collection(). */
+      Collection *collection = id_cast<Collection *>(id);
+      const IDNode *id_node = graph_->find_id_node(id);
+      const ComponentKey collection_hierarchy_key{&collection->id, NodeType::HIERARCHY};
+      const OperationKey collection_geometry_key{
+          &collection->id, NodeType::GEOMETRY, OperationCode::GEOMETRY_EVAL_DONE};
+      for (Object *object : objects) {
+        if (!BKE_collection_has_object(collection, object)) {
+          continue;
+        }
+        const ComponentKey object_hierarchy_key{&object->id, NodeType::HIERARCHY};
+        add_relation(
+            collection_hierarchy_key, object_hierarchy_key, "Collection -> Object hierarchy");
+        if (id_node->is_collection_fully_expanded) {
+          const OperationKey object_instance_geometry_key{
+              &object->id, NodeType::INSTANCING, OperationCode::INSTANCE_GEOMETRY};
+          add_relation(
+              object_instance_geometry_key, collection_geometry_key, "Collection Geometry");
+        }
+      }
+      break;
+    }
+    default:
+      build_id(id);
+      break;
+  }
+}
+
 }  // namespace blender::deg
@@ -88,7 +88,7 @@ void deg_graph_remove_unused_noops(Depsgraph *graph)
 
   /* Remove the relations. */
   for (Relation *relation : relations_to_remove) {
-    relation->unlink();
+    graph->remove_relation(relation);
   }
 
   DEG_DEBUG_PRINTF((blender::Depsgraph *)graph,
@@ -85,7 +85,7 @@ void deg_graph_transitive_reduction(Depsgraph *graph)
       }
     }
     for (Relation *rel : relations_to_remove) {
-      rel->unlink();
+      graph->remove_relation(rel);
     }
     num_removed_relations += relations_to_remove.size();
     relations_to_remove.clear();
@@ -24,7 +24,7 @@ static CLG_LogRef LOG = {"depsgraph"};
 
 namespace deg {
 
-static bool need_sanity_checks()
+bool AbstractBuilderPipeline::need_sanity_checks()
 {
 #if !defined(NDEBUG)
   return true;
@@ -165,6 +165,7 @@ void AbstractBuilderPipeline::build_step_finalize()
 #endif
   /* Relations are up to date. */
   deg_graph_->need_update_relations = false;
+  deg_graph_->relations_update_ids.clear();
 }
 
 std::unique_ptr<DepsgraphNodeBuilder> AbstractBuilderPipeline::construct_node_builder()
@@ -51,10 +51,12 @@ class AbstractBuilderPipeline {
   virtual std::unique_ptr<DepsgraphRelationBuilder> construct_relation_builder();
 
   virtual void build_step_sanity_check();
-  void build_step_nodes();
-  void build_step_relations();
+  virtual void build_step_nodes();
+  virtual void build_step_relations();
   void build_step_finalize();
 
+  static bool need_sanity_checks();
+
   virtual void build_nodes(DepsgraphNodeBuilder &node_builder) = 0;
   virtual void build_relations(DepsgraphRelationBuilder &relation_builder) = 0;
 
@@ -0,0 +1,186 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "pipeline_incremental.h"
+
+#include "BLI_index_range.hh"
+#include "BLI_utildefines.hh"
+
+#include "DNA_layer_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_layer.hh"
+
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node_component.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+IncrementalBuilderPipeline::IncrementalBuilderPipeline(blender::Depsgraph *graph)
+    : AbstractBuilderPipeline(graph)
+{
+  can_build_ = gather_ids_to_rebuild();
+}
+
+bool IncrementalBuilderPipeline::can_build() const
+{
+  return can_build_;
+}
+
+bool IncrementalBuilderPipeline::gather_ids_to_rebuild()
+{
+  if (deg_graph_->relations_update_ids.is_empty()) {
+    return false;
+  }
+  /* Rigid body simulation, physics relations and light linking keep state which is shared by all
+   * objects of the scene, and which is only gathered when the whole graph is built. */
+  if (scene_->rigidbody_world != nullptr || deg_graph_->physics_relations_effector != nullptr ||
+      deg_graph_->light_linking_cache.has_light_linking())
+  {
+    return false;
+  }
+  for (const int i : IndexRange(DEG_PHYSICS_COLLISION_NUM)) {
+    if (deg_graph_->physics_relations_collision[i] != nullptr) {
+      return false;
+    }
+  }
+
+  BKE_view_layer_synced_ensure(*bmain_, scene_, view_layer_);
+  for (ID *id : deg_graph_->relations_update_ids) {
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    /* Objects which are not in the graph yet are added by building the whole graph, which also
+     * takes care of their bases. */
+    if (id_node == nullptr || id_node->id_type != ID_OB) {
+      return false;
+    }
+    if (!id_node->has_base || id_node->linked_state != DEG_ID_LINKED_DIRECTLY) {
+      return false;
+    }
+    Object *object = id_cast<Object *>(id);
+    if (BKE_view_layer_base_find(view_layer_, object) == nullptr) {
+      return false;
+    }
+    /* Cameras and speakers get nodes and relations from the scene, and light linking is gathered
+     * for the whole scene. */
+    if (ELEM(object->type, OB_CAMERA, OB_SPEAKER) || object->light_linking != nullptr) {
+      return false;
+    }
+    objects_.append({object, id_node->linked_state, id_node->is_visible_on_build});
+    object_id_nodes_.append(id_node);
+  }
+
+  for (const IDNode *id_node : object_id_nodes_) {
+    for (const ComponentNode *comp_node : id_node->components.values()) {
+      for (const OperationNode *op_node : comp_node->operations) {
+        /* Properties read by drivers of other IDs get their operation from the node builder of
+         * the driver, which is not run again. */
+        if (op_node->opcode == OperationCode::ID_PROPERTY) {
+          return false;
+        }
+        for (const Relation *rel : op_node->inlinks) {
+          if (rel->from->type == NodeType::OPERATION) {
+            neighbor_ids_.add(static_cast<OperationNode *>(rel->from)->owner->owner->id_orig);
+          }
+        }
+        for (const Relation *rel : op_node->outlinks) {
+          if (rel->to->type == NodeType::OPERATION) {
+            neighbor_ids_.add(static_cast<OperationNode *>(rel->to)->owner->owner->id_orig);
+          }
+        }
+      }
+    }
+  }
+  for (const ObjectBuildState &state : objects_) {
+    neighbor_ids_.remove(&state.object->id);
+  }
+  for (ID *id : neighbor_ids_) {
+    const IDNode *id_node = deg_graph_->find_id_node(id);
+    /* Data from set scenes is built with a different scene as context. */
+    if (id_node->linked_state == DEG_ID_LINKED_VIA_SET ||
+        (id_node->id_type == ID_SCE && id != &scene_->id))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void IncrementalBuilderPipeline::build_step_nodes()
+{
+  std::unique_ptr<DepsgraphNodeBuilder> node_builder = construct_node_builder();
+  node_builder->begin_incremental_build(object_id_nodes_);
+  /* The removed nodes are not valid anymore. New nodes and operations are appended to the graph,
+   * which allows to find them afterwards. */
+  object_id_nodes_.clear();
+  const int64_t id_nodes_num = deg_graph_->id_nodes.size();
+  const int64_t operations_num = deg_graph_->operations.size();
+  build_nodes(*node_builder);
+  node_builder->end_incremental_build();
+
+  for (const IDNode *id_node : deg_graph_->id_nodes.as_span().drop_front(id_nodes_num)) {
+    built_ids_.append(id_node->id_orig);
+  }
+  for (const OperationNode *op_node : deg_graph_->operations.as_span().drop_front(operations_num))
+  {
+    updated_id_nodes_.add(op_node->owner->owner);
+  }
+
+  if (need_sanity_checks()) {
+    ids_build_by_node_builder_ = node_builder->get_built_ids();
+  }
+}
+
+void IncrementalBuilderPipeline::build_step_relations()
+{
+  /* Collections and the scene are only connected to the objects by a few relations, which are
+   * re-created directly. Other IDs are built again, skipping the relations they still have. */
+  Set<const ID *> ids_to_rebuild;
+  for (const ID *id : built_ids_) {
+    ids_to_rebuild.add(id);
+  }
+  for (const ID *id : neighbor_ids_) {
+    if (!ELEM(GS(id->name), ID_SCE, ID_GR)) {
+      ids_to_rebuild.add(id);
+    }
+  }
+
+  std::unique_ptr<DepsgraphRelationBuilder> relation_builder = construct_relation_builder();
+  relation_builder->begin_incremental_build(ids_to_rebuild);
+  build_relations(*relation_builder);
+  for (IDNode *id_node : updated_id_nodes_) {
+    relation_builder->build_copy_on_write_relations(id_node);
+    relation_builder->build_driver_relations(id_node);
+  }
+
+  if (need_sanity_checks()) {
+    ids_build_by_relations_builder_ = relation_builder->get_built_ids();
+  }
+}
+
+void IncrementalBuilderPipeline::build_nodes(DepsgraphNodeBuilder &node_builder)
+{
+  for (const ObjectBuildState &state : objects_) {
+    node_builder.build_view_layer_object(
+        scene_, view_layer_, state.object, state.linked_state, state.is_visible);
+  }
+}
+
+void IncrementalBuilderPipeline::build_relations(DepsgraphRelationBuilder &relation_builder)
+{
+  Vector<Object *> objects;
+  for (const ObjectBuildState &state : objects_) {
+    relation_builder.build_view_layer_object(scene_, state.object);
+    objects.append(state.object);
+  }
+  for (ID *id : neighbor_ids_) {
+    relation_builder.build_id_relations_with_objects(id, objects);
+  }
+}
+
+}  // namespace blender::deg
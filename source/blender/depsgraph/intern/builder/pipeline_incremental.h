@@ -0,0 +1,73 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include "BLI_vector.hh"
+#include "BLI_vector_set.hh"
+
+#include "intern/node/deg_node_id.hh"
+
+#include "pipeline.h"
+
+namespace blender {
+
+struct ID;
+struct Object;
+
+namespace deg {
+
+/**
+ * Update of the relations of a view layer graph which only builds again the objects tagged with
+ * #DEG_id_tag_relations_update(), instead of the whole graph.
+ *
+ * The nodes of the tagged objects are removed from the graph and built again. The relations of
+ * the objects are built again, together with the relations of the IDs they were connected to, so
+ * that relations which other IDs had with the objects are restored. Everything else is kept
+ * as-is, and the usual finalization is done on the updated graph.
+ */
+class IncrementalBuilderPipeline : public AbstractBuilderPipeline {
+ public:
+  IncrementalBuilderPipeline(blender::Depsgraph *graph);
+
+  /**
+   * Whether the relations can be updated incrementally. When false, the graph is left untouched
+   * and needs to be built again from scratch.
+   */
+  bool can_build() const;
+
+ protected:
+  void build_step_nodes() override;
+  void build_step_relations() override;
+
+  void build_nodes(DepsgraphNodeBuilder &node_builder) override;
+  void build_relations(DepsgraphRelationBuilder &relation_builder) override;
+
+ private:
+  struct ObjectBuildState {
+    Object *object;
+    eDepsNode_LinkedState_Type linked_state;
+    bool is_visible;
+  };
+
+  bool gather_ids_to_rebuild();
+
+  bool can_build_;
+  /* Objects whose nodes are built again, and their state in the graph before the update. */
+  Vector<ObjectBuildState> objects_;
+  Vector<IDNode *> object_id_nodes_;
+  /* IDs which are kept in the graph, but had relations with the objects. */
+  VectorSet<ID *> neighbor_ids_;
+  /* IDs whose nodes were created by the update. */
+  Vector<ID *> built_ids_;
+  /* Nodes of IDs which got new operations by the update. */
+  VectorSet<IDNode *> updated_id_nodes_;
+};
+
+}  // namespace deg
+}  // namespace blender
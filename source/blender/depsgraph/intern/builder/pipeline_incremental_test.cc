@@ -0,0 +1,182 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include <algorithm>
+
+#include "BLI_listbase.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_collection.hh"
+#include "BKE_gtest_base.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.hh"
+#include "BKE_modifier.hh"
+#include "BKE_object.hh"
+#include "BKE_scene.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+
+#include "DNA_defs.h"
+
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
+
+#include "intern/builder/pipeline_incremental.h"
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node_component.hh"
+#include "intern/node/deg_node_id.hh"
+#include "intern/node/deg_node_operation.hh"
+#include "intern/node/deg_node_time.hh"
+
+#include "testing/testing.h"
+
+namespace blender::deg::tests {
+
+class IncrementalBuilderTest : public bke::BlenderGTestBase {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  Object *ob_mesh = nullptr;
+  Object *ob_child = nullptr;
+  Object *ob_offset = nullptr;
+  UserDef userdef_backup;
+
+  void SetUp() override
+  {
+    userdef_backup = dna::shallow_copy(U);
+    U.flag |= USER_DEVELOPER_UI;
+    U.experimental.use_incremental_depsgraph_relations = 1;
+
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    ob_mesh = add_object(OB_MESH, "Mesh");
+    ob_mesh->data = id_cast<ID *>(BKE_mesh_add(bmain, "Mesh"));
+    ob_child = add_object(OB_EMPTY, "Child");
+    ob_child->parent = ob_mesh;
+    ob_offset = add_object(OB_EMPTY, "Offset");
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain);
+    U = dna::shallow_copy(userdef_backup);
+  }
+
+  Object *add_object(const ObjectType type, const char *name)
+  {
+    Object *ob = BKE_object_add_only_object(bmain, type, name);
+    BKE_collection_object_add(bmain, scene->master_collection, ob);
+    return ob;
+  }
+
+  Depsgraph *build_graph()
+  {
+    blender::Depsgraph *depsgraph = DEG_graph_new(
+        bmain, scene, static_cast<ViewLayer *>(scene->view_layers.first), DAG_EVAL_VIEWPORT);
+    DEG_graph_build_from_view_layer(depsgraph);
+    BKE_scene_graph_update_tagged(depsgraph, bmain);
+    return reinterpret_cast<Depsgraph *>(depsgraph);
+  }
+
+  /** Update the relations of the graph after the relations of the ID have been tagged. */
+  void update_graph(Depsgraph *graph, ID *id, const bool expect_incremental)
+  {
+    DEG_id_tag_relations_update(bmain, id);
+    blender::Depsgraph *depsgraph = reinterpret_cast<blender::Depsgraph *>(graph);
+    EXPECT_EQ(IncrementalBuilderPipeline(depsgraph).can_build(), expect_incremental);
+    DEG_graph_relations_update(depsgraph);
+    BKE_scene_graph_update_tagged(depsgraph, bmain);
+  }
+
+  static std::string node_identifier(const Node *node)
+  {
+    if (node->type == NodeType::OPERATION) {
+      return static_cast<const OperationNode *>(node)->full_identifier();
+    }
+    return node->identifier();
+  }
+
+  /** All relations of the graph in a sorted and readable form. */
+  static Vector<std::string> relations_description(const Depsgraph &graph)
+  {
+    Vector<std::string> result;
+    const auto add_relations = [&](const Node *node) {
+      for (const Relation *rel : node->outlinks) {
+        result.append(node_identifier(rel->from) + " -> " + node_identifier(rel->to) + " (" +
+                      rel->name + ", " + std::to_string(rel->flag) + ")");
+      }
+    };
+    add_relations(graph.time_source);
+    for (const OperationNode *op_node : graph.operations) {
+      add_relations(op_node);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  /** Compare the relations of the graph with the ones of a graph built from scratch. */
+  void expect_relations_as_full_build(const Depsgraph &graph)
+  {
+    Depsgraph *full_graph = build_graph();
+    EXPECT_EQ(relations_description(graph).as_span(),
+              relations_description(*full_graph).as_span());
+    DEG_graph_free(reinterpret_cast<blender::Depsgraph *>(full_graph));
+  }
+};
+
+TEST_F(IncrementalBuilderTest, add_and_remove_modifier)
+{
+  Depsgraph *graph = build_graph();
+
+  ArrayModifierData *amd = reinterpret_cast<ArrayModifierData *>(
+      BKE_modifier_new(eModifierType_Array));
+  amd->offset_type = MOD_ARR_OFF_OBJ;
+  amd->offset_ob = ob_offset;
+  BLI_addtail(&ob_mesh->modifiers, amd);
+  BKE_modifiers_persistent_uid_init(*ob_mesh, amd->modifier);
+  update_graph(graph, &ob_mesh->id, true);
+  expect_relations_as_full_build(*graph);
+
+  BLI_remlink(&ob_mesh->modifiers, amd);
+  BKE_modifier_free(&amd->modifier);
+  update_graph(graph, &ob_mesh->id, true);
+  expect_relations_as_full_build(*graph);
+
+  /* The memory of removed relations is used again, so updates without changes don't need more
+   * memory. */
+  const int64_t unused_relations_num = graph->unused_relations.size();
+  update_graph(graph, &ob_mesh->id, true);
+  EXPECT_EQ(graph->unused_relations.size(), unused_relations_num);
+  expect_relations_as_full_build(*graph);
+
+  DEG_graph_free(reinterpret_cast<blender::Depsgraph *>(graph));
+}
+
+TEST_F(IncrementalBuilderTest, remove_object)
+{
+  Depsgraph *graph = build_graph();
+
+  /* An object which is not in the view layer anymore is removed by building the whole graph. */
+  BKE_collection_object_remove(bmain, scene->master_collection, ob_child, false);
+  update_graph(graph, &ob_child->id, false);
+  EXPECT_EQ(graph->find_id_node(&ob_child->id), nullptr);
+  expect_relations_as_full_build(*graph);
+
+  /* Updating the relations of the former parent doesn't add the removed object again. */
+  update_graph(graph, &ob_mesh->id, true);
+  EXPECT_EQ(graph->find_id_node(&ob_child->id), nullptr);
+  expect_relations_as_full_build(*graph);
+
+  DEG_graph_free(reinterpret_cast<blender::Depsgraph *>(graph));
+}
+
+}  // namespace blender::deg::tests
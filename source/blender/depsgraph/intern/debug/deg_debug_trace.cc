@@ -0,0 +1,244 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_fileops.hh"
+#include "BLI_map.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_threads.hh"
+#include "BLI_time.hh"
+#include "BLI_vector.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_ID.h"
+#include "DNA_layer_types.h"
+
+#include "DEG_depsgraph_debug.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/node/deg_node.hh"
+#include "intern/node/deg_node_component.hh"
+#include "intern/node/deg_node_id.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender {
+
+static CLG_LogRef LOG = {"depsgraph"};
+
+namespace deg {
+namespace {
+
+struct TraceEvent {
+  double start_time;
+  double end_time;
+  uint id_session_uid;
+  float frame;
+  /* Null for evaluations of the whole graph. */
+  const char *component_type;
+  const char *operation;
+  /* Name of the component or operation (bone, modifier, ...), or of the graph when evaluating it.
+   * The nodes might be freed before the trace is written, so the name is copied. */
+  std::string name;
+};
+
+/**
+ * Events recorded by a single thread. Only the owning thread appends to it while the graph is
+ * evaluated, the events of all threads are only read when the trace is written.
+ */
+struct ThreadTrace {
+  int thread_index = 0;
+  bool is_main_thread = false;
+  Vector<TraceEvent> events;
+  /* Names of the IDs referenced by the events, copied once per thread. */
+  Map<uint, std::string> id_names;
+};
+
+struct TraceState {
+  std::string filepath;
+  double start_time;
+  std::atomic<int> threads_num = 0;
+  threading::EnumerableThreadSpecific<ThreadTrace> thread_traces;
+
+  TraceState()
+      : thread_traces([this]() {
+          ThreadTrace thread_trace;
+          thread_trace.thread_index = threads_num.fetch_add(1);
+          thread_trace.is_main_thread = BLI_thread_is_main();
+          return thread_trace;
+        })
+  {
+  }
+};
+
+std::unique_ptr<TraceState> trace_state;
+
+void trace_write_escaped(FILE *file, const StringRef str)
+{
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      fprintf(file, "\\%c", c);
+    }
+    else if (uchar(c) < 0x20) {
+      fprintf(file, "\\u%04x", uint(uchar(c)));
+    }
+    else {
+      fputc(c, file);
+    }
+  }
+}
+
+/* Time stamps are written in microseconds since the start of the trace. */
+double trace_time_us(const double time)
+{
+  return (time - trace_state->start_time) * 1e6;
+}
+
+void trace_write_event(FILE *file, const ThreadTrace &thread_trace, const TraceEvent &event)
+{
+  fprintf(file, "{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"name\":\"", thread_trace.thread_index);
+  if (event.operation == nullptr) {
+    fprintf(file, "Depsgraph ");
+    trace_write_escaped(file, event.name);
+  }
+  else {
+    trace_write_escaped(file, thread_trace.id_names.lookup_default(event.id_session_uid, ""));
+    fprintf(file, " %s", event.operation);
+  }
+  fprintf(file,
+          "\",\"cat\":\"%s\",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%g",
+          event.operation ? event.component_type : "Graph",
+          trace_time_us(event.start_time),
+          (event.end_time - event.start_time) * 1e6,
+          event.frame);
+  if (event.operation != nullptr && !event.name.empty()) {
+    fprintf(file, ",\"name\":\"");
+    trace_write_escaped(file, event.name);
+    fprintf(file, "\"");
+  }
+  fprintf(file, "}}");
+}
+
+bool trace_write(TraceState &state)
+{
+  errno = 0;
+  FILE *file = BLI_fopen(state.filepath.c_str(), "w");
+  if (file == nullptr) {
+    CLOG_ERROR(&LOG,
+               "Failed to write depsgraph trace to '%s': %s",
+               state.filepath.c_str(),
+               errno ? strerror(errno) : "unknown");
+    return false;
+  }
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool is_first = true;
+  for (const ThreadTrace &thread_trace : state.thread_traces) {
+    fprintf(file,
+            "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\","
+            "\"args\":{\"name\":\"%s %d\"}}",
+            is_first ? "" : ",\n",
+            thread_trace.thread_index,
+            thread_trace.is_main_thread ? "Main Thread" : "Thread",
+            thread_trace.thread_index);
+    is_first = false;
+    for (const TraceEvent &event : thread_trace.events) {
+      fprintf(file, ",\n");
+      trace_write_event(file, thread_trace, event);
+    }
+  }
+  fprintf(file, "\n]}\n");
+  fclose(file);
+  return true;
+}
+
+}  // namespace
+
+void trace_begin(const char *filepath)
+{
+  trace_state = std::make_unique<TraceState>();
+  trace_state->filepath = filepath;
+  trace_state->start_time = BLI_time_now_seconds();
+}
+
+void trace_end()
+{
+  if (!trace_state) {
+    return;
+  }
+  if (trace_write(*trace_state)) {
+    CLOG_INFO(&LOG, "Depsgraph trace written to '%s'", trace_state->filepath.c_str());
+  }
+  trace_state.reset();
+}
+
+bool trace_is_enabled()
+{
+  return trace_state != nullptr;
+}
+
+void trace_add_operation(const Depsgraph &graph,
+                         const OperationNode &operation_node,
+                         const double start_time,
+                         const double end_time)
+{
+  const ComponentNode &comp_node = *operation_node.owner;
+  const IDNode &id_node = *comp_node.owner;
+  ThreadTrace &thread_trace = trace_state->thread_traces.local();
+  thread_trace.id_names.lookup_or_add_cb(id_node.id_orig_session_uid, [&]() {
+    /* Skip the ID code, like the user interface does. */
+    return std::string(id_node.id_orig->name + 2);
+  });
+  TraceEvent event;
+  event.start_time = start_time;
+  event.end_time = end_time;
+  event.id_session_uid = id_node.id_orig_session_uid;
+  event.frame = graph.frame;
+  event.component_type = nodeTypeAsString(comp_node.type);
+  event.operation = operationCodeAsString(operation_node.opcode);
+  event.name = operation_node.name.empty() ? comp_node.name : operation_node.name;
+  thread_trace.events.append(std::move(event));
+}
+
+void trace_add_graph_evaluation(const Depsgraph &graph,
+                                const double start_time,
+                                const double end_time)
+{
+  ThreadTrace &thread_trace = trace_state->thread_traces.local();
+  TraceEvent event;
+  event.start_time = start_time;
+  event.end_time = end_time;
+  event.id_session_uid = 0;
+  event.frame = graph.frame;
+  event.component_type = nullptr;
+  event.operation = nullptr;
+  event.name = graph.debug.name.empty() ? std::string(graph.view_layer->name) : graph.debug.name;
+  thread_trace.events.append(std::move(event));
+}
+
+}  // namespace deg
+
+void DEG_debug_trace_begin(const char *filepath)
+{
+  deg::trace_begin(filepath);
+}
+
+void DEG_debug_trace_end()
+{
+  deg::trace_end();
+}
+
+}  // namespace blender
@@ -0,0 +1,39 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Tracing of the dependency graph evaluation, exported as a Chrome trace-event file which can be
+ * opened in Perfetto or `chrome://tracing`.
+ */
+
+#pragma once
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/** Start recording every evaluated operation, to be written to the given file by #trace_end(). */
+void trace_begin(const char *filepath);
+
+/** Write the recorded events to the file given to #trace_begin() and stop recording. */
+void trace_end();
+
+bool trace_is_enabled();
+
+/**
+ * Record the evaluation of an operation on the calling thread. Threads only write to their own
+ * buffer, so this does not need any synchronization with other threads evaluating the graph.
+ */
+void trace_add_operation(const Depsgraph &graph,
+                         const OperationNode &operation_node,
+                         double start_time,
+                         double end_time);
+
+/** Record an evaluation of the whole graph, which groups the operations evaluated by it. */
+void trace_add_graph_evaluation(const Depsgraph &graph, double start_time, double end_time);
+
+}  // namespace blender::deg
@@ -17,6 +17,7 @@
 
 #include "BKE_global.hh"
 #include "BKE_idtype.hh"
+#include "BKE_mesh_eval_share.hh"
 #include "BKE_scene.hh"
 
 #include "DEG_depsgraph.hh"
@@ -124,6 +125,28 @@ IDNode *Depsgraph::add_id_node(ID *id, ID *id_cow_hint)
   return id_node;
 }
 
+void Depsgraph::remove_id_node(IDNode *id_node)
+{
+  for (ComponentNode *comp_node : id_node->components.values()) {
+    BLI_assert(comp_node->operations_map == nullptr);
+    for (OperationNode *op_node : comp_node->operations) {
+      while (!op_node->inlinks.is_empty()) {
+        remove_relation(op_node->inlinks.last());
+      }
+      while (!op_node->outlinks.is_empty()) {
+        remove_relation(op_node->outlinks.last());
+      }
+      entry_tags.remove(op_node);
+    }
+  }
+  operations.remove_if(
+      [&](const OperationNode *op_node) { return op_node->owner->owner == id_node; });
+
+  id_hash.remove(id_node->id_orig);
+  id_nodes.remove(id_nodes.first_index_of(id_node));
+  delete id_node;
+}
+
 template<typename FilterFunc>
 static void clear_id_nodes_conditional(Depsgraph::IDDepsNodes *id_nodes, const FilterFunc &filter)
 {
@@ -196,13 +219,24 @@ Relation *Depsgraph::add_new_relation(Node *from, Node *to, const char *descript
    * either the `inlinks` or `outlinks`. But since so many #Relation structs are allocated, it's
    * probably better for it be a simple type anyway. */
   static_assert(std::is_trivially_destructible_v<Relation>);
-  rel = this->build_allocator.construct<Relation>(from, to, description).release();
+  if (!unused_relations.is_empty()) {
+    rel = new (unused_relations.pop_last()) Relation(from, to, description);
+  }
+  else {
+    rel = this->build_allocator.construct<Relation>(from, to, description).release();
+  }
   from->outlinks.append(rel);
   to->inlinks.append(rel);
   rel->flag |= flags;
   return rel;
 }
 
+void Depsgraph::remove_relation(Relation *rel)
+{
+  rel->unlink();
+  unused_relations.append(rel);
+}
+
 Relation *Depsgraph::check_nodes_connected(const Node *from,
                                            const Node *to,
                                            const char *description)
@@ -241,6 +275,7 @@ void Depsgraph::clear_all_nodes()
   delete time_source;
   time_source = nullptr;
   /* Memory used by the build allocator is now unused. Rebuild it from scratch. */
+  unused_relations.clear();
   std::destroy_at(&this->build_allocator);
   new (&this->build_allocator) LinearAllocator<>();
 }
@@ -311,6 +346,7 @@ void DEG_graph_free(Depsgraph *graph)
   }
   using deg::Depsgraph;
   deg::Depsgraph *deg_depsgraph = reinterpret_cast<deg::Depsgraph *>(graph);
+  bke::mesh_eval_share::remove_depsgraph(*graph);
   deg::unregister_graph(deg_depsgraph);
   delete deg_depsgraph;
 }
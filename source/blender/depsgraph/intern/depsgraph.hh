@@ -60,11 +60,23 @@ struct Depsgraph {
 
   IDNode *find_id_node(const ID *id) const;
   IDNode *add_id_node(ID *id, ID *id_cow_hint = nullptr);
+  /**
+   * Remove the node of a single ID together with all relations to and from its operations.
+   * The caller is responsible for the evaluated copy of the ID, which is freed with the node
+   * unless it has been taken from it.
+   */
+  void remove_id_node(IDNode *id_node);
   void clear_id_nodes();
 
   /** Add new relationship between two nodes. */
   Relation *add_new_relation(Node *from, Node *to, const char *description, int flags = 0);
 
+  /**
+   * Unlink the relation from its nodes. Its memory is kept in #unused_relations, to be used by
+   * the next added relation.
+   */
+  void remove_relation(Relation *rel);
+
   /* Check whether two nodes are connected by relation with given
    * description. Description might be nullptr to check ANY relation between
    * given nodes. */
@@ -85,9 +97,16 @@ struct Depsgraph {
 
   /**
    * Used to decrease the cost of allocating many small structs when building the graph. This is a
-   * viable strategy because the graph is rebuilt from scratch rather than changed in-place.
+   * viable strategy because the graph is mostly rebuilt from scratch rather than changed
+   * in-place.
    */
   LinearAllocator<> build_allocator;
+  /**
+   * Relations from #build_allocator which were removed from the graph with #remove_relation.
+   * Their memory is used for new relations, so that incremental updates of the relations don't
+   * make the allocator grow indefinitely.
+   */
+  Vector<Relation *> unused_relations;
 
   /* <ID : IDNode> mapping from ID blocks to nodes representing these
    * blocks, used for quick lookups. */
@@ -107,6 +126,10 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update_relations;
 
+  /* IDs whose relations were tagged for update with #DEG_id_tag_relations_update(). When the
+   * relations need to be updated and this set is empty, the whole graph is rebuilt. */
+  Set<ID *> relations_update_ids;
+
   /* Indicates whether indirect effect of nodes on a directly visible ones needs to be updated. */
   bool need_update_nodes_visibility;
 
@@ -18,6 +18,7 @@
 #include "DNA_node_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 #include "DNA_vfont_types.h"
 
 #include "BKE_collection.hh"
@@ -34,6 +35,7 @@
 #include "builder/pipeline_compositor.h"
 #include "builder/pipeline_from_collection.h"
 #include "builder/pipeline_from_ids.h"
+#include "builder/pipeline_incremental.h"
 #include "builder/pipeline_render.h"
 #include "builder/pipeline_view_layer.h"
 
@@ -321,6 +323,8 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
   DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations for update.\n", __func__);
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
   deg_graph->need_update_relations = true;
+  /* The whole graph is built again. */
+  deg_graph->relations_update_ids.clear();
 
   /* NOTE: When relations are updated, it's quite possible that we've got new bases in the scene.
    * This means, we need to re-create flat array of bases in view layer. */
@@ -344,6 +348,11 @@ void DEG_graph_relations_update(Depsgraph *graph)
     /* Graph is up to date, nothing to do. */
     return;
   }
+  deg::IncrementalBuilderPipeline incremental_builder(graph);
+  if (incremental_builder.can_build()) {
+    incremental_builder.build();
+    return;
+  }
   DEG_graph_build_from_view_layer(graph);
 }
 
@@ -355,4 +364,25 @@ void DEG_relations_tag_update(Main *bmain)
   }
 }
 
+void DEG_id_tag_relations_update(Main *bmain, ID *id)
+{
+  if (!USER_DEVELOPER_TOOL_TEST(&U, use_incremental_depsgraph_relations)) {
+    DEG_relations_tag_update(bmain);
+    return;
+  }
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    if (depsgraph->need_update_relations && depsgraph->relations_update_ids.is_empty()) {
+      /* The whole graph is already tagged to be built again. */
+      continue;
+    }
+    depsgraph->need_update_relations = true;
+    depsgraph->relations_update_ids.add(id);
+    if (depsgraph->find_id_node(id) != nullptr) {
+      graph_id_tag_update(
+          bmain, depsgraph, id, ID_RECALC_BASE_FLAGS, deg::DEG_UPDATE_SOURCE_RELATIONS);
+    }
+  }
+}
+
 }  // namespace blender
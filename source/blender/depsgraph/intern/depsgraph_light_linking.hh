@@ -248,6 +248,12 @@ class Cache {
   /* Set runtime light linking data on evaluated object. */
   void eval_runtime_data(Object &object_eval) const;
 
+  /* Returns true if there is light linking configuration in the scene. */
+  bool has_light_linking() const
+  {
+    return !light_emitter_data_map_.is_empty() || !shadow_emitter_data_map_.is_empty();
+  }
+
  private:
   /* Add emitter information specific for light and shadow linking. */
   void add_light_linking_emitter(const Scene &scene, const Object &emitter);
@@ -264,12 +270,6 @@ class Cache {
                           const CollectionLightLinking &collection_light_linking,
                           const Object &blocker);
 
-  /* Returns true if there is light linking configuration in the scene. */
-  bool has_light_linking() const
-  {
-    return !light_emitter_data_map_.is_empty() || !shadow_emitter_data_map_.is_empty();
-  }
-
   /* Per-emitter light and shadow linking information. */
   EmitterDataMap light_emitter_data_map_{LIGHT_LINKING_RECEIVER};
   EmitterDataMap shadow_emitter_data_map_{LIGHT_LINKING_BLOCKER};
@@ -29,6 +29,7 @@
 #include "BKE_global.hh"
 #include "BKE_idtype.hh"
 #include "BKE_image.hh"
+#include "BKE_lib_id.hh"
 #include "BKE_lib_override.hh"
 #include "BKE_node.hh"
 #include "BKE_scene.hh"
@@ -692,6 +693,8 @@ void id_tag_update(Main *bmain, ID *id, uint flags, eUpdateSource update_source)
  * Only Image IDs are considered for now, but other IDs could be supported if needed. */
 static void set_id_update_count(ID *id)
 {
+  /* Generic stamp used to detect changes of any ID, see #ID_Runtime::update_stamp. */
+  BKE_id_update_stamp_tag(*id);
   if (GS(id->name) == ID_IM) {
     Image *image = reinterpret_cast<Image *>(id);
     static std::atomic<uint64_t> global_image_update_count = 0;
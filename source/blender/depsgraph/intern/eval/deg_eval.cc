@@ -16,7 +16,9 @@
 #include "BLI_function_ref.hh"
 #include "BLI_gsqueue.hh"
 #include "BLI_task_c.hh"
+#include "BLI_threads.hh"
 #include "BLI_time.hh"
+#include "BLI_vector.hh"
 
 #include "BKE_global.hh"
 
@@ -33,11 +35,13 @@
 
 #include "atomic_ops.h"
 
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/depsgraph.hh"
 #include "intern/depsgraph_relation.hh"
 #include "intern/depsgraph_tag.hh"
 #include "intern/eval/deg_eval_copy_on_write.h"
 #include "intern/eval/deg_eval_flush.h"
+#include "intern/eval/deg_eval_priority.h"
 #include "intern/eval/deg_eval_stats.h"
 #include "intern/eval/deg_eval_visibility.h"
 #include "intern/node/deg_node.hh"
@@ -80,9 +84,15 @@ enum class EvaluationStage {
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  bool do_trace;
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
+  /* Tasks in the pool are not bound to a specific operation: every scheduled operation pushes one
+   * task, which evaluates whichever ready operation has the highest priority at the time it runs.
+   * This way the long chains of operations are started first, and cheap operations fill the
+   * remaining threads. */
+  ReadyQueue ready_queue{BLI_system_thread_count()};
 };
 
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
@@ -91,14 +101,17 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
 
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
+  /* Perform operation. The timing is always needed for the cost estimate used by scheduling. */
+  const double start_time = BLI_time_now_seconds();
+  operation_node->evaluate(depsgraph);
+  const double end_time = BLI_time_now_seconds();
+  const double time = end_time - start_time;
+  operation_node->stats.update_cost_estimate(time);
   if (state->do_stats) {
-    const double start_time = BLI_time_now_seconds();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += BLI_time_now_seconds() - start_time;
+    operation_node->stats.current_time += time;
   }
-  else {
-    operation_node->evaluate(depsgraph);
+  if (state->do_trace) {
+    trace_add_operation(*state->graph, *operation_node, start_time, end_time);
   }
 
   /* Clear the flag early on, allowing partial updates without re-evaluating the same node multiple
@@ -108,18 +121,24 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   operation_node->flag &= ~DEPSOP_FLAG_CLEAR_ON_EVAL;
 }
 
-void deg_task_run_func(TaskPool *pool, void *taskdata)
+void schedule_to_pool(DepsgraphEvalState *state, TaskPool *pool, OperationNode *node)
+{
+  state->ready_queue.push(node);
+  BLI_task_pool_push(pool, deg_task_run_func, nullptr, false, nullptr);
+}
+
+void deg_task_run_func(TaskPool *pool, void * /*taskdata*/)
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = static_cast<DepsgraphEvalState *>(userdata_v);
 
-  /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
+  /* Evaluate the most important ready node, not necessarily the one this task was pushed for. */
+  OperationNode *operation_node = state->ready_queue.pop();
   evaluate_node(state, operation_node);
 
   /* Schedule children. */
   schedule_children(state, operation_node, [&](OperationNode *node) {
-    BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
+    schedule_to_pool(state, pool, node);
   });
 }
 
@@ -186,6 +205,11 @@ void calculate_pending_parents_if_needed(DepsgraphEvalState *state)
   state->need_update_pending_parents = false;
 }
 
+bool is_operation_node_evaluated(const DepsgraphEvalState *state, OperationNode *node)
+{
+  return (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) && check_operation_node_visible(state, node);
+}
+
 void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
 {
   /* Clear tags and other things which needs to be clear. */
@@ -355,10 +379,16 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, [&](OperationNode *node) {
-    BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
-  });
+  if (stage == EvaluationStage::THREADED_EVALUATION) {
+    calculate_critical_path_priorities(state->graph->operations, [&](OperationNode *node) {
+      return is_operation_node_evaluated(state, node);
+    });
+  }
+
+  schedule_graph(state,
+                 [&](OperationNode *node) { schedule_to_pool(state, task_pool, node); });
   BLI_task_pool_work_and_wait(task_pool);
+  BLI_assert(state->ready_queue.is_empty());
 }
 
 /* Evaluate remaining operations of the dependency graph in a single threaded manner. */
@@ -436,6 +466,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   graph->update_count = global_update_count.fetch_add(1) + 1;
 
   graph->debug.begin_graph_evaluation();
+  const double start_time = BLI_time_now_seconds();
 
 #ifdef WITH_PYTHON
   /* Release the GIL so that Python drivers can be evaluated. See #91046. */
@@ -449,6 +480,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = trace_is_enabled();
 
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -503,6 +535,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   if (state.do_stats) {
     deg_eval_stats_aggregate(graph);
   }
+  if (state.do_trace) {
+    trace_add_graph_evaluation(*graph, start_time, BLI_time_now_seconds());
+  }
 
   /* Clear any uncleared tags. */
   deg_graph_clear_tags(graph);
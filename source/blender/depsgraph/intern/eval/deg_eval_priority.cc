@@ -0,0 +1,133 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include "intern/eval/deg_eval_priority.h"
+
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+void calculate_critical_path_priorities(const Span<OperationNode *> operations,
+                                        const FunctionRef<bool(OperationNode *node)> is_evaluated)
+{
+  /* Cost of operations which were never timed, so that the chain length still matters. */
+  const double unknown_cost = 1e-6;
+
+  /* Operations are visited in reverse topological order, with `custom_flags` counting the
+   * children which are not yet visited. */
+  Vector<OperationNode *> stack;
+  for (OperationNode *node : operations) {
+    node->priority = 0.0f;
+    node->custom_flags = 0;
+    if (!is_evaluated(node)) {
+      continue;
+    }
+    for (Relation *rel : node->outlinks) {
+      OperationNode *child = static_cast<OperationNode *>(rel->to);
+      if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 && is_evaluated(child)) {
+        node->custom_flags++;
+      }
+    }
+    if (node->custom_flags == 0) {
+      stack.append(node);
+    }
+  }
+
+  while (!stack.is_empty()) {
+    OperationNode *node = stack.pop_last();
+    float children_priority = 0.0f;
+    for (Relation *rel : node->outlinks) {
+      OperationNode *child = static_cast<OperationNode *>(rel->to);
+      if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 && is_evaluated(child)) {
+        children_priority = std::max(children_priority, child->priority);
+      }
+    }
+    double cost = 0.0;
+    if (!node->is_noop()) {
+      cost = node->stats.cost_estimate > 0.0 ? node->stats.cost_estimate : unknown_cost;
+    }
+    node->priority = children_priority + float(cost);
+
+    for (Relation *rel : node->inlinks) {
+      if (rel->from->type != NodeType::OPERATION || (rel->flag & RELATION_FLAG_CYCLIC)) {
+        continue;
+      }
+      OperationNode *parent = static_cast<OperationNode *>(rel->from);
+      if (!is_evaluated(parent)) {
+        continue;
+      }
+      BLI_assert(parent->custom_flags > 0);
+      if (--parent->custom_flags == 0) {
+        stack.append(parent);
+      }
+    }
+  }
+}
+
+static bool compare_priority(const OperationNode *a, const OperationNode *b)
+{
+  return a->priority < b->priority;
+}
+
+ReadyQueue::ReadyQueue(const int shards_num) : shards_(std::max(shards_num, 1)) {}
+
+void ReadyQueue::push(OperationNode *node)
+{
+  /* Children of an operation are usually pushed by the thread that evaluated it. */
+  const size_t thread_hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+  Shard &shard = shards_[int64_t(thread_hash % size_t(shards_.size()))];
+  std::scoped_lock lock(shard.mutex);
+  shard.heap.append(node);
+  std::push_heap(shard.heap.begin(), shard.heap.end(), compare_priority);
+  shard.top_priority.store(shard.heap.first()->priority, std::memory_order_relaxed);
+}
+
+OperationNode *ReadyQueue::pop()
+{
+  /* Other threads may pop the operation of the chosen shard in the meantime, in which case the
+   * search is repeated. Since there is an operation for every thread popping, this terminates. */
+  while (true) {
+    Shard *best_shard = nullptr;
+    float best_priority = std::numeric_limits<float>::lowest();
+    for (Shard &shard : shards_) {
+      const float priority = shard.top_priority.load(std::memory_order_relaxed);
+      if (priority > best_priority) {
+        best_priority = priority;
+        best_shard = &shard;
+      }
+    }
+    if (best_shard == nullptr) {
+      continue;
+    }
+    std::scoped_lock lock(best_shard->mutex);
+    Vector<OperationNode *> &heap = best_shard->heap;
+    if (heap.is_empty()) {
+      continue;
+    }
+    std::pop_heap(heap.begin(), heap.end(), compare_priority);
+    OperationNode *node = heap.pop_last();
+    best_shard->top_priority.store(heap.is_empty() ? std::numeric_limits<float>::lowest() :
+                                                     heap.first()->priority,
+                                   std::memory_order_relaxed);
+    return node;
+  }
+}
+
+bool ReadyQueue::is_empty() const
+{
+  return std::all_of(shards_.begin(), shards_.end(), [](const Shard &shard) {
+    return shard.heap.is_empty();
+  });
+}
+
+}  // namespace blender::deg
@@ -0,0 +1,61 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Scheduling of operations by their critical path priority.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+
+#include "BLI_array.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_mutex.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+namespace blender::deg {
+
+struct OperationNode;
+
+/* Compute the critical path priority of all operations which are to be evaluated: the estimated
+ * time of the longest chain of operations starting at each of them. Cyclic relations and
+ * operations for which `is_evaluated` is false are ignored. */
+void calculate_critical_path_priorities(Span<OperationNode *> operations,
+                                        FunctionRef<bool(OperationNode *node)> is_evaluated);
+
+/* Operations which are ready to be evaluated, ordered by their critical path priority.
+ *
+ * To avoid all threads contending on a single lock, the operations are spread over shards (one
+ * per thread), each being a heap with its own lock. An operation is pushed to the shard of the
+ * pushing thread, and popped from the shard with the most important operation at that time.
+ * This only orders operations approximately when multiple threads push and pop at the same time,
+ * which is fine since the priorities are estimates anyway. Threads only wait for each other when
+ * they happen to use the same shard. */
+class ReadyQueue {
+ private:
+  struct alignas(64) Shard {
+    Mutex mutex;
+    Vector<OperationNode *> heap;
+    /* Priority of the first operation in the heap, read without locking. */
+    std::atomic<float> top_priority = std::numeric_limits<float>::lowest();
+  };
+  Array<Shard, 0> shards_;
+
+ public:
+  explicit ReadyQueue(int shards_num);
+
+  void push(OperationNode *node);
+  /* Remove the most important operation. There must be at least one operation which is not
+   * popped by another thread at the same time. */
+  OperationNode *pop();
+
+  bool is_empty() const;
+};
+
+}  // namespace blender::deg
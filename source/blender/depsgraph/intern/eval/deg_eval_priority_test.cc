@@ -0,0 +1,197 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "testing/testing.h"
+
+#include <memory>
+
+#include "BLI_array.hh"
+#include "BLI_set.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "intern/depsgraph_relation.hh"
+#include "intern/eval/deg_eval_priority.h"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg::tests {
+
+/** A graph of operations which are not part of a depsgraph, with seeded evaluation costs. */
+class DepsgraphPriorityTest : public testing::Test {
+ protected:
+  Vector<std::unique_ptr<OperationNode>> nodes_;
+  Vector<std::unique_ptr<Relation>> relations_;
+  Set<const OperationNode *> not_evaluated_;
+
+  /* A cost of zero means the operation was never timed, a negative cost makes it a no-op. */
+  OperationNode *add_operation(const char *name, const double cost)
+  {
+    std::unique_ptr<OperationNode> node = std::make_unique<OperationNode>();
+    node->type = NodeType::OPERATION;
+    node->name = name;
+    node->stats.cost_estimate = std::max(cost, 0.0);
+    if (cost >= 0.0) {
+      node->evaluate = [](blender::Depsgraph * /*depsgraph*/) {};
+    }
+    OperationNode *result = node.get();
+    nodes_.append(std::move(node));
+    return result;
+  }
+
+  Relation *add_relation(OperationNode *from, OperationNode *to, const int flag = 0)
+  {
+    std::unique_ptr<Relation> rel = std::make_unique<Relation>(from, to, "Test");
+    rel->flag = flag;
+    from->outlinks.append(rel.get());
+    to->inlinks.append(rel.get());
+    Relation *result = rel.get();
+    relations_.append(std::move(rel));
+    return result;
+  }
+
+  bool is_evaluated(const OperationNode *node) const
+  {
+    return !not_evaluated_.contains(node);
+  }
+
+  Vector<OperationNode *> operations() const
+  {
+    Vector<OperationNode *> result;
+    for (const std::unique_ptr<OperationNode> &node : nodes_) {
+      result.append(node.get());
+    }
+    return result;
+  }
+
+  void calculate_priorities()
+  {
+    calculate_critical_path_priorities(
+        this->operations(), [&](OperationNode *node) { return this->is_evaluated(node); });
+  }
+
+  /* Evaluate the graph on a single thread, in the order the operations are popped from the
+   * queue, the same way the depsgraph schedules them. */
+  Vector<std::string> dispatch_order()
+  {
+    ReadyQueue queue(1);
+    for (OperationNode *node : this->operations()) {
+      node->num_links_pending = 0;
+      for (Relation *rel : node->inlinks) {
+        OperationNode *parent = static_cast<OperationNode *>(rel->from);
+        if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 && this->is_evaluated(parent)) {
+          node->num_links_pending++;
+        }
+      }
+      if (node->num_links_pending == 0 && this->is_evaluated(node)) {
+        queue.push(node);
+      }
+    }
+    Vector<std::string> order;
+    while (!queue.is_empty()) {
+      OperationNode *node = queue.pop();
+      order.append(node->name);
+      for (Relation *rel : node->outlinks) {
+        OperationNode *child = static_cast<OperationNode *>(rel->to);
+        if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 && this->is_evaluated(child)) {
+          if (--child->num_links_pending == 0) {
+            queue.push(child);
+          }
+        }
+      }
+    }
+    return order;
+  }
+};
+
+TEST_F(DepsgraphPriorityTest, CriticalPath)
+{
+  OperationNode *a = add_operation("A", 1.0);
+  OperationNode *b = add_operation("B", 10.0);
+  OperationNode *c = add_operation("C", 1.0);
+  OperationNode *d = add_operation("D", 2.0);
+  OperationNode *noop = add_operation("N", -1.0);
+  OperationNode *e = add_operation("E", 2.0);
+  OperationNode *f = add_operation("F", 5.0);
+  OperationNode *x = add_operation("X", 100.0);
+  OperationNode *g = add_operation("G", 0.0);
+  add_relation(a, b);
+  add_relation(b, c);
+  add_relation(a, e);
+  add_relation(d, noop);
+  add_relation(noop, e);
+  add_relation(f, x);
+  /* Cyclic relations are ignored, otherwise there would be no critical path at all. */
+  add_relation(c, a, RELATION_FLAG_CYCLIC);
+  /* Operations which are not evaluated don't extend the path of their parents. */
+  not_evaluated_.add(x);
+
+  calculate_priorities();
+
+  EXPECT_FLOAT_EQ(c->priority, 1.0f);
+  EXPECT_FLOAT_EQ(b->priority, 11.0f);
+  EXPECT_FLOAT_EQ(a->priority, 12.0f);
+  EXPECT_FLOAT_EQ(e->priority, 2.0f);
+  EXPECT_FLOAT_EQ(noop->priority, 2.0f);
+  EXPECT_FLOAT_EQ(d->priority, 4.0f);
+  EXPECT_FLOAT_EQ(f->priority, 5.0f);
+  EXPECT_FLOAT_EQ(x->priority, 0.0f);
+  /* Operations which were never timed still get a priority, so that long chains of them are
+   * started first. */
+  EXPECT_GT(g->priority, 0.0f);
+  EXPECT_LT(g->priority, c->priority);
+
+  const Vector<std::string> order = dispatch_order();
+  const Vector<std::string> expected_order = {"A", "B", "F", "D", "N", "E", "C", "G"};
+  EXPECT_EQ_SPAN<std::string>(order, expected_order);
+}
+
+TEST_F(DepsgraphPriorityTest, ConcurrentPushPop)
+{
+  constexpr int size = 10000;
+  for (const int i : IndexRange(size)) {
+    OperationNode *node = add_operation("Op", 1.0);
+    node->priority = float(i % 97);
+  }
+  const Vector<OperationNode *> operations = this->operations();
+
+  ReadyQueue queue(4);
+  Array<OperationNode *> popped(size);
+  /* Every task pushes one operation and pops one, like the depsgraph evaluation does. */
+  threading::parallel_for(IndexRange(size), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      queue.push(operations[i]);
+      popped[i] = queue.pop();
+    }
+  });
+  EXPECT_TRUE(queue.is_empty());
+
+  Set<OperationNode *> popped_set;
+  for (OperationNode *node : popped) {
+    EXPECT_TRUE(popped_set.add(node));
+  }
+  EXPECT_EQ(popped_set.size(), size);
+}
+
+TEST_F(DepsgraphPriorityTest, QueueOrder)
+{
+  ReadyQueue queue(3);
+  for (const int i : IndexRange(20)) {
+    OperationNode *node = add_operation("Op", 1.0);
+    node->priority = float((i * 7) % 20);
+    queue.push(node);
+  }
+  /* Without concurrent access, operations are popped strictly by priority. */
+  float last_priority = std::numeric_limits<float>::max();
+  while (!queue.is_empty()) {
+    const OperationNode *node = queue.pop();
+    EXPECT_LE(node->priority, last_priority);
+    last_priority = node->priority;
+  }
+}
+
+}  // namespace blender::deg::tests
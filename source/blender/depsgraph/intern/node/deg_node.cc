@@ -276,6 +276,7 @@ Node::Stats::Stats()
 void Node::Stats::reset()
 {
   current_time = 0.0;
+  cost_estimate = 0.0;
 }
 
 void Node::Stats::reset_current()
@@ -283,6 +284,18 @@ void Node::Stats::reset_current()
   current_time = 0.0;
 }
 
+void Node::Stats::update_cost_estimate(const double time)
+{
+  /* Exponential moving average, so that a single slow evaluation (caches being rebuilt, page
+   * faults, ...) does not dominate the estimate. */
+  if (cost_estimate == 0.0) {
+    cost_estimate = time;
+  }
+  else {
+    cost_estimate += (time - cost_estimate) * 0.25;
+  }
+}
+
 /*******************************************************************************
  * Node itself.
  */
@@ -172,8 +172,13 @@ struct Node {
     /* Reset counters needed for the current graph evaluation, does not
      * touch averaging accumulators. */
     void reset_current();
+    /* Blend the time spent on this node in an evaluation into the cost estimate. */
+    void update_cost_estimate(double time);
     /* Time spent on this node during current graph evaluation. */
     double current_time;
+    /* Smoothed time spent on this node in previous graph evaluations, zero when it was never
+     * timed. Used to start long chains of operations first when scheduling the evaluation. */
+    double cost_estimate;
   };
   /* Relationships between nodes
    * The reason why all depsgraph nodes are descended from this type (apart
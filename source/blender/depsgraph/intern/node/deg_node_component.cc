@@ -135,8 +135,14 @@ OperationNode *ComponentNode::add_operation(const DepsEvalOperationCb &op,
     op_node = static_cast<OperationNode *>(factory->create_node(this->owner->id_orig, "", name));
 
     /* register opnode in this component's operation set */
-    OperationIDKey key(opcode, op_node->name, name_tag);
-    operations_map->add(key, op_node);
+    if (operations_map != nullptr) {
+      OperationIDKey key(opcode, op_node->name, name_tag);
+      operations_map->add(key, op_node);
+    }
+    else {
+      /* Operation added to an existing graph by the incremental relations update. */
+      operations.append(op_node);
+    }
 
     /* Set back-link. */
     op_node->owner = this;
@@ -245,6 +251,10 @@ OperationNode *ComponentNode::get_exit_operation()
 
 void ComponentNode::finalize_build(Depsgraph * /*graph*/)
 {
+  if (operations_map == nullptr) {
+    /* Already finalized, the incremental relations update finalizes the whole graph again. */
+    return;
+  }
   operations.reserve(operations_map->size());
   for (OperationNode *op_node : operations_map->values()) {
     operations.append(op_node);
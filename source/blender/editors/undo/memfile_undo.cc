@@ -87,6 +87,27 @@ static bool memfile_undosys_step_encode(bContext * /*C*/, Main *bmain, UndoStep
   us->data = BKE_memfile_undo_encode(bmain, us_prev ? us_prev->data : nullptr);
   us->step.data_size = us->data->undo_size;
 
+  /* Account for the memory saved by compressing previous steps in the background. Compression
+   * that is still running is accounted for when pushing further steps. Finishing the compression
+   * of a step can change the size of other steps that share stored chunks with it, so all steps
+   * are updated before reading their size. */
+  for (UndoStep *us_iter = static_cast<UndoStep *>(ustack->steps.last); us_iter;
+       us_iter = us_iter->prev)
+  {
+    if (us_iter->type == BKE_UNDOSYS_TYPE_MEMFILE) {
+      BLO_memfile_compress_update(&reinterpret_cast<MemFileUndoStep *>(us_iter)->data->memfile);
+    }
+  }
+  for (UndoStep *us_iter = static_cast<UndoStep *>(ustack->steps.last); us_iter;
+       us_iter = us_iter->prev)
+  {
+    if (us_iter->type == BKE_UNDOSYS_TYPE_MEMFILE) {
+      MemFileUndoData *data = reinterpret_cast<MemFileUndoStep *>(us_iter)->data;
+      data->undo_size = data->memfile.size;
+      us_iter->data_size = data->undo_size;
+    }
+  }
+
   /* Store the fact that we should not re-use old data with that undo step, and reset the Main
    * flag. */
   us->step.use_old_bmain_data = !bmain->use_memfile_full_barrier;
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "BLI_array.hh"
 
 namespace blender::fn::lazy_function::generic_graph_executor {
@@ -20,6 +23,12 @@ struct PreprocessData {
   int loaded_inputs_array_offset;
   Array<int> node_states_offsets;
   int total_size;
+  /**
+   * Running estimate of how long the execution of every node takes in nanoseconds, indexed by
+   * #Node::index_in_graph. It is updated by every evaluation of the graph and used to decide which
+   * nodes are worth running on other threads. Zero means that the node has not been executed yet.
+   */
+  std::unique_ptr<std::atomic<uint32_t>[]> node_costs_ns;
 };
 
 }  // namespace blender::fn::lazy_function::generic_graph_executor
@@ -12,7 +12,13 @@
 
 namespace blender::fn::multi_function {
 
-/** A multi-function that executes a procedure internally. */
+class ValueAllocator;
+
+/**
+ * A multi-function that executes a procedure internally. Large masks are split into small chunks
+ * that are passed through the entire procedure one after another, so that intermediate values
+ * stay in the CPU cache.
+ */
 class ProcedureExecutor : public MultiFunction {
  private:
   Signature signature_;
@@ -24,6 +30,11 @@ class ProcedureExecutor : public MultiFunction {
   void call(const IndexMask &mask, Params params, Context context) const override;
 
  private:
+  void execute(const IndexMask &full_mask,
+               Params params,
+               Context context,
+               ValueAllocator &value_allocator) const;
+
   ExecutionHints get_execution_hints() const override;
 };
 
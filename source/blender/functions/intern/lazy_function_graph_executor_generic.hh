@@ -20,6 +20,12 @@
  * TBB schedules tasks helps with that: a thread will next process the task that it added to a task
  * pool just before.
  *
+ * The executor measures how long the execution of every node takes and keeps a running estimate
+ * that persists across evaluations of the same graph. Scheduled nodes are only handed over to other
+ * threads when there is enough estimated work to amortize the threading overhead. Then they are
+ * split into groups of about equal cost, so that cheap nodes are batched together on the current
+ * thread while expensive independent branches can be stolen by other threads.
+ *
  * Communication between threads is synchronized by using a mutex in every node. When a thread
  * wants to access the state of a node, its mutex has to be locked first (with some documented
  * exceptions). The assumption here is that most nodes are only ever touched by a single thread and
@@ -43,7 +49,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <limits>
 
 #include "BLI_enumerable_thread_specific.hh"
 #include "BLI_function_ref.hh"
@@ -51,6 +59,7 @@
 #include "BLI_stack.hh"
 #include "BLI_task.hh"
 #include "BLI_task_c.hh"
+#include "BLI_timeit.hh"
 
 #include "FN_lazy_function_graph_executor.hh"
 #include "FN_lazy_function_graph_executor_generic.hh"
@@ -222,30 +231,39 @@ class GraphExecutorLFParams;
  */
 struct ScheduledNodes {
  private:
+  struct ScheduledNode {
+    const FunctionNode *node;
+    /** Estimated execution time of the node when it was scheduled. */
+    uint32_t cost_ns;
+  };
+
   /** Use two stacks of scheduled nodes for different priorities. */
-  Vector<const FunctionNode *> priority_;
-  Vector<const FunctionNode *> normal_;
+  Vector<ScheduledNode> priority_;
+  Vector<ScheduledNode> normal_;
+  /** Sum of the estimated costs of all scheduled nodes. */
+  uint64_t cost_ns_ = 0;
 
  public:
-  void schedule(const FunctionNode &node, const bool is_priority)
+  void schedule(const FunctionNode &node, const bool is_priority, const uint32_t cost_ns)
   {
     if (is_priority) {
-      this->priority_.append(&node);
+      this->priority_.append({&node, cost_ns});
     }
     else {
-      this->normal_.append(&node);
+      this->normal_.append({&node, cost_ns});
     }
+    cost_ns_ += cost_ns;
   }
 
   const FunctionNode *pop_next_node()
   {
-    if (!this->priority_.is_empty()) {
-      return this->priority_.pop_last();
-    }
-    if (!this->normal_.is_empty()) {
-      return this->normal_.pop_last();
+    Vector<ScheduledNode> &stack = this->priority_.is_empty() ? this->normal_ : this->priority_;
+    if (stack.is_empty()) {
+      return nullptr;
     }
-    return nullptr;
+    const ScheduledNode scheduled_node = stack.pop_last();
+    cost_ns_ -= scheduled_node.cost_ns;
+    return scheduled_node.node;
   }
 
   bool is_empty() const
@@ -259,17 +277,67 @@ struct ScheduledNodes {
   }
 
   /**
-   * Split up the scheduled nodes into two groups that can be worked on in parallel.
+   * Estimated time it takes to execute all scheduled nodes. Nodes that have not been executed
+   * before don't contribute to it.
+   */
+  uint64_t cost_ns() const
+  {
+    return cost_ns_;
+  }
+
+  /**
+   * Split up the scheduled nodes into two groups that can be worked on in parallel. The nodes are
+   * split so that both groups take about the same time to execute. When nothing is known about the
+   * cost of the nodes yet, they are split by count instead. The nodes that would be executed last
+   * are moved to the other group, because the nodes that are executed next are most likely to use
+   * data that is still in the cache of the current thread.
    */
   void split_into(ScheduledNodes &other)
   {
     BLI_assert(this != &other);
-    const int64_t priority_split = priority_.size() / 2;
-    const int64_t normal_split = normal_.size() / 2;
-    other.priority_.extend(priority_.as_span().drop_front(priority_split));
-    other.normal_.extend(normal_.as_span().drop_front(normal_split));
-    priority_.resize(priority_split);
-    normal_.resize(normal_split);
+    BLI_assert(other.is_empty());
+    const int64_t nodes_num = this->nodes_num();
+    if (nodes_num < 2) {
+      return;
+    }
+    /* Nodes are popped from the end of the stacks, starting with the priority stack. So the nodes
+     * at the start of the normal stack are executed last. */
+    const auto get_node = [&](const int64_t i) -> const ScheduledNode & {
+      return i < normal_.size() ? normal_[i] : priority_[i - normal_.size()];
+    };
+    int64_t split = nodes_num / 2;
+    if (cost_ns_ > 0) {
+      /* Move all nodes whose cost is centered in the first half of the total cost. */
+      uint64_t split_cost_ns = 0;
+      split = 0;
+      while (split < nodes_num) {
+        const uint32_t cost_ns = get_node(split).cost_ns;
+        if (split_cost_ns * 2 + cost_ns >= cost_ns_) {
+          break;
+        }
+        split_cost_ns += cost_ns;
+        split++;
+      }
+      split = std::clamp<int64_t>(split, 1, nodes_num - 1);
+    }
+    const int64_t normal_split = std::min(split, normal_.size());
+    const int64_t priority_split = split - normal_split;
+    other.normal_.extend(normal_.as_span().take_front(normal_split));
+    other.priority_.extend(priority_.as_span().take_front(priority_split));
+    normal_.remove(0, normal_split);
+    priority_.remove(0, priority_split);
+    other.cost_ns_ = compute_cost(other.normal_) + compute_cost(other.priority_);
+    cost_ns_ -= other.cost_ns_;
+  }
+
+ private:
+  static uint64_t compute_cost(const Span<ScheduledNode> nodes)
+  {
+    uint64_t cost_ns = 0;
+    for (const ScheduledNode &node : nodes) {
+      cost_ns += node.cost_ns;
+    }
+    return cost_ns;
   }
 };
 
@@ -463,6 +531,8 @@ class GenericGraphExecutor {
     }
 
     r_data.total_size = offset;
+
+    r_data.node_costs_ns = std::make_unique<std::atomic<uint32_t>[]>(nodes.size());
   }
 
  private:
@@ -779,12 +849,13 @@ class GenericGraphExecutor {
       case NodeScheduleState::NotScheduled: {
         locked_node.node_state.schedule_state = NodeScheduleState::Scheduled;
         const FunctionNode &node = static_cast<const FunctionNode &>(locked_node.node);
+        const uint32_t cost_ns = this->get_node_cost(node);
         if (this->use_multi_threading()) {
           std::lock_guard lock{current_task.mutex};
-          current_task.scheduled_nodes.schedule(node, is_priority);
+          current_task.scheduled_nodes.schedule(node, is_priority, cost_ns);
         }
         else {
-          current_task.scheduled_nodes.schedule(node, is_priority);
+          current_task.scheduled_nodes.schedule(node, is_priority, cost_ns);
         }
         current_task.has_scheduled_nodes.store(true, std::memory_order_relaxed);
         break;
@@ -851,9 +922,9 @@ class GenericGraphExecutor {
       }
       this->run_node_task(*node, current_task, local_data);
 
-      /* If there are many nodes scheduled at the same time, it's beneficial to let multiple
-       * threads work on those. */
-      if (current_task.scheduled_nodes.nodes_num() > 128) {
+      /* If there is enough work scheduled at the same time, it's beneficial to let multiple
+       * threads work on it. */
+      if (this->is_worth_splitting(current_task.scheduled_nodes)) {
         if (this->try_enable_multi_threading()) {
           std::unique_ptr<ScheduledNodes> split_nodes = std::make_unique<ScheduledNodes>();
           current_task.scheduled_nodes.split_into(*split_nodes);
@@ -863,6 +934,54 @@ class GenericGraphExecutor {
     }
   }
 
+  /**
+   * Scheduled nodes are only distributed to other threads when executing them is estimated to take
+   * at least this long. Otherwise the threading overhead likely outweighs the benefit.
+   */
+  static constexpr uint64_t split_cost_threshold_ns = 100'000;
+  /**
+   * Used instead of the cost threshold when the nodes have not been executed before, so that the
+   * first evaluation of a graph can be multi-threaded as well.
+   */
+  static constexpr int64_t split_nodes_num_threshold = 128;
+
+  static bool is_worth_splitting(const ScheduledNodes &scheduled_nodes)
+  {
+    const int64_t nodes_num = scheduled_nodes.nodes_num();
+    if (nodes_num < 2) {
+      return false;
+    }
+    return scheduled_nodes.cost_ns() >= split_cost_threshold_ns ||
+           nodes_num > split_nodes_num_threshold;
+  }
+
+  uint32_t get_node_cost(const FunctionNode &node) const
+  {
+    return self_.preprocess_data_.node_costs_ns[node.index_in_graph()].load(
+        std::memory_order_relaxed);
+  }
+
+  /**
+   * Update the cost estimate of a node after it has been executed. A moving average is used so
+   * that the estimate adapts when the inputs change, without being dominated by single outliers.
+   * Concurrent updates of the same node may overwrite each other, which is fine for an estimate.
+   */
+  void update_node_cost(const FunctionNode &node, const timeit::Nanoseconds duration) const
+  {
+    std::atomic<uint32_t> &cost_ns = self_.preprocess_data_.node_costs_ns[node.index_in_graph()];
+    /* Zero is reserved for nodes that have not been executed yet. */
+    const uint32_t new_cost_ns = uint32_t(
+        std::clamp<int64_t>(duration.count(), 1, std::numeric_limits<uint32_t>::max()));
+    const uint32_t old_cost_ns = cost_ns.load(std::memory_order_relaxed);
+    if (old_cost_ns == 0) {
+      cost_ns.store(new_cost_ns, std::memory_order_relaxed);
+    }
+    else {
+      cost_ns.store(uint32_t((uint64_t(old_cost_ns) * 3 + new_cost_ns) / 4),
+                    std::memory_order_relaxed);
+    }
+  }
+
   void run_node_task(const FunctionNode &node,
                      CurrentTask &current_task,
                      const LocalData &local_data)
@@ -1486,12 +1605,14 @@ inline void GenericGraphExecutor::execute_node(const FunctionNode &node,
   };
 
   lazy_threading::HintReceiver blocking_hint_receiver{blocking_hint_fn};
+  const timeit::TimePoint start_time = timeit::Clock::now();
   if (self_.node_execute_wrapper_) {
     self_.node_execute_wrapper_->execute_node(node, node_params, fn_context);
   }
   else {
     fn.execute(node_params, fn_context);
   }
+  this->update_node_cost(node, timeit::Clock::now() - start_time);
 
   if (logging_enabled_state_.after_node_execute) {
     self_.logger_->log_after_node_execute(node, node_params, fn_context);
@@ -129,6 +129,12 @@ class ValueAllocator : NonCopyable, NonMovable {
   /** All buffers in the free-lists below have been allocated with this allocator. */
   LinearAllocator<> &linear_allocator_;
 
+  /**
+   * Span buffers have at least this many elements. When the procedure is evaluated in chunks,
+   * this is the size of the largest chunk, so that buffers can be reused for all chunks.
+   */
+  int64_t min_span_size_;
+
   /**
    * Use stacks so that the most recently used buffers are reused first. This improves cache
    * efficiency.
@@ -149,7 +155,10 @@ class ValueAllocator : NonCopyable, NonMovable {
   Map<const CPPType *, Stack<void *>> single_value_free_lists_;
 
  public:
-  ValueAllocator(LinearAllocator<> &linear_allocator) : linear_allocator_(linear_allocator) {}
+  ValueAllocator(LinearAllocator<> &linear_allocator, const int64_t min_span_size)
+      : linear_allocator_(linear_allocator), min_span_size_(min_span_size)
+  {
+  }
 
   VariableValue_GVArray *obtain_GVArray(const GVArray &varray)
   {
@@ -166,9 +175,10 @@ class ValueAllocator : NonCopyable, NonMovable {
     return this->obtain<VariableValue_Span>(buffer, false);
   }
 
-  VariableValue_Span *obtain_Span(const CPPType &type, int size)
+  VariableValue_Span *obtain_Span(const CPPType &type, int64_t size)
   {
     void *buffer = nullptr;
+    size = std::max(size, min_span_size_);
 
     const int64_t element_size = type.size;
     const int64_t alignment = type.alignment;
@@ -813,17 +823,17 @@ class VariableState : NonCopyable, NonMovable {
 /** Keeps track of the states of all variables during evaluation. */
 class VariableStates {
  private:
-  ValueAllocator value_allocator_;
+  ValueAllocator &value_allocator_;
   const Procedure &procedure_;
   /** The state of every variable, indexed by #Variable::index_in_procedure(). */
   Array<VariableState> variable_states_;
   const IndexMask &full_mask_;
 
  public:
-  VariableStates(LinearAllocator<> &linear_allocator,
+  VariableStates(ValueAllocator &value_allocator,
                  const Procedure &procedure,
                  const IndexMask &full_mask)
-      : value_allocator_(linear_allocator),
+      : value_allocator_(value_allocator),
         procedure_(procedure),
         variable_states_(procedure.variables().size()),
         full_mask_(full_mask)
@@ -1157,6 +1167,60 @@ class InstructionScheduler {
   }
 };
 
+/**
+ * Number of indices that all instructions of the procedure are executed on before continuing with
+ * the next indices. Small chunks keep the intermediate variables in the CPU cache while they are
+ * passed from one function to the next, instead of writing every intermediate buffer for all
+ * indices to main memory and reading it back for the next instruction.
+ */
+static constexpr int64_t chunk_size = 2048;
+
+static bool supports_chunked_execution(const MultiFunction &fn)
+{
+  for (const int param_index : fn.param_indices()) {
+    if (fn.param_type(param_index).data_type().is_vector()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Pass the part of the parameters that corresponds to the given range of indices, so that the
+ * chunk can be evaluated with a mask that starts at zero and only needs small buffers.
+ */
+static void add_sliced_params(const MultiFunction &fn,
+                              Params &params,
+                              const IndexRange slice_range,
+                              ParamsBuilder &r_sliced_params)
+{
+  for (const int param_index : fn.param_indices()) {
+    switch (fn.param_type(param_index).category()) {
+      case ParamCategory::SingleInput: {
+        const GVArray &varray = params.readonly_single_input(param_index);
+        r_sliced_params.add_readonly_single_input(varray.slice(slice_range));
+        break;
+      }
+      case ParamCategory::SingleMutable: {
+        const GMutableSpan span = params.single_mutable(param_index);
+        r_sliced_params.add_single_mutable(span.slice(slice_range));
+        break;
+      }
+      case ParamCategory::SingleOutput: {
+        const GMutableSpan span = params.uninitialized_single_output(param_index);
+        r_sliced_params.add_uninitialized_single_output(span.slice(slice_range));
+        break;
+      }
+      case ParamCategory::VectorInput:
+      case ParamCategory::VectorMutable:
+      case ParamCategory::VectorOutput: {
+        BLI_assert_unreachable();
+        break;
+      }
+    }
+  }
+}
+
 void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context context) const
 {
   BLI_assert(procedure_.validate());
@@ -1165,7 +1229,45 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
   LinearAllocator<> linear_allocator;
   linear_allocator.provide_buffer(local_buffer);
 
-  VariableStates variable_states{linear_allocator, procedure_, full_mask};
+  if (full_mask.size() <= chunk_size || !supports_chunked_execution(*this)) {
+    ValueAllocator value_allocator{linear_allocator, full_mask.min_array_size()};
+    this->execute(full_mask, params, context, value_allocator);
+    return;
+  }
+
+  Vector<IndexRange> chunks;
+  int64_t max_chunk_array_size = 0;
+  for (int64_t start = 0; start < full_mask.size(); start += chunk_size) {
+    const IndexRange chunk = full_mask.index_range().slice(
+        start, std::min(chunk_size, full_mask.size() - start));
+    chunks.append(chunk);
+    const IndexMask chunk_mask = full_mask.slice(chunk);
+    max_chunk_array_size = std::max(max_chunk_array_size,
+                                    chunk_mask.last() - chunk_mask.first() + 1);
+  }
+
+  /* The allocator is shared by all chunks, so that the buffers of intermediate variables are
+   * reused and stay in the cache. */
+  ValueAllocator value_allocator{linear_allocator, max_chunk_array_size};
+  for (const IndexRange chunk : chunks) {
+    const IndexMask chunk_mask = full_mask.slice(chunk);
+    const int64_t slice_start = chunk_mask.first();
+    const IndexRange slice_range{slice_start, chunk_mask.last() - slice_start + 1};
+
+    IndexMaskMemory memory;
+    const IndexMask shifted_mask = full_mask.slice_and_shift(chunk, -slice_start, memory);
+    ParamsBuilder sliced_params{*this, &shifted_mask};
+    add_sliced_params(*this, params, slice_range, sliced_params);
+    this->execute(shifted_mask, sliced_params, context, value_allocator);
+  }
+}
+
+void ProcedureExecutor::execute(const IndexMask &full_mask,
+                                Params params,
+                                Context context,
+                                ValueAllocator &value_allocator) const
+{
+  VariableStates variable_states{value_allocator, procedure_, full_mask};
   variable_states.add_initial_variable_states(*this, procedure_, params);
 
   InstructionScheduler scheduler;
@@ -182,4 +182,49 @@ TEST_F(LazyFunctionTest, GraphWithCycle)
   EXPECT_EQ(result, 10 * 2 * 5);
 }
 
+TEST_F(LazyFunctionTest, WideGraphRepeatedExecution)
+{
+  BLI_task_scheduler_init();
+  const AddLazyFunction add_fn;
+
+  Graph graph;
+  GraphInputSocket &input_socket = graph.add_input(CPPType::get<int>());
+  GraphOutputSocket &output_socket = graph.add_output(CPPType::get<int>());
+
+  /* Many independent nodes whose results are summed up in a tree, so that a lot of nodes are
+   * scheduled at the same time. */
+  const int leaves_num = 256;
+  Array<int> values(leaves_num);
+  Vector<OutputSocket *> sockets_to_sum;
+  for (const int i : IndexRange(leaves_num)) {
+    values[i] = i;
+    FunctionNode &node = graph.add_function(add_fn);
+    graph.add_link(input_socket, node.input(0));
+    node.input(1).set_default_value(&values[i]);
+    sockets_to_sum.append(&node.output(0));
+  }
+  while (sockets_to_sum.size() > 1) {
+    Vector<OutputSocket *> sums;
+    for (int i = 0; i < sockets_to_sum.size(); i += 2) {
+      FunctionNode &node = graph.add_function(add_fn);
+      graph.add_link(*sockets_to_sum[i], node.input(0));
+      graph.add_link(*sockets_to_sum[i + 1], node.input(1));
+      sums.append(&node.output(0));
+    }
+    sockets_to_sum = std::move(sums);
+  }
+  graph.add_link(*sockets_to_sum[0], output_socket);
+  graph.update_node_indices();
+
+  /* The executor keeps cost estimates of the nodes between evaluations, those must not change the
+   * result. */
+  GraphExecutor executor_fn{graph, {&input_socket}, {&output_socket}, nullptr, nullptr, nullptr};
+  for (const int input : {1, 10, 100}) {
+    int result = 0;
+    execute_lazy_function_eagerly(
+        executor_fn, nullptr, nullptr, std::make_tuple(input), std::make_tuple(&result));
+    EXPECT_EQ(result, leaves_num * input + leaves_num * (leaves_num - 1) / 2);
+  }
+}
+
 }  // namespace blender::fn::lazy_function::tests
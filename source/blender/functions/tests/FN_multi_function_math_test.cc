@@ -0,0 +1,184 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <limits>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "FN_init.hh"
+#include "FN_multi_function_builder.hh"
+#include "FN_multi_function_registry.hh"
+
+namespace blender::fn::multi_function::tests {
+namespace {
+
+enum class InputType {
+  Span,
+  Single,
+  /* Neither a span nor a single value, which is always handled by the scalar function. */
+  Func,
+};
+
+template<typename T> static T make_value(const int64_t i, const int seed)
+{
+  auto value = [&](const int64_t j) {
+    const int64_t n = (j * 37 + seed * 11) % 101;
+    if (n == 13) {
+      /* Check that NaN is handled like the scalar function for min and max. */
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    return float(n) * 0.5f - 20.0f;
+  };
+  if constexpr (std::is_same_v<T, float>) {
+    return value(i);
+  }
+  else {
+    return T(value(i * 3), value(i * 3 + 1), value(i * 3 + 2));
+  }
+}
+
+/**
+ * Call the registered function and the equivalent function built from a scalar lambda with the
+ * same inputs, and check that they write exactly the same values for the masked indices and don't
+ * touch the others.
+ */
+template<typename T>
+static void test_binary_function(const StringRef name,
+                                 const MultiFunction &scalar_fn,
+                                 const IndexMask &mask,
+                                 const InputType a_type,
+                                 const InputType b_type)
+{
+  const MultiFunction &fn = registry::lookup(UString(name));
+
+  const int64_t size = mask.min_array_size();
+  Array<T> a(size);
+  Array<T> b(size);
+  for (const int64_t i : IndexRange(size)) {
+    a[i] = make_value<T>(i, 1);
+    b[i] = make_value<T>(i, 2);
+  }
+  const T a_single = make_value<T>(5, 3);
+  const T b_single = make_value<T>(8, 4);
+
+  auto add_input = [&](ParamsBuilder &params,
+                       const Span<T> span,
+                       const T &single,
+                       const InputType type) {
+    switch (type) {
+      case InputType::Span:
+        params.add_readonly_single_input(span);
+        break;
+      case InputType::Single:
+        params.add_readonly_single_input_value(single);
+        break;
+      case InputType::Func:
+        params.add_readonly_single_input(
+            VArray<T>::from_func(span.size(), [span](const int64_t i) { return span[i]; }));
+        break;
+    }
+  };
+
+  auto run = [&](const MultiFunction &fn, MutableSpan<T> dst) {
+    ParamsBuilder params{fn, &mask};
+    add_input(params, a, a_single, a_type);
+    add_input(params, b, b_single, b_type);
+    params.add_uninitialized_single_output(dst);
+    ContextBuilder context;
+    fn.call_auto(mask, params, context);
+  };
+
+  const T unset = T(-1234.0f);
+  Array<T> result(size, unset);
+  Array<T> result_scalar(size, unset);
+  run(fn, result);
+  run(scalar_fn, result_scalar);
+  /* Compare bits, so that NaN values are considered equal. */
+  EXPECT_EQ(memcmp(result.data(), result_scalar.data(), sizeof(T) * size), 0);
+}
+
+template<typename T>
+static void test_binary_function_all_cases(const StringRef name, const MultiFunction &scalar_fn)
+{
+  register_common_functions();
+
+  IndexMaskMemory memory;
+  Vector<IndexMask> masks;
+  /* Sizes that are and are not a multiple of the 12 floats processed per iteration. */
+  for (const int64_t size : {0, 1, 3, 4, 5, 11, 12, 13, 24, 37, 1000}) {
+    masks.append(IndexMask(size));
+    /* Ranges that don't start at zero, so that the inputs and result are not aligned. */
+    masks.append(IndexMask(IndexRange(3, size)));
+  }
+  masks.append(IndexMask::from_predicate(
+      IndexRange(100), memory, [](const int64_t i) { return i % 3 != 1; }));
+  masks.append(IndexMask::from_indices<int>({0, 1, 2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13}, memory));
+
+  const InputType types[] = {InputType::Span, InputType::Single, InputType::Func};
+  for (const IndexMask &mask : masks) {
+    for (const InputType a_type : types) {
+      for (const InputType b_type : types) {
+        SCOPED_TRACE(std::string(name) + ", mask " + std::to_string(mask.size()) + " from " +
+                     std::to_string(mask.is_empty() ? 0 : mask.first()) + ", input types " +
+                     std::to_string(int(a_type)) + " " + std::to_string(int(b_type)));
+        test_binary_function<T>(name, scalar_fn, mask, a_type, b_type);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(multi_function_math, FloatFunctions)
+{
+  test_binary_function_all_cases<float>("float + float",
+                                        build::SI2_SO<float, float, float>(
+                                            "add", [](float a, float b) { return a + b; }));
+  test_binary_function_all_cases<float>("float - float",
+                                        build::SI2_SO<float, float, float>(
+                                            "sub", [](float a, float b) { return a - b; }));
+  test_binary_function_all_cases<float>("float * float",
+                                        build::SI2_SO<float, float, float>(
+                                            "mul", [](float a, float b) { return a * b; }));
+  test_binary_function_all_cases<float>(
+      "min(float, float)",
+      build::SI2_SO<float, float, float>("min",
+                                         [](float a, float b) { return std::min(a, b); }));
+  test_binary_function_all_cases<float>(
+      "max(float, float)",
+      build::SI2_SO<float, float, float>("max",
+                                         [](float a, float b) { return std::max(a, b); }));
+}
+
+TEST(multi_function_math, Float3Functions)
+{
+  auto per_component = [](auto op) {
+    return [op](const float3 &a, const float3 &b) {
+      return float3(op(a.x, b.x), op(a.y, b.y), op(a.z, b.z));
+    };
+  };
+  test_binary_function_all_cases<float3>("float3 + float3",
+                                         build::SI2_SO<float3, float3, float3>(
+                                             "add", [](float3 a, float3 b) { return a + b; }));
+  test_binary_function_all_cases<float3>("float3 - float3",
+                                         build::SI2_SO<float3, float3, float3>(
+                                             "sub", [](float3 a, float3 b) { return a - b; }));
+  test_binary_function_all_cases<float3>("float3 * float3",
+                                         build::SI2_SO<float3, float3, float3>(
+                                             "mul", [](float3 a, float3 b) { return a * b; }));
+  test_binary_function_all_cases<float3>(
+      "min(float3, float3)",
+      build::SI2_SO<float3, float3, float3>(
+          "min", per_component([](float a, float b) { return std::min(a, b); })));
+  test_binary_function_all_cases<float3>(
+      "max(float3, float3)",
+      build::SI2_SO<float3, float3, float3>(
+          "max", per_component([](float a, float b) { return std::max(a, b); })));
+}
+
+}  // namespace blender::fn::multi_function::tests
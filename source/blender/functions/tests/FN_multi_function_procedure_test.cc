@@ -427,4 +427,67 @@ TEST_F(MultiFunctionProcedureTest, OutputBufferReplaced)
   EXPECT_EQ(output[2], output_value);
 }
 
+TEST_F(MultiFunctionProcedureTest, LargeMaskInChunks)
+{
+  /**
+   * procedure(int a, int b, int *out) {
+   *   int c = a + b;
+   *   out = c + 10;
+   * }
+   */
+
+  auto add_fn = build::SI2_SO<int, int, int>("add", [](int a, int b) { return a + b; });
+  auto add_10_fn = build::SI1_SO<int, int>("add 10", [](int a) { return a + 10; });
+
+  Procedure procedure;
+  ProcedureBuilder builder{procedure};
+
+  Variable *var_a = &builder.add_single_input_parameter<int>();
+  Variable *var_b = &builder.add_single_input_parameter<int>();
+  auto [var_c] = builder.add_call<1>(add_fn, {var_a, var_b});
+  builder.add_destruct({var_a, var_b});
+  auto [var_out] = builder.add_call<1>(add_10_fn, {var_c});
+  builder.add_destruct(*var_c);
+  builder.add_return();
+  builder.add_output_parameter(*var_out);
+
+  EXPECT_TRUE(procedure.validate());
+
+  ProcedureExecutor procedure_fn{procedure};
+
+  /* Dense at the start and sparse afterwards, so that the chunks span different index ranges. */
+  const int size = 40000;
+  Vector<int> indices;
+  for (const int i : IndexRange(size)) {
+    if (i < 5000 || i % 7 == 0) {
+      indices.append(i);
+    }
+  }
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_indices<int>(indices, memory);
+
+  Array<int> inputs(size);
+  for (const int i : inputs.index_range()) {
+    inputs[i] = i;
+  }
+  Array<int> results(size, -1);
+
+  ParamsBuilder params{procedure_fn, &mask};
+  params.add_readonly_single_input(inputs.as_span());
+  params.add_readonly_single_input_value(3);
+  params.add_uninitialized_single_output(results.as_mutable_span());
+
+  ContextBuilder context;
+  procedure_fn.call(mask, params, context);
+
+  for (const int i : IndexRange(size)) {
+    if (i < 5000 || i % 7 == 0) {
+      EXPECT_EQ(results[i], i + 13);
+    }
+    else {
+      EXPECT_EQ(results[i], -1);
+    }
+  }
+}
+
 }  // namespace blender::fn::multi_function::tests
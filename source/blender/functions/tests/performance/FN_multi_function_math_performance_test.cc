@@ -0,0 +1,104 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <iostream>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_timeit.hh"
+
+#include "FN_init.hh"
+#include "FN_multi_function_builder.hh"
+#include "FN_multi_function_registry.hh"
+
+namespace blender::fn::multi_function::tests {
+
+/* Similar to the size of a large point cloud. */
+static constexpr int64_t elements_num = 10'000'000;
+static constexpr int iterations = 10;
+
+/**
+ * Compare the registered function with a function built from a scalar lambda, which is how the
+ * math functions were implemented before they got explicit SIMD loops.
+ */
+template<typename T>
+static void benchmark_binary_function(const StringRef name,
+                                      const MultiFunction &scalar_fn,
+                                      const bool b_is_single)
+{
+  register_common_functions();
+  const MultiFunction &fn = registry::lookup(UString(name));
+
+  Array<T> a(elements_num);
+  Array<T> b(elements_num);
+  for (const int64_t i : a.index_range()) {
+    a[i] = T(float(i % 1000) * 0.25f);
+    b[i] = T(float(i % 77) - 30.0f);
+  }
+  Array<T> result(elements_num);
+  Array<T> result_scalar(elements_num);
+  const IndexMask mask(elements_num);
+
+  auto run = [&](const MultiFunction &fn, MutableSpan<T> dst) {
+    ParamsBuilder params{fn, &mask};
+    params.add_readonly_single_input(a.as_span());
+    if (b_is_single) {
+      params.add_readonly_single_input_value(b[7]);
+    }
+    else {
+      params.add_readonly_single_input(b.as_span());
+    }
+    params.add_uninitialized_single_output(dst);
+    ContextBuilder context;
+    fn.call_auto(mask, params, context);
+  };
+
+  /* Use the fastest run to reduce noise from other processes. */
+  auto min_duration = [&](const MultiFunction &fn, MutableSpan<T> dst) {
+    timeit::Nanoseconds min_time = timeit::Nanoseconds::max();
+    for ([[maybe_unused]] const int i : IndexRange(iterations)) {
+      const timeit::TimePoint start = timeit::Clock::now();
+      run(fn, dst);
+      min_time = std::min(min_time, timeit::Clock::now() - start);
+    }
+    return min_time;
+  };
+
+  const timeit::Nanoseconds scalar_time = min_duration(scalar_fn, result_scalar);
+  const timeit::Nanoseconds simd_time = min_duration(fn, result);
+  std::cout << name << (b_is_single ? " (single B)" : "") << ": scalar ";
+  timeit::print_duration(scalar_time);
+  std::cout << ", SIMD ";
+  timeit::print_duration(simd_time);
+  std::cout << ", speedup " << double(scalar_time.count()) / double(simd_time.count()) << "x\n";
+
+  EXPECT_EQ(result.as_span(), result_scalar.as_span());
+}
+
+TEST(multi_function_math_performance, FloatAdd)
+{
+  auto scalar_fn = build::SI2_SO<float, float, float>(
+      "add", [](const float a, const float b) { return a + b; });
+  benchmark_binary_function<float>("float + float", scalar_fn, false);
+  benchmark_binary_function<float>("float + float", scalar_fn, true);
+}
+
+TEST(multi_function_math_performance, FloatMax)
+{
+  auto scalar_fn = build::SI2_SO<float, float, float>(
+      "max", [](const float a, const float b) { return std::max(a, b); });
+  benchmark_binary_function<float>("max(float, float)", scalar_fn, false);
+}
+
+TEST(multi_function_math_performance, Float3Multiply)
+{
+  auto scalar_fn = build::SI2_SO<float3, float3, float3>(
+      "multiply", [](const float3 &a, const float3 &b) { return a * b; });
+  benchmark_binary_function<float3>("float3 * float3", scalar_fn, false);
+  benchmark_binary_function<float3>("float3 * float3", scalar_fn, true);
+}
+
+}  // namespace blender::fn::multi_function::tests
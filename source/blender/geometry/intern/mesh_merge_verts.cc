@@ -10,10 +10,10 @@
 #include "BLI_array_utils.hh"
 #include "BLI_bit_vector.hh"
 #include "BLI_index_mask.hh"
-#include "BLI_kdtree.hh"
 #include "BLI_listbase.hh"
 #include "BLI_math_vector_c.hh"
 #include "BLI_offset_indices.hh"
+#include "BLI_spatial_hash_grid.hh"
 #include "BLI_vector.hh"
 
 #include "BKE_attribute.hh"
@@ -1802,15 +1802,9 @@ std::optional<Mesh *> mesh_merge_by_distance_all(const Mesh &mesh,
 {
   Array<int> vert_dest_map(mesh.verts_num, OUT_OF_CONTEXT);
 
-  KDTree<float3> *tree = kdtree_new<float3>(selection.size());
-
   const Span<float3> positions = mesh.vert_positions();
-  selection.foreach_index([&](const int64_t i) { kdtree_insert<float3>(tree, i, positions[i]); });
-
-  kdtree_balance<float3>(tree);
-  const int vert_kill_len = kdtree_calc_duplicates_fast<float3>(
-      tree, merge_distance, true, vert_dest_map.data());
-  kdtree_free<float3>(tree);
+  const int vert_kill_len = calc_duplicate_points(
+      positions, selection, merge_distance, true, vert_dest_map);
 
   if (vert_kill_len == 0) {
     return std::nullopt;
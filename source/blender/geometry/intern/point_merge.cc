@@ -3,8 +3,8 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "BLI_array_utils.hh"
-#include "BLI_kdtree.hh"
 #include "BLI_offset_indices.hh"
+#include "BLI_spatial_hash_grid.hh"
 #include "BLI_task.hh"
 
 #include "DNA_pointcloud_types.h"
@@ -103,13 +103,8 @@ PointCloud *point_merge_by_distance(const PointCloud &src_points,
                                     const bke::AttributeFilter &attribute_filter)
 {
   const Span<float3> positions = src_points.positions();
-  KDTree<float3> *tree = kdtree_new<float3>(selection.size());
-  selection.foreach_index_optimized<int64_t>(
-      [&](const int64_t i) { kdtree_insert<float3>(tree, i, positions[i]); });
-  kdtree_balance<float3>(tree);
   Array<int> root_indices(src_points.totpoint, -1);
-  kdtree_calc_duplicates_fast<float3>(tree, merge_distance, false, root_indices.data());
-  kdtree_free<float3>(tree);
+  calc_duplicate_points(positions, selection, merge_distance, false, root_indices);
   threading::parallel_for(root_indices.index_range(), 1024, [&](const IndexRange range) {
     for (const int i : range) {
       if (root_indices[i] == -1) {
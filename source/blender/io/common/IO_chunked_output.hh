@@ -0,0 +1,93 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup io
+ *
+ * Streaming output of a large number of items, shared by the mesh exporters.
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include "BLI_array.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base_c.hh"
+#include "BLI_task.hh"
+#include "BLI_threads.hh"
+
+namespace blender::io {
+
+/**
+ * Format `items_num` items in parallel chunks of `chunk_size` items and write the chunks out in
+ * order, without ever holding the formatted output of the whole range in memory.
+ *
+ * Chunks are processed in windows of a few chunks per thread. While one window is being written
+ * by a single task, the next window is formatted in parallel into the other half of a ring of
+ * buffers, so the peak memory usage only depends on the chunk size and the number of threads.
+ *
+ * - `format_chunk(IndexRange items, Buffer &buffer)` formats the items into an empty buffer, it
+ *   is called from multiple threads at once.
+ * - `write_chunk(Buffer &buffer)` writes the buffer to the output and clears it for reuse. It is
+ *   called for every chunk in order, never concurrently.
+ */
+template<typename Buffer, typename FormatChunkFn, typename WriteChunkFn>
+inline void write_chunked_output(const int64_t items_num,
+                                 const int64_t chunk_size,
+                                 const FormatChunkFn &format_chunk,
+                                 const WriteChunkFn &write_chunk)
+{
+  if (items_num <= 0) {
+    return;
+  }
+  const int64_t chunks_num = divide_ceil_ul(uint64_t(items_num), uint64_t(chunk_size));
+  auto chunk_items = [&](const int64_t chunk) {
+    return IndexRange::from_begin_end(chunk * chunk_size,
+                                      std::min((chunk + 1) * chunk_size, items_num));
+  };
+  if (chunks_num == 1) {
+    /* Avoid the task scheduling overhead for small outputs. */
+    Buffer buffer;
+    format_chunk(chunk_items(0), buffer);
+    write_chunk(buffer);
+    return;
+  }
+
+  const int64_t window_size = std::min<int64_t>(chunks_num, BLI_system_thread_count() * 4);
+  Array<Buffer> ring(window_size * 2);
+
+  auto format_window = [&](const int64_t window_start, const int64_t ring_offset) {
+    const int64_t window_chunks = std::min(window_size, chunks_num - window_start);
+    threading::parallel_for(IndexRange(window_chunks), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        format_chunk(chunk_items(window_start + i), ring[ring_offset + i]);
+      }
+    });
+  };
+  auto write_window = [&](const int64_t window_start, const int64_t ring_offset) {
+    const int64_t window_chunks = std::min(window_size, chunks_num - window_start);
+    for (const int64_t i : IndexRange(window_chunks)) {
+      write_chunk(ring[ring_offset + i]);
+    }
+  };
+
+  format_window(0, 0);
+  int64_t ring_offset = 0;
+  for (int64_t window_start = 0; window_start < chunks_num; window_start += window_size) {
+    const int64_t next_window_start = window_start + window_size;
+    const int64_t next_ring_offset = window_size - ring_offset;
+    if (next_window_start < chunks_num) {
+      threading::parallel_invoke([&]() { write_window(window_start, ring_offset); },
+                                 [&]() { format_window(next_window_start, next_ring_offset); });
+    }
+    else {
+      write_window(window_start, ring_offset);
+    }
+    ring_offset = next_ring_offset;
+  }
+}
+
+}  // namespace blender::io
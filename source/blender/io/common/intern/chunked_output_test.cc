@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <string>
+
+#include "BLI_threads.hh"
+
+#include "IO_chunked_output.hh"
+
+namespace blender::io {
+
+/** Format items into a buffer with a size that depends on the item. */
+static void format_item(const int64_t item, std::string &buffer)
+{
+  buffer += std::to_string(item);
+  buffer.append(size_t(item % 7), '.');
+  buffer += '\n';
+}
+
+static std::string format_serial(const int64_t items_num)
+{
+  std::string result;
+  for (const int64_t item : IndexRange(items_num)) {
+    format_item(item, result);
+  }
+  return result;
+}
+
+static std::string format_chunked(const int64_t items_num,
+                                  const int64_t chunk_size,
+                                  int64_t &r_chunks_num)
+{
+  std::string result;
+  r_chunks_num = 0;
+  write_chunked_output<std::string>(
+      items_num,
+      chunk_size,
+      [&](const IndexRange items, std::string &buffer) {
+        EXPECT_TRUE(buffer.empty());
+        for (const int64_t item : items) {
+          format_item(item, buffer);
+        }
+      },
+      [&](std::string &buffer) {
+        result += buffer;
+        buffer.clear();
+        r_chunks_num++;
+      });
+  return result;
+}
+
+TEST(io_common_chunked_output, matches_serial_output)
+{
+  for (const int threads_num : {1, 3, 8}) {
+    BLI_system_num_threads_override_set(threads_num);
+    /* Many more chunks than fit into the ring of buffers, so that it wraps around many times. The
+     * last chunk is only partially filled. */
+    const int64_t chunk_size = 5;
+    const int64_t window_size = BLI_system_thread_count() * 4;
+    const int64_t items_num = window_size * 2 * 25 * chunk_size + 3;
+    SCOPED_TRACE(threads_num);
+    int64_t chunks_num = 0;
+    EXPECT_EQ(format_chunked(items_num, chunk_size, chunks_num), format_serial(items_num));
+    EXPECT_EQ(chunks_num, window_size * 2 * 25 + 1);
+  }
+  BLI_system_num_threads_override_set(0);
+}
+
+TEST(io_common_chunked_output, small_outputs)
+{
+  for (const int64_t items_num : {0, 1, 4, 5, 6, 11}) {
+    SCOPED_TRACE(items_num);
+    int64_t chunks_num = 0;
+    EXPECT_EQ(format_chunked(items_num, 5, chunks_num), format_serial(items_num));
+    EXPECT_EQ(chunks_num, (items_num + 4) / 5);
+  }
+}
+
+}  // namespace blender::io
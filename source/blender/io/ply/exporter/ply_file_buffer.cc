@@ -10,6 +10,8 @@
 
 #include "BLI_fileops.hh"
 
+#include "IO_chunked_output.hh"
+
 #include <system_error>
 
 #include "CLG_log.h"
@@ -30,6 +32,8 @@ FileBuffer::FileBuffer(const char *filepath, size_t buffer_chunk_size)
   }
 }
 
+FileBuffer::FileBuffer(size_t buffer_chunk_size) : buffer_chunk_size_(buffer_chunk_size) {}
+
 void FileBuffer::write_to_file()
 {
   for (const VectorChar &b : blocks_) {
@@ -38,6 +42,28 @@ void FileBuffer::write_to_file()
   blocks_.clear();
 }
 
+void FileBuffer::write_chunked_to_file(
+    int64_t items_num, FunctionRef<void(FileBuffer &buffer, IndexRange items)> write_items)
+{
+  /* Anything written before has to come first in the file. */
+  this->write_to_file();
+  write_chunked_output<std::unique_ptr<FileBuffer>>(
+      items_num,
+      32 * 1024,
+      [&](const IndexRange items, std::unique_ptr<FileBuffer> &buffer) {
+        if (!buffer) {
+          buffer = this->create_chunk_buffer();
+        }
+        write_items(*buffer, items);
+      },
+      [&](std::unique_ptr<FileBuffer> &buffer) {
+        for (const VectorChar &b : buffer->blocks_) {
+          fwrite(b.data(), 1, b.size(), this->outfile_);
+        }
+        buffer->blocks_.clear();
+      });
+}
+
 void FileBuffer::close_file()
 {
   if (!outfile_) {
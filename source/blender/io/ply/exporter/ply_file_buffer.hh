@@ -8,11 +8,14 @@
 
 #pragma once
 
+#include "BLI_function_ref.hh"
+#include "BLI_index_range.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_utility_mixins.hh"
 #include "BLI_vector.hh"
 
 #include <fmt/format.h>
+#include <memory>
 
 namespace blender::io::ply {
 
@@ -27,8 +30,8 @@ class FileBuffer : private NonMovable {
   using VectorChar = Vector<char>;
   Vector<VectorChar> blocks_;
   size_t buffer_chunk_size_;
-  const char *filepath_;
-  FILE *outfile_;
+  const char *filepath_ = nullptr;
+  FILE *outfile_ = nullptr;
 
  public:
   FileBuffer(const char *filepath, size_t buffer_chunk_size = 64 * 1024);
@@ -38,6 +41,14 @@ class FileBuffer : private NonMovable {
   /* Write contents to the buffer(s) into a file, and clear the buffers. */
   void write_to_file();
 
+  /**
+   * Write `items_num` items to the file by calling `write_items` for chunks of them. The chunks
+   * are formatted in parallel into separate buffers and written in order, so only a bounded
+   * amount of output is kept in memory regardless of the number of items.
+   */
+  void write_chunked_to_file(int64_t items_num,
+                             FunctionRef<void(FileBuffer &buffer, IndexRange items)> write_items);
+
   void close_file();
 
   virtual void write_vertex(float x, float y, float z) = 0;
@@ -67,6 +78,12 @@ class FileBuffer : private NonMovable {
   void write_newline();
 
  protected:
+  /** Buffer without a file, used to format chunks of #write_chunked_to_file. */
+  FileBuffer(size_t buffer_chunk_size = 64 * 1024);
+
+  /** Create a buffer with the same output format, but without a file. */
+  virtual std::unique_ptr<FileBuffer> create_chunk_buffer() const = 0;
+
   /* Ensure the last block contains at least this amount of free space.
    * If not, add a new block with max of block size & the amount of space needed. */
   void ensure_space(size_t at_least)
@@ -30,5 +30,8 @@ class FileBufferBinary : public FileBuffer {
   void write_face(char size, Span<uint32_t> const &vertex_indices) override;
 
   void write_edge(int first, int second) override;
+
+ protected:
+  std::unique_ptr<FileBuffer> create_chunk_buffer() const override;
 };
 }  // namespace blender::io::ply
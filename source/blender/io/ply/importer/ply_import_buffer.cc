@@ -5,11 +5,18 @@
 #include "ply_import_buffer.hh"
 
 #include "BLI_fileops.hh"
+#include "BLI_mmap.hh"
 
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <fcntl.h>
 #include <stdexcept>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
 
 namespace blender {
 
@@ -21,7 +28,7 @@ static inline bool is_newline(char ch)
 namespace io::ply {
 
 PlyReadBuffer::PlyReadBuffer(const char *file_path, size_t read_buffer_size)
-    : buffer_(read_buffer_size), read_buffer_size_(read_buffer_size)
+    : file_path_(file_path), buffer_(read_buffer_size), read_buffer_size_(read_buffer_size)
 {
   file_ = BLI_fopen(file_path, "rb");
 }
@@ -31,11 +38,55 @@ PlyReadBuffer::~PlyReadBuffer()
   if (file_ != nullptr) {
     fclose(file_);
   }
+  if (mmap_file_ != nullptr) {
+    BLI_mmap_free(mmap_file_);
+  }
 }
 
 void PlyReadBuffer::after_header(bool is_binary)
 {
   is_binary_ = is_binary;
+  if (is_binary_) {
+    map_file();
+  }
+}
+
+void PlyReadBuffer::map_file()
+{
+  if (file_ == nullptr) {
+    return;
+  }
+  const int file = BLI_open(file_path_.c_str(), O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return;
+  }
+  mmap_file_ = BLI_mmap_open(file);
+  close(file);
+  if (mmap_file_ == nullptr) {
+    /* Keep reading through the buffer. */
+    return;
+  }
+  mapped_data_ = static_cast<const uint8_t *>(BLI_mmap_get_pointer(mmap_file_));
+  mapped_size_ = BLI_mmap_get_length(mmap_file_);
+  /* Continue right after the header that was read through the buffer. */
+  mapped_pos_ = std::min(buffer_file_offset_ + size_t(pos_), mapped_size_);
+}
+
+Span<uint8_t> PlyReadBuffer::mapped_remaining() const
+{
+  BLI_assert(this->is_mapped());
+  return Span<uint8_t>(mapped_data_ + mapped_pos_, int64_t(mapped_size_ - mapped_pos_));
+}
+
+void PlyReadBuffer::skip_mapped(size_t size)
+{
+  BLI_assert(mapped_pos_ + size <= mapped_size_);
+  mapped_pos_ += size;
+}
+
+bool PlyReadBuffer::any_io_error() const
+{
+  return mmap_file_ != nullptr && BLI_mmap_any_io_error(mmap_file_);
 }
 
 Span<char> PlyReadBuffer::read_line()
@@ -65,6 +116,14 @@ Span<char> PlyReadBuffer::read_line()
 
 bool PlyReadBuffer::read_bytes(void *dst, size_t size)
 {
+  if (mmap_file_ != nullptr) {
+    if (size > mapped_size_ - mapped_pos_) {
+      return false;
+    }
+    memcpy(dst, mapped_data_ + mapped_pos_, size);
+    mapped_pos_ += size;
+    return true;
+  }
   while (size > 0) {
     if (pos_ + size > buf_used_) {
       if (!refill_buffer()) {
@@ -96,6 +155,7 @@ bool PlyReadBuffer::refill_buffer()
   if (keep > 0) {
     memmove(buffer_.data(), buffer_.data() + pos_, keep);
   }
+  buffer_file_offset_ += pos_;
   /* Read in data from the file. */
   size_t read = fread(buffer_.data() + keep, 1, read_buffer_size_ - keep, file_) + keep;
   at_eof_ = read < read_buffer_size_;
@@ -9,15 +9,23 @@
 #pragma once
 
 #include <cstdio>
+#include <string>
 
 #include "BLI_array.hh"
 #include "BLI_span.hh"
 
+namespace blender {
+struct BLI_mmap_file;
+}
+
 namespace blender::io::ply {
 
 /**
  * Reads underlying PLY file in large chunks, and provides interface for ASCII/header
  * parsing to read individual lines, and for binary parsing to read chunks of bytes.
+ *
+ * Binary data after the header is read from a memory mapping of the file when possible, so that
+ * elements with fixed-size rows can be decoded in parallel, see #mapped_remaining.
  */
 class PlyReadBuffer {
  public:
@@ -38,10 +46,36 @@ class PlyReadBuffer {
    */
   bool read_bytes(void *dst, size_t size);
 
+  /** True when binary data is read from a memory mapping of the file. */
+  bool is_mapped() const
+  {
+    return mmap_file_ != nullptr;
+  }
+
+  /**
+   * All the mapped bytes that have not been read yet. Only valid when #is_mapped is true.
+   * Use #skip_mapped to advance the read position after decoding them.
+   */
+  Span<uint8_t> mapped_remaining() const;
+
+  /** Advance the read position of the mapping by a number of bytes. */
+  void skip_mapped(size_t size);
+
+  /** True if reading the mapped file failed, e.g. because it was truncated while reading. */
+  bool any_io_error() const;
+
  private:
   bool refill_buffer();
+  void map_file();
 
+  std::string file_path_;
   FILE *file_ = nullptr;
+  BLI_mmap_file *mmap_file_ = nullptr;
+  const uint8_t *mapped_data_ = nullptr;
+  size_t mapped_size_ = 0;
+  size_t mapped_pos_ = 0;
+  /** Offset in the file of the first byte in #buffer_. */
+  size_t buffer_file_offset_ = 0;
   Array<char> buffer_;
   int pos_ = 0;
   int buf_used_ = 0;
@@ -12,6 +12,7 @@
 
 #include "BLI_endian_switch.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "fast_float.h"
 
@@ -196,22 +197,13 @@ template<typename T> static T get_binary_value(PlyDataTypes type, const uint8_t
   return val;
 }
 
-static const char *parse_row_binary(PlyReadBuffer &file,
-                                    const PlyHeader &header,
-                                    const PlyElement &element,
-                                    Vector<uint8_t> &r_scratch,
-                                    Vector<float> &r_values)
+/** Convert one row of fixed size binary properties, the row is endian switched in place. */
+static const char *decode_row_binary(const PlyHeader &header,
+                                     const PlyElement &element,
+                                     uint8_t *row,
+                                     MutableSpan<float> r_values)
 {
-  if (element.stride == 0) {
-    return "Vertex/Edge element contains list properties, this is not supported";
-  }
-  BLI_assert(r_scratch.size() == element.stride);
-  BLI_assert(r_values.size() == element.properties.size());
-  if (!file.read_bytes(r_scratch.data(), r_scratch.size())) {
-    return "Could not read row of binary property";
-  }
-
-  const uint8_t *ptr = r_scratch.data();
+  const uint8_t *ptr = row;
   if (header.type == PlyFormatType::BINARY_LE) {
     /* Little endian: just read/convert the values. */
     for (int i = 0, n = int(element.properties.size()); i != n; i++) {
@@ -235,6 +227,80 @@ static const char *parse_row_binary(PlyReadBuffer &file,
   return nullptr;
 }
 
+static const char *parse_row_binary(PlyReadBuffer &file,
+                                    const PlyHeader &header,
+                                    const PlyElement &element,
+                                    Vector<uint8_t> &r_scratch,
+                                    Vector<float> &r_values)
+{
+  if (element.stride == 0) {
+    return "Vertex/Edge element contains list properties, this is not supported";
+  }
+  BLI_assert(r_scratch.size() == element.stride);
+  BLI_assert(r_values.size() == element.properties.size());
+  if (!file.read_bytes(r_scratch.data(), r_scratch.size())) {
+    return "Could not read row of binary property";
+  }
+  return decode_row_binary(header, element, r_scratch.data(), r_values);
+}
+
+/**
+ * Parse all rows of an element without list properties, calling `store_row(row_index, values)`
+ * for each of them. When the binary file is memory mapped, the fixed size rows are decoded in
+ * parallel, so `store_row` must only write data for its own row.
+ */
+template<typename StoreRowFn>
+static const char *parse_rows(PlyReadBuffer &file,
+                              const PlyHeader &header,
+                              const PlyElement &element,
+                              const StoreRowFn &store_row)
+{
+  if (header.type != PlyFormatType::ASCII && file.is_mapped()) {
+    if (element.stride == 0) {
+      return "Vertex/Edge element contains list properties, this is not supported";
+    }
+    if (!ELEM(header.type, PlyFormatType::BINARY_LE, PlyFormatType::BINARY_BE)) {
+      return "Unknown binary ply format for vertex element";
+    }
+    const Span<uint8_t> rows = file.mapped_remaining();
+    const int64_t rows_size = int64_t(element.count) * element.stride;
+    if (rows.size() < rows_size) {
+      return "Could not read row of binary property";
+    }
+    threading::parallel_for(IndexRange(element.count), 4096, [&](const IndexRange range) {
+      Vector<float> value_vec(element.properties.size());
+      Vector<uint8_t> scratch(element.stride);
+      for (const int i : range) {
+        memcpy(scratch.data(), rows.data() + int64_t(i) * element.stride, element.stride);
+        decode_row_binary(header, element, scratch.data(), value_vec);
+        store_row(i, value_vec.as_span());
+      }
+    });
+    file.skip_mapped(size_t(rows_size));
+    return nullptr;
+  }
+
+  Vector<float> value_vec(element.properties.size());
+  Vector<uint8_t> scratch;
+  if (header.type != PlyFormatType::ASCII) {
+    scratch.resize(element.stride);
+  }
+  for (int i = 0; i < element.count; i++) {
+    const char *error = nullptr;
+    if (header.type == PlyFormatType::ASCII) {
+      error = parse_row_ascii(file, value_vec);
+    }
+    else {
+      error = parse_row_binary(file, header, element, scratch, value_vec);
+    }
+    if (error != nullptr) {
+      return error;
+    }
+    store_row(i, value_vec.as_span());
+  }
+  return nullptr;
+}
+
 static const char *load_vertex_element(PlyReadBuffer &file,
                                        const PlyHeader &header,
                                        const PlyElement &element,
@@ -273,15 +339,15 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     data->vertex_custom_attr.append(attr);
   }
 
-  data->vertices.reserve(element.count);
+  data->vertices.resize(element.count);
   if (has_color) {
-    data->vertex_colors.reserve(element.count);
+    data->vertex_colors.resize(element.count);
   }
   if (has_normal) {
-    data->vertex_normals.reserve(element.count);
+    data->vertex_normals.resize(element.count);
   }
   if (has_uv) {
-    data->uv_coordinates.reserve(element.count);
+    data->uv_coordinates.resize(element.count);
   }
 
   float4 color_norm = {1, 1, 1, 1};
@@ -294,31 +360,13 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     color_norm.w = data_type_normalizer[element.properties[alpha_index].type];
   }
 
-  Vector<float> value_vec(element.properties.size());
-  Vector<uint8_t> scratch;
-  if (header.type != PlyFormatType::ASCII) {
-    scratch.resize(element.stride);
-  }
-
-  for (int i = 0; i < element.count; i++) {
-
-    const char *error = nullptr;
-    if (header.type == PlyFormatType::ASCII) {
-      error = parse_row_ascii(file, value_vec);
-    }
-    else {
-      error = parse_row_binary(file, header, element, scratch, value_vec);
-    }
-    if (error != nullptr) {
-      return error;
-    }
-
+  return parse_rows(file, header, element, [&](const int i, const Span<float> value_vec) {
     /* Vertex coord */
     float3 vertex3;
     vertex3.x = value_vec[vertex_index.x];
     vertex3.y = value_vec[vertex_index.y];
     vertex3.z = value_vec[vertex_index.z];
-    data->vertices.append(vertex3);
+    data->vertices[i] = vertex3;
 
     /* Vertex color */
     if (has_color) {
@@ -332,7 +380,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       else {
         colors4.w = 1.0f;
       }
-      data->vertex_colors.append(colors4);
+      data->vertex_colors[i] = colors4;
     }
 
     /* If normals */
@@ -341,7 +389,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       normals3.x = value_vec[normal_index.x];
       normals3.y = value_vec[normal_index.y];
       normals3.z = value_vec[normal_index.z];
-      data->vertex_normals.append(normals3);
+      data->vertex_normals[i] = normals3;
     }
 
     /* If uv */
@@ -349,7 +397,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       float2 uvmap;
       uvmap.x = value_vec[uv_index.x];
       uvmap.y = value_vec[uv_index.y];
-      data->uv_coordinates.append(uvmap);
+      data->uv_coordinates[i] = uvmap;
     }
 
     /* Custom attributes */
@@ -357,8 +405,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       float value = value_vec[custom_attr_indices[ci]];
       data->vertex_custom_attr[ci].data[i] = value;
     }
-  }
-  return nullptr;
+  });
 }
 
 static uint32_t read_list_count(PlyReadBuffer &file,
@@ -392,6 +439,90 @@ static void skip_property(PlyReadBuffer &file,
   }
 }
 
+/**
+ * Fast path for binary faces that only have the vertex indices list, where every face has the
+ * same number of vertices (e.g. triangulated scans). The rows then have a fixed size and are
+ * decoded in parallel from the memory mapped file. Returns false without reading anything when
+ * this does not apply, so that the generic path can be used instead.
+ */
+static bool load_uniform_faces_mapped(PlyReadBuffer &file,
+                                      const PlyHeader &header,
+                                      const PlyElement &element,
+                                      PlyData *data)
+{
+  if (!file.is_mapped() || element.properties.size() != 1 || element.count <= 0) {
+    return false;
+  }
+  const PlyProperty &prop = element.properties[0];
+  const bool big_endian = header.type == PlyFormatType::BINARY_BE;
+  const int count_size = data_type_size[prop.count_type];
+  const int index_size = data_type_size[prop.type];
+  const Span<uint8_t> rows = file.mapped_remaining();
+  if (rows.size() < count_size) {
+    return false;
+  }
+
+  auto read_count = [&](const uint8_t *row) {
+    alignas(8) uint8_t buf[8];
+    memcpy(buf, row, count_size);
+    if (big_endian) {
+      endian_switch(buf, count_size);
+    }
+    const uint8_t *ptr = buf;
+    return get_binary_value<uint32_t>(prop.count_type, ptr);
+  };
+
+  const uint32_t face_size = read_count(rows.data());
+  if (face_size < 3 || face_size > 255) {
+    return false;
+  }
+  const int64_t stride = count_size + int64_t(face_size) * index_size;
+  const int64_t rows_size = stride * element.count;
+  if (rows.size() < rows_size) {
+    return false;
+  }
+
+  const bool is_uniform = threading::parallel_reduce(
+      IndexRange(element.count),
+      16384,
+      true,
+      [&](const IndexRange range, bool value) {
+        if (!value) {
+          return false;
+        }
+        for (const int64_t i : range) {
+          if (read_count(rows.data() + i * stride) != face_size) {
+            return false;
+          }
+        }
+        return true;
+      },
+      std::logical_and<bool>());
+  if (!is_uniform) {
+    return false;
+  }
+
+  data->face_vertices.resize(int64_t(element.count) * face_size);
+  data->face_sizes.resize(element.count, face_size);
+  threading::parallel_for(IndexRange(element.count), 4096, [&](const IndexRange range) {
+    alignas(8) uint8_t buf[255 * 8];
+    for (const int64_t i : range) {
+      memcpy(buf, rows.data() + i * stride + count_size, face_size * index_size);
+      if (big_endian) {
+        endian_switch_array(buf, index_size, face_size);
+      }
+      const uint8_t *ptr = buf;
+      MutableSpan<uint32_t> face_verts = data->face_vertices.as_mutable_span().slice(
+          i * face_size, face_size);
+      for (uint32_t &vert : face_verts) {
+        vert = get_binary_value<uint32_t>(prop.type, ptr);
+      }
+    }
+  });
+  file.skip_mapped(size_t(rows_size));
+  return true;
+}
+
 static const char *load_face_element(PlyReadBuffer &file,
                                      const PlyHeader &header,
                                      const PlyElement &element,
@@ -459,6 +590,9 @@ static const char *load_face_element(PlyReadBuffer &file,
       data->face_sizes.append(count);
     }
   }
+  else if (load_uniform_faces_mapped(file, header, element, data)) {
+    /* All faces were decoded in parallel. */
+  }
   else {
     Vector<uint8_t> scratch(64);
 
@@ -597,30 +731,13 @@ static const char *load_edge_element(PlyReadBuffer &file,
     return "Edge element does not contain vertex1 and vertex2 properties";
   }
 
-  data->edges.reserve(element.count);
-
-  Vector<float> value_vec(element.properties.size());
-  Vector<uint8_t> scratch;
-  if (header.type != PlyFormatType::ASCII) {
-    scratch.resize(element.stride);
-  }
+  data->edges.resize(element.count);
 
-  for (int i = 0; i < element.count; i++) {
-    const char *error = nullptr;
-    if (header.type == PlyFormatType::ASCII) {
-      error = parse_row_ascii(file, value_vec);
-    }
-    else {
-      error = parse_row_binary(file, header, element, scratch, value_vec);
-    }
-    if (error != nullptr) {
-      return error;
-    }
+  return parse_rows(file, header, element, [&](const int i, const Span<float> value_vec) {
     int index1 = value_vec[prop_vertex1];
     int index2 = value_vec[prop_vertex2];
-    data->edges.append(std::make_pair(index1, index2));
-  }
-  return nullptr;
+    data->edges[i] = std::make_pair(index1, index2);
+  });
 }
 
 static const char *skip_element(PlyReadBuffer &file,
@@ -670,6 +787,9 @@ std::unique_ptr<PlyData> import_ply_data(PlyReadBuffer &file, PlyHeader &header)
     else {
       error = skip_element(file, header, element);
     }
+    if (error == nullptr && file.any_io_error()) {
+      error = "Could not read the memory mapped file";
+    }
     if (error != nullptr) {
       data->error = error;
       return data;
@@ -2,8 +2,13 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
+
 #include "testing/testing.h"
 
+#include "BKE_appdir.hh"
+
+#include "BLI_fileops.hh"
 #include "BLI_path_utils.hh"
 
 #include "CLG_log.h"
@@ -19,8 +24,8 @@ static CLG_LogRef LOG = {"io.ply"};
 namespace io::ply {
 
 /* Extensive tests for PLY importing are in `io_ply_import_test.py`.
- * The tests here are only for testing PLY reader buffer refill behavior,
- * by using a very small buffer size on purpose. */
+ * The tests here are for testing PLY reader buffer refill behavior,
+ * by using a very small buffer size on purpose, and for decoding binary data. */
 
 TEST(ply_import, BufferRefillTest)
 {
@@ -66,6 +71,166 @@ TEST(ply_import, BufferRefillTest)
   EXPECT_EQ_SPAN<std::pair<int, int>>(Span(exp_edges, 12), data_b->edges);
 }
 
+/* Binary files are decoded in parallel from a memory mapping when their rows have a fixed size,
+ * compare that to reading the same data from an ASCII file. */
+
+struct TestPlyMesh {
+  Vector<float3> positions;
+  Vector<uchar3> colors;
+  Vector<Vector<int>> faces;
+  Vector<std::pair<int, int>> edges;
+};
+
+static TestPlyMesh grid_ply_mesh(const int size, const bool use_quads)
+{
+  TestPlyMesh mesh;
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      mesh.positions.append(float3(x * 0.25f, y * -0.5f, (x + y) * 0.125f));
+      mesh.colors.append(uchar3(x % 256, y % 256, (x * y) % 256));
+    }
+  }
+  for (const int y : IndexRange(size - 1)) {
+    for (const int x : IndexRange(size - 1)) {
+      const int v = y * size + x;
+      if (use_quads && (x + y) % 3 == 0) {
+        mesh.faces.append({v, v + 1, v + size + 1, v + size});
+      }
+      else {
+        mesh.faces.append({v, v + 1, v + size + 1});
+        mesh.faces.append({v, v + size + 1, v + size});
+      }
+      mesh.edges.append({v, v + 1});
+    }
+  }
+  return mesh;
+}
+
+static std::string ply_header(const TestPlyMesh &mesh, const char *format)
+{
+  std::string header = "ply\nformat " + std::string(format) + " 1.0\n";
+  header += "element vertex " + std::to_string(mesh.positions.size()) + "\n";
+  header += "property float x\nproperty float y\nproperty float z\n";
+  header += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+  header += "element face " + std::to_string(mesh.faces.size()) + "\n";
+  header += "property list uchar int vertex_indices\n";
+  header += "element edge " + std::to_string(mesh.edges.size()) + "\n";
+  header += "property int vertex1\nproperty int vertex2\n";
+  header += "end_header\n";
+  return header;
+}
+
+static std::string ply_ascii(const TestPlyMesh &mesh)
+{
+  std::string text = ply_header(mesh, "ascii");
+  for (const int i : mesh.positions.index_range()) {
+    const float3 &p = mesh.positions[i];
+    const uchar3 &c = mesh.colors[i];
+    text += std::to_string(p.x) + " " + std::to_string(p.y) + " " + std::to_string(p.z) + " ";
+    text += std::to_string(c.x) + " " + std::to_string(c.y) + " " + std::to_string(c.z) + "\n";
+  }
+  for (const Span<int> face : mesh.faces) {
+    text += std::to_string(face.size());
+    for (const int vert : face) {
+      text += " " + std::to_string(vert);
+    }
+    text += "\n";
+  }
+  for (const std::pair<int, int> &edge : mesh.edges) {
+    text += std::to_string(edge.first) + " " + std::to_string(edge.second) + "\n";
+  }
+  return text;
+}
+
+template<typename T> static void append_binary(std::string &text, T value, const bool big_endian)
+{
+  if (big_endian) {
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(&value);
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+  text.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static std::string ply_binary(const TestPlyMesh &mesh, const bool big_endian)
+{
+  std::string text = ply_header(mesh, big_endian ? "binary_big_endian" : "binary_little_endian");
+  for (const int i : mesh.positions.index_range()) {
+    for (const float value : {mesh.positions[i].x, mesh.positions[i].y, mesh.positions[i].z}) {
+      append_binary(text, value, big_endian);
+    }
+    for (const uint8_t value : {mesh.colors[i].x, mesh.colors[i].y, mesh.colors[i].z}) {
+      append_binary(text, value, big_endian);
+    }
+  }
+  for (const Span<int> face : mesh.faces) {
+    append_binary(text, uint8_t(face.size()), big_endian);
+    for (const int vert : face) {
+      append_binary(text, int32_t(vert), big_endian);
+    }
+  }
+  for (const std::pair<int, int> &edge : mesh.edges) {
+    append_binary(text, int32_t(edge.first), big_endian);
+    append_binary(text, int32_t(edge.second), big_endian);
+  }
+  return text;
+}
+
+static std::unique_ptr<PlyData> import_ply_string(const std::string &text)
+{
+  BKE_tempdir_init(nullptr);
+  const std::string file_path = std::string(BKE_tempdir_base()) + SEP_STR + "ply_import_test.ply";
+  FILE *file = BLI_fopen(file_path.c_str(), "wb");
+  fwrite(text.data(), 1, text.size(), file);
+  fclose(file);
+
+  std::unique_ptr<PlyData> data;
+  {
+    PlyReadBuffer infile(file_path.c_str());
+    PlyHeader header;
+    const char *header_err = read_header(infile, header);
+    EXPECT_EQ(header_err, nullptr);
+    if (header_err == nullptr) {
+      data = import_ply_data(infile, header);
+    }
+  }
+  BLI_delete(file_path.c_str(), false, false);
+  return data;
+}
+
+static void test_binary_matches_ascii(const TestPlyMesh &mesh)
+{
+  const std::unique_ptr<PlyData> expected = import_ply_string(ply_ascii(mesh));
+  ASSERT_NE(expected, nullptr);
+  EXPECT_EQ(expected->error, "");
+  EXPECT_EQ_SPAN<float3>(expected->vertices, mesh.positions);
+  EXPECT_EQ(expected->face_sizes.size(), mesh.faces.size());
+  EXPECT_EQ(expected->edges.size(), mesh.edges.size());
+
+  for (const bool big_endian : {false, true}) {
+    SCOPED_TRACE(big_endian);
+    const std::unique_ptr<PlyData> data = import_ply_string(ply_binary(mesh, big_endian));
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(data->error, "");
+    EXPECT_EQ_SPAN<float3>(expected->vertices, data->vertices);
+    EXPECT_EQ_SPAN<float4>(expected->vertex_colors, data->vertex_colors);
+    EXPECT_EQ_SPAN<uint32_t>(expected->face_sizes, data->face_sizes);
+    EXPECT_EQ_SPAN<uint32_t>(expected->face_vertices, data->face_vertices);
+    EXPECT_EQ_SPAN<std::pair<int, int>>(expected->edges, data->edges);
+  }
+}
+
+TEST(ply_import, BinaryTriangles)
+{
+  /* Faces of the same size are decoded in parallel. */
+  test_binary_matches_ascii(grid_ply_mesh(200, false));
+}
+
+TEST(ply_import, BinaryMixedFaces)
+{
+  /* Faces of different sizes are decoded serially. */
+  test_binary_matches_ascii(grid_ply_mesh(200, true));
+}
+
 //@TODO: now we put vertex color attribute first, maybe put position first?
 //@TODO: test with vertex element having list properties
 //@TODO: test with edges starting with non-vertex index properties
@@ -146,19 +146,23 @@ void export_frame(Depsgraph *depsgraph,
     /* Write triangles. */
     const Span<float3> positions = mesh->vert_positions();
     const Span<int> corner_verts = mesh->corner_verts();
-    for (const int3 &tri : mesh->corner_tris()) {
-      PackedTriangle data{};
-      for (int i = 0; i < 3; i++) {
-        /* Reverse face order for mirrored objects. */
-        int idx = mirrored ? 2 - i : i;
-        float3 pos = positions[corner_verts[tri[idx]]];
-        mul_m4_v3(xform, pos);
-        pos *= global_scale;
-        data.vertices[i] = pos;
-      }
-      data.normal = math::normal_tri(data.vertices[0], data.vertices[1], data.vertices[2]);
-      writer->write_triangle(data);
-    }
+    const Span<int3> corner_tris = mesh->corner_tris();
+    writer->write_triangles(
+        corner_tris.size(), [&](const IndexRange tris, MutableSpan<PackedTriangle> r_data) {
+          for (const int64_t tri_i : tris.index_range()) {
+            const int3 &tri = corner_tris[tris[tri_i]];
+            PackedTriangle &data = r_data[tri_i];
+            for (int i = 0; i < 3; i++) {
+              /* Reverse face order for mirrored objects. */
+              int idx = mirrored ? 2 - i : i;
+              float3 pos = positions[corner_verts[tri[idx]]];
+              mul_m4_v3(xform, pos);
+              pos *= global_scale;
+              data.vertices[i] = pos;
+            }
+            data.normal = math::normal_tri(data.vertices[0], data.vertices[1], data.vertices[2]);
+          }
+        });
   }
   DEG_OBJECT_ITER_END;
 }
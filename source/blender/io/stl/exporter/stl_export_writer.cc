@@ -16,6 +16,9 @@
 #include "stl_export_writer.hh"
 
 #include "BLI_fileops.hh"
+#include "BLI_vector.hh"
+
+#include "IO_chunked_output.hh"
 
 namespace blender::io::stl {
 
@@ -54,35 +57,63 @@ FileWriter::~FileWriter()
   fclose(file_);
 }
 
-void FileWriter::write_triangle(const PackedTriangle &data)
+/** Triangles of one chunk, and their text when writing ASCII files. */
+struct TrianglesChunk {
+  Vector<PackedTriangle> tris;
+  fmt::memory_buffer text;
+};
+
+static void format_triangle_ascii(const PackedTriangle &data, fmt::memory_buffer &r_text)
 {
-  tris_num_++;
-  if (ascii_) {
-    fmt::print(file_,
-               "facet normal {} {} {}\n"
-               " outer loop\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               " endloop\n"
-               "endfacet\n",
+  fmt::format_to(fmt::appender(r_text),
+                 "facet normal {} {} {}\n"
+                 " outer loop\n"
+                 "  vertex {} {} {}\n"
+                 "  vertex {} {} {}\n"
+                 "  vertex {} {} {}\n"
+                 " endloop\n"
+                 "endfacet\n",
+                 data.normal.x,
+                 data.normal.y,
+                 data.normal.z,
+                 data.vertices[0].x,
+                 data.vertices[0].y,
+                 data.vertices[0].z,
+                 data.vertices[1].x,
+                 data.vertices[1].y,
+                 data.vertices[1].z,
+                 data.vertices[2].x,
+                 data.vertices[2].y,
+                 data.vertices[2].z);
+}
 
-               data.normal.x,
-               data.normal.y,
-               data.normal.z,
-               data.vertices[0].x,
-               data.vertices[0].y,
-               data.vertices[0].z,
-               data.vertices[1].x,
-               data.vertices[1].y,
-               data.vertices[1].z,
-               data.vertices[2].x,
-               data.vertices[2].y,
-               data.vertices[2].z);
-  }
-  else {
-    fwrite(&data, sizeof(data), 1, file_);
-  }
+void FileWriter::write_triangles(
+    const int64_t tris_num,
+    const FunctionRef<void(IndexRange tris, MutableSpan<PackedTriangle> r_data)> fill_triangles)
+{
+  write_chunked_output<TrianglesChunk>(
+      tris_num,
+      16 * 1024,
+      [&](const IndexRange range, TrianglesChunk &chunk) {
+        chunk.tris.resize(range.size(), PackedTriangle{});
+        fill_triangles(range, chunk.tris);
+        if (ascii_) {
+          for (const PackedTriangle &data : chunk.tris) {
+            format_triangle_ascii(data, chunk.text);
+          }
+        }
+      },
+      [&](TrianglesChunk &chunk) {
+        tris_num_ += uint32_t(chunk.tris.size());
+        if (ascii_) {
+          fwrite(chunk.text.data(), 1, chunk.text.size(), file_);
+        }
+        else {
+          fwrite(chunk.tris.data(), sizeof(PackedTriangle), chunk.tris.size(), file_);
+        }
+        chunk.tris.clear();
+        chunk.text.clear();
+      });
 }
 
 }  // namespace blender::io::stl
@@ -11,6 +11,10 @@
 #include <cstdint>
 #include <cstdio>
 
+#include "BLI_function_ref.hh"
+#include "BLI_index_range.hh"
+#include "BLI_span.hh"
+
 namespace blender::io::stl {
 
 struct PackedTriangle;
@@ -19,7 +23,13 @@ class FileWriter {
  public:
   FileWriter(const char *filepath, bool ascii);
   ~FileWriter();
-  void write_triangle(const PackedTriangle &data);
+  /**
+   * Write `tris_num` triangles, which are computed by `fill_triangles` for chunks of them. The
+   * chunks are computed and formatted in parallel, and written to the file in order.
+   */
+  void write_triangles(
+      int64_t tris_num,
+      FunctionRef<void(IndexRange tris, MutableSpan<PackedTriangle> r_data)> fill_triangles);
 
  private:
   FILE *file_;
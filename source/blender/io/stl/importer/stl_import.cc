@@ -86,7 +86,7 @@ Mesh *read_stl_file(const STLImportParams &import_params)
 
   Mesh *mesh = is_ascii_stl ?
                    read_stl_ascii(import_params.filepath, import_params.use_facet_normal) :
-                   read_stl_binary(file, import_params.use_facet_normal);
+                   read_stl_binary(import_params.filepath, import_params.use_facet_normal);
 
   if (mesh == nullptr) {
     CLOG_ERROR(&LOG, "STL Importer: Failed to import mesh '%s'", import_params.filepath);
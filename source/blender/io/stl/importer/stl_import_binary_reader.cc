@@ -6,12 +6,22 @@
  * \ingroup stl
  */
 
+#include <algorithm>
 #include <cstdint>
-#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
 
 #include "BKE_mesh.hh"
 
-#include "BLI_array.hh"
+#include "BLI_fileops.hh"
+#include "BLI_memory_utils.hh"
+#include "BLI_mmap.hh"
+#include "BLI_span.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -28,16 +38,31 @@ namespace blender::io::stl {
 
 static CLG_LogRef LOG = {"io.stl"};
 
-Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
+Mesh *read_stl_binary(const char *filepath, const bool use_custom_normals)
 {
-  const int chunk_size = 1024;
-  uint32_t num_tris = 0;
-  fseek(file, BINARY_HEADER_SIZE, SEEK_SET);
-  if (fread(&num_tris, sizeof(uint32_t), 1, file) != 1) {
-    stl_import_report_error(file);
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    CLOG_ERROR(&LOG, "Failed to open STL file:'%s'.", filepath);
+    return nullptr;
+  }
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file);
+  close(file);
+  if (mmap_file == nullptr) {
+    CLOG_ERROR(&LOG, "Cannot mmap STL file:'%s'.", filepath);
+    return nullptr;
+  }
+  BLI_SCOPED_DEFER([&]() { BLI_mmap_free(mmap_file); });
+
+  const char *file_data = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file));
+  const size_t file_size = BLI_mmap_get_length(mmap_file);
+  if (file_size < BINARY_HEADER_SIZE + sizeof(uint32_t)) {
+    CLOG_ERROR(&LOG, "STL Importer: failed to read file");
     return nullptr;
   }
 
+  uint32_t num_tris = 0;
+  memcpy(&num_tris, file_data + BINARY_HEADER_SIZE, sizeof(uint32_t));
+
   if (num_tris == 0) {
     return BKE_mesh_new_nomain(0, 0, 0, 0);
   }
@@ -47,13 +72,20 @@ Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
     return nullptr;
   }
 
-  Array<PackedTriangle> tris_buf(chunk_size);
+  /* Only use the triangles that are actually in the file. */
+  const size_t data_size = file_size - BINARY_HEADER_SIZE - sizeof(uint32_t);
+  num_tris = uint32_t(std::min<size_t>(num_tris, data_size / BINARY_STRIDE));
+
+  /* The triangles have a fixed size, they are decoded in parallel directly from the mapped file. */
+  const Span<PackedTriangle> tris(
+      reinterpret_cast<const PackedTriangle *>(file_data + BINARY_HEADER_SIZE + sizeof(uint32_t)),
+      num_tris);
   STLMeshHelper stl_mesh(num_tris, use_custom_normals);
-  size_t num_read_tris;
-  while ((num_read_tris = fread(tris_buf.data(), sizeof(PackedTriangle), chunk_size, file))) {
-    for (size_t i = 0; i < num_read_tris; i++) {
-      stl_mesh.add_triangle(tris_buf[i]);
-    }
+  stl_mesh.add_triangles(tris);
+
+  if (BLI_mmap_any_io_error(mmap_file)) {
+    CLOG_ERROR(&LOG, "STL Importer: failed to read file");
+    return nullptr;
   }
 
   return stl_mesh.to_mesh();
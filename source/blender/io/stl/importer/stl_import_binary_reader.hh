@@ -8,8 +8,6 @@
 
 #pragma once
 
-#include <cstdio>
-
 namespace blender {
 
 struct Mesh;
@@ -27,7 +25,7 @@ struct Mesh;
 
 namespace io::stl {
 
-Mesh *read_stl_binary(FILE *file, bool use_custom_normals);
+Mesh *read_stl_binary(const char *filepath, bool use_custom_normals);
 
 }  // namespace io::stl
 }  // namespace blender
@@ -6,10 +6,16 @@
  * \ingroup stl
  */
 
+#include <algorithm>
+#include <array>
+
 #include "BKE_mesh.hh"
 
 #include "BLI_array_utils.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_offset_indices.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -24,60 +30,262 @@ static CLG_LogRef LOG = {"io.stl"};
 
 namespace io::stl {
 
-STLMeshHelper::STLMeshHelper(int tris_num, bool use_custom_normals)
-    : use_custom_normals_(use_custom_normals)
+/** Number of hash partitions of the vertex positions, see #STLMeshHelper::VertPartition. */
+static constexpr int vert_partitions_num = 256;
+
+static int vert_partition(const float3 &position)
+{
+  /* Use the high bits of a scrambled hash, the low bits are used by the hash sets. */
+  return int((get_default_hash(position) * 0x9E3779B97F4A7C15ull) >> 56);
+}
+
+STLMeshHelper::STLMeshHelper(int tris_num, bool use_custom_normals, const int64_t chunk_size)
+    : vert_partitions_(vert_partitions_num),
+      chunk_size_(chunk_size),
+      use_custom_normals_(use_custom_normals)
 {
-  degenerate_tris_num_ = 0;
-  duplicate_tris_num_ = 0;
   tris_.reserve(tris_num);
-  /* Upper bound (all vertices are unique). */
-  verts_.reserve(int64_t(tris_num) * 3);
+  chunk_corner_positions_.reserve(std::min<int64_t>(tris_num, chunk_size) * 3);
   if (use_custom_normals) {
-    loop_normals_.reserve(int64_t(tris_num) * 3);
+    tri_normals_.reserve(tris_num);
+    chunk_tri_normals_.reserve(std::min<int64_t>(tris_num, chunk_size));
   }
 }
 
-bool STLMeshHelper::add_triangle(const PackedTriangle &data)
+void STLMeshHelper::add_triangle(const PackedTriangle &data)
 {
-  int v1_id = verts_.index_of_or_add(data.vertices[0]);
-  int v2_id = verts_.index_of_or_add(data.vertices[1]);
-  int v3_id = verts_.index_of_or_add(data.vertices[2]);
-  if ((v1_id == v2_id) || (v1_id == v3_id) || (v2_id == v3_id)) {
-    degenerate_tris_num_++;
-    return false;
+  chunk_corner_positions_.extend({data.vertices[0], data.vertices[1], data.vertices[2]});
+  if (use_custom_normals_) {
+    chunk_tri_normals_.append(data.normal);
   }
-  if (!tris_.add({v1_id, v2_id, v3_id})) {
-    duplicate_tris_num_++;
-    return false;
+  if (chunk_corner_positions_.size() == chunk_size_ * 3) {
+    this->merge_chunk();
   }
+}
 
+void STLMeshHelper::add_triangles(Span<PackedTriangle> tris)
+{
+  while (!tris.is_empty()) {
+    const int64_t chunk_start = chunk_corner_positions_.size() / 3;
+    const Span<PackedTriangle> chunk_tris = tris.take_front(chunk_size_ - chunk_start);
+    tris = tris.drop_front(chunk_tris.size());
+
+    chunk_corner_positions_.resize((chunk_start + chunk_tris.size()) * 3);
+    if (use_custom_normals_) {
+      chunk_tri_normals_.resize(chunk_start + chunk_tris.size());
+    }
+    MutableSpan<float3> corner_positions = chunk_corner_positions_.as_mutable_span().drop_front(
+        chunk_start * 3);
+    MutableSpan<float3> tri_normals = chunk_tri_normals_.as_mutable_span().drop_front(
+        chunk_start);
+    threading::parallel_for(chunk_tris.index_range(), 4096, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        const PackedTriangle &tri = chunk_tris[i];
+        corner_positions[i * 3 + 0] = tri.vertices[0];
+        corner_positions[i * 3 + 1] = tri.vertices[1];
+        corner_positions[i * 3 + 2] = tri.vertices[2];
+        if (!tri_normals.is_empty()) {
+          tri_normals[i] = tri.normal;
+        }
+      }
+    });
+
+    if (chunk_corner_positions_.size() == chunk_size_ * 3) {
+      this->merge_chunk();
+    }
+  }
+}
+
+void STLMeshHelper::merge_chunk()
+{
+  const Span<float3> positions = chunk_corner_positions_;
+  const int corners_num = int(positions.size());
+  if (corners_num == 0) {
+    return;
+  }
+
+  /* Group the corners by partition, keeping their order within every partition. */
+  Array<int> corner_partitions(corners_num);
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      corner_partitions[corner] = vert_partition(positions[corner]);
+    }
+  });
+  Array<int> partition_offsets_data(vert_partitions_num + 1, 0);
+  const OffsetIndices<int> partition_offsets = offset_indices::build_reverse_offsets(
+      corner_partitions, partition_offsets_data);
+  Array<int> partition_corners(corners_num);
+  offset_indices::reverse_indices_in_groups(
+      corner_partitions, partition_offsets, partition_corners);
+  corner_partitions = {};
+
+  /* Merge the positions of every partition. The indices of new vertices are only known once all
+   * partitions are merged, until then they are stored as `-(first_corner + 1)`. */
+  Array<int> corner_verts(corners_num);
+  Array<int> old_partition_sizes(vert_partitions_num);
+  threading::parallel_for(IndexRange(vert_partitions_num), 1, [&](const IndexRange range) {
+    for (const int partition_i : range) {
+      VertPartition &partition = vert_partitions_[partition_i];
+      old_partition_sizes[partition_i] = int(partition.verts.size());
+      for (const int corner : partition_corners.as_span().slice(partition_offsets[partition_i])) {
+        const int index = int(partition.positions.index_of_or_add(positions[corner]));
+        if (index == partition.verts.size()) {
+          partition.verts.append(-(corner + 1));
+        }
+        corner_verts[corner] = partition.verts[index];
+      }
+    }
+  });
+  partition_corners = {};
+
+  /* Number the new vertices in the order of their first corner, like a serial merge would. */
+  IndexMaskMemory memory;
+  const IndexMask new_vert_corners = IndexMask::from_predicate(
+      IndexRange(corners_num), memory, [&](const int corner) {
+        return corner_verts[corner] == -(corner + 1);
+      });
+  new_vert_corners.foreach_index(
+      [&](const int corner, const int pos) { corner_verts[corner] = verts_num_ + pos; },
+      exec_mode::grain_size(4096));
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      if (corner_verts[corner] < 0) {
+        corner_verts[corner] = corner_verts[-corner_verts[corner] - 1];
+      }
+    }
+  });
+  threading::parallel_for(IndexRange(vert_partitions_num), 1, [&](const IndexRange range) {
+    for (const int partition_i : range) {
+      Vector<int> &verts = vert_partitions_[partition_i].verts;
+      for (int &vert : verts.as_mutable_span().drop_front(old_partition_sizes[partition_i])) {
+        vert = corner_verts[-vert - 1];
+      }
+    }
+  });
+  verts_num_ += int(new_vert_corners.size());
+
+  /* Degenerate triangles are removed, duplicate triangles are only known once all are added. */
+  const Span<Triangle> tris = corner_verts.as_span().cast<Triangle>();
+  const IndexMask valid_tris = IndexMask::from_predicate(
+      tris.index_range(), memory, [&](const int tri) {
+        const Triangle &t = tris[tri];
+        return t.v1 != t.v2 && t.v1 != t.v3 && t.v2 != t.v3;
+      });
+  degenerate_tris_num_ += tris.size() - valid_tris.size();
+  const int64_t tris_start = tris_.size();
+  tris_.resize(tris_start + valid_tris.size());
+  MutableSpan<Triangle> new_tris = tris_.as_mutable_span().drop_front(tris_start);
+  valid_tris.foreach_index(
+      [&](const int tri, const int pos) { new_tris[pos] = tris[tri]; },
+      exec_mode::grain_size(4096));
   if (use_custom_normals_) {
-    loop_normals_.append_n_times(data.normal, 3);
+    tri_normals_.resize(tris_start + valid_tris.size());
+    array_utils::gather(chunk_tri_normals_.as_span(),
+                        valid_tris,
+                        tri_normals_.as_mutable_span().drop_front(tris_start));
   }
-  return true;
+
+  chunk_corner_positions_.clear();
+  chunk_tri_normals_.clear();
+}
+
+/**
+ * Find the triangles that use the same vertices as a previous triangle, in any order.
+ * Only triangles that share their smallest vertex index can be equal, so every group of those is
+ * checked independently.
+ */
+static IndexMask find_unique_tris(const Span<Triangle> tris,
+                                  const int verts_num,
+                                  IndexMaskMemory &memory)
+{
+  const auto sorted_verts = [&](const int tri) {
+    std::array<int, 3> verts = {tris[tri].v1, tris[tri].v2, tris[tri].v3};
+    std::sort(verts.begin(), verts.end());
+    return verts;
+  };
+
+  Array<int> min_verts(tris.size());
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int tri : range) {
+      min_verts[tri] = std::min({tris[tri].v1, tris[tri].v2, tris[tri].v3});
+    }
+  });
+  Array<int> offsets_data(verts_num + 1, 0);
+  const OffsetIndices<int> offsets = offset_indices::build_reverse_offsets(min_verts,
+                                                                           offsets_data);
+  Array<int> vert_tris(tris.size());
+  offset_indices::reverse_indices_in_groups(min_verts, offsets, vert_tris);
+  min_verts = {};
+
+  Array<bool> is_duplicate(tris.size(), false);
+  threading::parallel_for(offsets.index_range(), 1024, [&](const IndexRange range) {
+    for (const int vert : range) {
+      MutableSpan<int> group = vert_tris.as_mutable_span().slice(offsets[vert]);
+      if (group.size() < 2) {
+        continue;
+      }
+      /* The indices are sorted, a stable sort keeps the first of equal triangles in front. */
+      std::stable_sort(group.begin(), group.end(), [&](const int a, const int b) {
+        return sorted_verts(a) < sorted_verts(b);
+      });
+      for (const int i : group.index_range().drop_front(1)) {
+        if (sorted_verts(group[i]) == sorted_verts(group[i - 1])) {
+          is_duplicate[group[i]] = true;
+        }
+      }
+    }
+  });
+
+  return IndexMask::from_bools_inverse(is_duplicate, memory);
 }
 
 Mesh *STLMeshHelper::to_mesh()
 {
+  this->merge_chunk();
+  chunk_corner_positions_.clear_and_shrink();
+  chunk_tri_normals_.clear_and_shrink();
+
+  IndexMaskMemory memory;
+  const IndexMask unique_tris = find_unique_tris(tris_, verts_num_, memory);
+
+  const int64_t duplicate_tris_num = tris_.size() - unique_tris.size();
   if (degenerate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", degenerate_tris_num_);
+    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", int(degenerate_tris_num_));
   }
-  if (duplicate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", duplicate_tris_num_);
+  if (duplicate_tris_num > 0) {
+    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", int(duplicate_tris_num));
   }
 
-  Mesh *mesh = BKE_mesh_new_nomain(verts_.size(), 0, tris_.size(), tris_.size() * 3);
-  mesh->vert_positions_for_write().copy_from(verts_);
+  Mesh *mesh = BKE_mesh_new_nomain(verts_num_, 0, unique_tris.size(), unique_tris.size() * 3);
+  MutableSpan<float3> vert_positions = mesh->vert_positions_for_write();
+  threading::parallel_for(vert_partitions_.index_range(), 1, [&](const IndexRange range) {
+    for (const int partition_i : range) {
+      VertPartition &partition = vert_partitions_[partition_i];
+      array_utils::scatter(
+          partition.positions.as_span(), partition.verts.as_span(), vert_positions);
+      partition.positions.clear();
+      partition.verts.clear_and_shrink();
+    }
+  });
   offset_indices::fill_constant_group_size(3, 0, mesh->face_offsets_for_write());
-  array_utils::copy(tris_.as_span().cast<int>(), mesh->corner_verts_for_write());
+  MutableSpan<Triangle> mesh_tris = mesh->corner_verts_for_write().cast<Triangle>();
+  unique_tris.foreach_index(
+      [&](const int tri, const int face) { mesh_tris[face] = tris_[tri]; },
+      exec_mode::grain_size(4096));
 
   bke::mesh_smooth_set(*mesh, false);
 
   /* NOTE: edges must be calculated first before setting custom normals. */
   bke::mesh_calc_edges(*mesh, false, false);
 
-  if (use_custom_normals_ && loop_normals_.size() == mesh->corners_num) {
-    bke::mesh_set_custom_normals(*mesh, loop_normals_);
+  if (use_custom_normals_ && tri_normals_.size() == tris_.size()) {
+    Array<float3> corner_normals(mesh->corners_num);
+    unique_tris.foreach_index(
+        [&](const int64_t tri, const int64_t face) {
+          corner_normals.as_mutable_span().slice(face * 3, 3).fill(tri_normals_[tri]);
+        },
+        exec_mode::grain_size(4096));
+    bke::mesh_set_custom_normals(*mesh, corner_normals);
   }
 
   return mesh;
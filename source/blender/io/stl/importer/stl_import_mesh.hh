@@ -10,7 +10,9 @@
 
 #include <cstdint>
 
+#include "BLI_array.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 #include "stl_data.hh"
@@ -51,22 +53,57 @@ class Triangle {
 
 class STLMeshHelper {
  private:
-  VectorSet<float3> verts_;
-  VectorSet<Triangle> tris_;
-  Vector<float3> loop_normals_;
-  int degenerate_tris_num_;
-  int duplicate_tris_num_;
+  /**
+   * Vertices are merged by position. The positions are partitioned by hash, so that every
+   * partition can be merged on its own thread.
+   */
+  struct VertPartition {
+    VectorSet<float3,
+              0,
+              DefaultProbingStrategy,
+              DefaultHash<float3>,
+              DefaultEquality<float3>,
+              SimpleVectorSetSlot<float3, int>>
+        positions;
+    /** The mesh vertex index of every position in the set. */
+    Vector<int> verts;
+  };
+  Array<VertPartition> vert_partitions_;
+  int verts_num_ = 0;
+
+  /** Triangles with merged vertices, without the degenerate ones. */
+  Vector<Triangle> tris_;
+  Vector<float3> tri_normals_;
+  int64_t degenerate_tris_num_ = 0;
+
+  /**
+   * Triangles that were added but whose vertices are not merged yet. They are merged in chunks of
+   * a fixed size, which bounds the memory used in addition to the resulting mesh data.
+   */
+  Vector<float3> chunk_corner_positions_;
+  Vector<float3> chunk_tri_normals_;
+  int64_t chunk_size_;
+
   const bool use_custom_normals_;
 
  public:
-  STLMeshHelper(int tris_num, bool use_custom_normals);
-
-  /* Creates a new triangle from specified vertex locations,
-   * duplicate vertices and triangles are merged.
+  /**
+   * \param chunk_size: Number of triangles whose vertices are merged at once, in parallel.
    */
-  bool add_triangle(const PackedTriangle &data);
+  STLMeshHelper(int tris_num, bool use_custom_normals, int64_t chunk_size = 1 << 16);
+
+  void add_triangle(const PackedTriangle &data);
+  /** Add triangles read from a binary file, in parallel. */
+  void add_triangles(Span<PackedTriangle> tris);
 
+  /**
+   * Create a mesh from the added triangles. Duplicate vertices and triangles are merged (in
+   * parallel), degenerate triangles are removed.
+   */
   Mesh *to_mesh();
+
+ private:
+  void merge_chunk();
 };
 
 }  // namespace io::stl
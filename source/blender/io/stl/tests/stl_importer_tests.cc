@@ -0,0 +1,157 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "BLI_array.hh"
+#include "BLI_fileops.hh"
+#include "BLI_path_utils.hh"
+
+#include "BKE_appdir.hh"
+#include "BKE_gtest_base.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "testing/testing.h"
+
+#include "stl_data.hh"
+#include "stl_import_ascii_reader.hh"
+#include "stl_import_binary_reader.hh"
+#include "stl_import_mesh.hh"
+
+namespace blender::io::stl {
+
+class STLImportTest : public bke::BlenderGTestBase {
+ public:
+  static std::string write_temp_file(const std::string &data)
+  {
+    BKE_tempdir_init(nullptr);
+    const std::string file_path = std::string(BKE_tempdir_base()) + SEP_STR +
+                                  "stl_import_test.stl";
+    FILE *file = BLI_fopen(file_path.c_str(), "wb");
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+    return file_path;
+  }
+
+  static Mesh *import_binary(const Span<PackedTriangle> tris)
+  {
+    std::string data(BINARY_HEADER_SIZE, ' ');
+    const uint32_t tris_num = uint32_t(tris.size());
+    data.append(reinterpret_cast<const char *>(&tris_num), sizeof(tris_num));
+    data.append(reinterpret_cast<const char *>(tris.data()), tris.size_in_bytes());
+    const std::string file_path = write_temp_file(data);
+    Mesh *mesh = read_stl_binary(file_path.c_str(), false);
+    BLI_delete(file_path.c_str(), false, false);
+    return mesh;
+  }
+
+  static Mesh *import_ascii(const Span<PackedTriangle> tris)
+  {
+    std::string data = "solid test\n";
+    for (const PackedTriangle &tri : tris) {
+      data += "facet normal 0 0 1\nouter loop\n";
+      for (const float3 &position : tri.vertices) {
+        data += "vertex " + std::to_string(position.x) + " " + std::to_string(position.y) + " " +
+                std::to_string(position.z) + "\n";
+      }
+      data += "endloop\nendfacet\n";
+    }
+    data += "endsolid test\n";
+    const std::string file_path = write_temp_file(data);
+    Mesh *mesh = read_stl_ascii(file_path.c_str(), false);
+    BLI_delete(file_path.c_str(), false, false);
+    return mesh;
+  }
+};
+
+static PackedTriangle packed_triangle(const float3 &a, const float3 &b, const float3 &c)
+{
+  PackedTriangle tri{};
+  tri.normal = float3(0.0f, 0.0f, 1.0f);
+  tri.vertices[0] = a;
+  tri.vertices[1] = b;
+  tri.vertices[2] = c;
+  return tri;
+}
+
+static void expect_equal_meshes(const Mesh &a, const Mesh &b)
+{
+  EXPECT_EQ_SPAN<float3>(a.vert_positions(), b.vert_positions());
+  EXPECT_EQ_SPAN<int>(a.corner_verts(), b.corner_verts());
+  EXPECT_EQ(a.faces_num, b.faces_num);
+  EXPECT_EQ(a.edges_num, b.edges_num);
+}
+
+TEST_F(STLImportTest, merge_vertices_and_triangles)
+{
+  const Array<PackedTriangle> tris = {
+      packed_triangle({0, 0, 0}, {1, 0, 0}, {1, 1, 0}),
+      packed_triangle({0, 0, 0}, {1, 1, 0}, {0, 1, 0}),
+      /* Duplicate of the first triangle with a different winding. */
+      packed_triangle({1, 1, 0}, {1, 0, 0}, {0, 0, 0}),
+      /* Degenerate triangle, its new vertex is still added. */
+      packed_triangle({2, 2, 2}, {2, 2, 2}, {0, 0, 0}),
+      packed_triangle({1, 0, 0}, {2, 0, 0}, {1, 1, 0}),
+  };
+
+  Mesh *mesh = import_binary(tris);
+  ASSERT_NE(mesh, nullptr);
+  const Array<float3> expected_positions = {
+      {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {2, 2, 2}, {2, 0, 0}};
+  EXPECT_EQ_SPAN<float3>(mesh->vert_positions(), expected_positions);
+  const Array<int> expected_corner_verts = {0, 1, 2, 0, 2, 3, 1, 5, 2};
+  EXPECT_EQ_SPAN<int>(mesh->corner_verts(), expected_corner_verts);
+  EXPECT_EQ(mesh->faces_num, 3);
+  EXPECT_EQ(mesh->edges_num, 7);
+
+  Mesh *ascii_mesh = import_ascii(tris);
+  ASSERT_NE(ascii_mesh, nullptr);
+  expect_equal_meshes(*mesh, *ascii_mesh);
+
+  BKE_id_free(nullptr, mesh);
+  BKE_id_free(nullptr, ascii_mesh);
+}
+
+TEST_F(STLImportTest, small_chunks)
+{
+  /* Triangles between the points of a coarse grid, so that many vertices and some triangles are
+   * shared between chunks. */
+  Vector<PackedTriangle> tris;
+  const auto grid_point = [](const int i) { return float3(i % 5, (i / 5) % 4, i / 20); };
+  for (const int i : IndexRange(3000)) {
+    tris.append(packed_triangle(
+        grid_point(i * 7 % 41), grid_point(i * 13 % 37), grid_point((i * i + 3) % 43)));
+  }
+
+  const auto import_chunked = [&](const int64_t chunk_size, const bool one_by_one) {
+    STLMeshHelper stl_mesh(tris.size(), false, chunk_size);
+    if (one_by_one) {
+      for (const PackedTriangle &tri : tris) {
+        stl_mesh.add_triangle(tri);
+      }
+    }
+    else {
+      stl_mesh.add_triangles(tris);
+    }
+    return stl_mesh.to_mesh();
+  };
+
+  Mesh *expected = import_binary(tris);
+  ASSERT_NE(expected, nullptr);
+  EXPECT_EQ(expected->verts_num, 42);
+  for (const int64_t chunk_size : {1, 2, 7, 1000}) {
+    for (const bool one_by_one : {false, true}) {
+      SCOPED_TRACE(chunk_size);
+      Mesh *mesh = import_chunked(chunk_size, one_by_one);
+      expect_equal_meshes(*expected, *mesh);
+      BKE_id_free(nullptr, mesh);
+    }
+  }
+  BKE_id_free(nullptr, expected);
+}
+
+}  // namespace blender::io::stl
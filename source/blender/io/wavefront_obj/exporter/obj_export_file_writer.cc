@@ -25,6 +25,7 @@
 #include "BLI_string.hh"
 #include "BLI_task.hh"
 
+#include "IO_chunked_output.hh"
 #include "IO_path_util.hh"
 
 #include "obj_export_mesh.hh"
@@ -244,7 +245,8 @@ static int calc_chunk_count(int count)
  * by a /function/ that should be independent from other items.
  * If the amount of items is large enough (> chunk_size), then writing
  * will be done in parallel, into temporary FormatHandler buffers that
- * will be written into the final /fh/ buffer at the end.
+ * will be written into the final /fh/ buffer at the end, or streamed
+ * to the file in order when /fh/ has a stream file.
  */
 template<typename Function>
 void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Function &function)
@@ -262,6 +264,20 @@ void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Functio
     }
     return;
   }
+  if (FILE *file = fh.stream_file()) {
+    /* Only a bounded number of chunk buffers is alive at any time. */
+    fh.write_to_file(file);
+    write_chunked_output<FormatHandler>(
+        tot_count,
+        chunk_size,
+        [&](const IndexRange range, FormatHandler &buf) {
+          for (const int i : range) {
+            function(buf, i);
+          }
+        },
+        [&](FormatHandler &buf) { buf.write_to_file(file); });
+    return;
+  }
   /* Give each chunk its own temporary output buffer, and process them in parallel. */
   Array<FormatHandler> buffers(chunk_count);
   threading::parallel_for(IndexRange(chunk_count), 1, [&](IndexRange range) {
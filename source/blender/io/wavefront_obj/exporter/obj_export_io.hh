@@ -24,16 +24,29 @@ namespace blender::io::obj {
  * (list of default 64 kilobyte blocks).
  * Call write_fo_file once in a while to write the memory buffer(s)
  * into the given file.
+ *
+ * With a stream file set, large parallel outputs are written to that file
+ * as they are produced instead of being gathered in the buffer first.
  */
 class FormatHandler : NonCopyable, NonMovable {
  private:
   using VectorChar = Vector<char>;
   Vector<VectorChar> blocks_;
   size_t buffer_chunk_size_;
+  FILE *stream_file_ = nullptr;
 
  public:
   FormatHandler(size_t buffer_chunk_size = 64 * 1024) : buffer_chunk_size_(buffer_chunk_size) {}
 
+  FILE *stream_file() const
+  {
+    return stream_file_;
+  }
+  void set_stream_file(FILE *f)
+  {
+    stream_file_ = f;
+  }
+
   /* Write contents to the buffer(s) into a file, and clear the buffers. */
   void write_to_file(FILE *f)
   {
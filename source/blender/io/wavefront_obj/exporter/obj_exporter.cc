@@ -166,9 +166,10 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
                                MTLWriter *mtl_writer,
                                const OBJExportParams &export_params)
 {
-  /* Parallelization is over meshes/objects, which means
-   * we have to have the output text buffer for each object,
-   * and write them all into the file at the end. */
+  /* Parallelization is over meshes/objects for small meshes, which means
+   * we have to have the output text buffer for each of them, and write
+   * them into the file in order. Large meshes are streamed to the file
+   * in parallel chunks instead, see #obj_parallel_chunked_output. */
   size_t count = exportable_as_mesh.size();
   Array<FormatHandler> buffers(count);
 
@@ -213,52 +214,87 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
     offsets.normal_offset += obj.get_normal_coords().size();
   }
 
-  /* Parallel over meshes: main result writing. */
-  threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
-    for (const int i : range) {
-      OBJMesh &obj = *exportable_as_mesh[i];
-      auto &fh = buffers[i];
+  /* Main result writing for a single mesh. */
+  auto write_mesh_object = [&](FormatHandler &fh, const int i) {
+    OBJMesh &obj = *exportable_as_mesh[i];
 
-      obj_writer.write_object_name(fh, obj);
-      obj_writer.write_vertex_coords(fh, obj, export_params.export_colors);
+    obj_writer.write_object_name(fh, obj);
+    obj_writer.write_vertex_coords(fh, obj, export_params.export_colors);
 
-      if (obj.tot_faces() > 0) {
-        if (export_params.export_smooth_groups) {
-          obj.calc_smooth_groups(export_params.smooth_groups_bitflags);
-        }
-        if (export_params.export_materials) {
-          obj.calc_face_order();
-        }
-        if (export_params.export_normals) {
-          obj_writer.write_normals(fh, obj);
-        }
-        if (export_params.export_uv) {
-          obj_writer.write_uv_coords(fh, obj);
-        }
-        /* This function takes a 0-indexed slot index for the obj_mesh object and
-         * returns the material name that we are using in the `.obj` file for it. */
-        const auto *obj_mtlindices = mtlindices.is_empty() ? nullptr : &mtlindices[i];
-        auto matname_fn = [&](int s) -> const char * {
-          if (!obj_mtlindices || s < 0 || s >= obj_mtlindices->size()) {
-            return nullptr;
-          }
-          return mtl_writer->mtlmaterial_name((*obj_mtlindices)[s]);
-        };
-        obj_writer.write_face_elements(fh, index_offsets[i], obj, matname_fn);
+    if (obj.tot_faces() > 0) {
+      if (export_params.export_smooth_groups) {
+        obj.calc_smooth_groups(export_params.smooth_groups_bitflags);
       }
-      obj_writer.write_edges_indices(fh, index_offsets[i], obj);
-
-      /* Nothing will need this object's data after this point, release
-       * various arrays here. */
-      obj.clear();
+      if (export_params.export_materials) {
+        obj.calc_face_order();
+      }
+      if (export_params.export_normals) {
+        obj_writer.write_normals(fh, obj);
+      }
+      if (export_params.export_uv) {
+        obj_writer.write_uv_coords(fh, obj);
+      }
+      /* This function takes a 0-indexed slot index for the obj_mesh object and
+       * returns the material name that we are using in the `.obj` file for it. */
+      const auto *obj_mtlindices = mtlindices.is_empty() ? nullptr : &mtlindices[i];
+      auto matname_fn = [&](int s) -> const char * {
+        if (!obj_mtlindices || s < 0 || s >= obj_mtlindices->size()) {
+          return nullptr;
+        }
+        return mtl_writer->mtlmaterial_name((*obj_mtlindices)[s]);
+      };
+      obj_writer.write_face_elements(fh, index_offsets[i], obj, matname_fn);
     }
-  });
+    obj_writer.write_edges_indices(fh, index_offsets[i], obj);
+
+    /* Nothing will need this object's data after this point, release
+     * various arrays here. */
+    obj.clear();
+  };
 
-  /* Write all the object text buffers into the output file. */
+  /* Parallel over a batch of consecutive small meshes, then write their
+   * text buffers into the output file. */
   FILE *f = obj_writer.get_outfile();
-  for (auto &b : buffers) {
-    b.write_to_file(f);
+  auto write_mesh_batch = [&](const IndexRange batch) {
+    threading::parallel_for(batch, 1, [&](IndexRange range) {
+      for (const int i : range) {
+        write_mesh_object(buffers[i], i);
+      }
+    });
+    for (const int i : batch) {
+      buffers[i].write_to_file(f);
+    }
+  };
+
+  /* Meshes with at least this many elements are streamed to the file on their own. */
+  const int64_t stream_min_elements = 64 * 1024;
+  /* Limit the amount of text buffered for a batch of small meshes. */
+  const int64_t batch_max_elements = 1024 * 1024;
+
+  int64_t batch_start = 0;
+  int64_t batch_elements = 0;
+  for (const int64_t i : IndexRange(count)) {
+    const OBJMesh &obj = *exportable_as_mesh[i];
+    const int64_t elements = int64_t(obj.tot_vertices()) + obj.tot_faces() +
+                             obj.tot_uv_vertices() + obj.get_normal_coords().size();
+    if (elements < stream_min_elements) {
+      batch_elements += elements;
+      if (batch_elements >= batch_max_elements) {
+        write_mesh_batch(IndexRange::from_begin_end_inclusive(batch_start, i));
+        batch_start = i + 1;
+        batch_elements = 0;
+      }
+      continue;
+    }
+    write_mesh_batch(IndexRange::from_begin_end(batch_start, i));
+    FormatHandler &fh = buffers[i];
+    fh.set_stream_file(f);
+    write_mesh_object(fh, int(i));
+    fh.write_to_file(f);
+    batch_start = i + 1;
+    batch_elements = 0;
   }
+  write_mesh_batch(IndexRange::from_begin_end(batch_start, count));
 }
 
 /**
@@ -8,6 +8,7 @@
 
 #include "BKE_report.hh"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.hh"
 #include "BLI_map.hh"
 #include "BLI_math_color_c.hh"
@@ -16,6 +17,7 @@
 #include "BLI_mmap.hh"
 #include "BLI_string.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "IO_string_utils.hh"
@@ -83,6 +85,38 @@ static Geometry *create_geometry(Geometry *const prev_geometry,
   return new_geometry();
 }
 
+/**
+ * Number of vertex positions, UVs and normals read before an element of the file. Used to resolve
+ * relative indices and check that indices are valid.
+ */
+struct VertexCounts {
+  int64_t verts = 0;
+  int64_t uvs = 0;
+  int64_t normals = 0;
+
+  friend VertexCounts operator+(const VertexCounts &a, const VertexCounts &b)
+  {
+    return {a.verts + b.verts, a.uvs + b.uvs, a.normals + b.normals};
+  }
+
+  friend bool operator==(const VertexCounts &a, const VertexCounts &b)
+  {
+    return a.verts == b.verts && a.uvs == b.uvs && a.normals == b.normals;
+  }
+};
+
+/**
+ * A face corner as written in the file. The indices are not validated yet, since that requires
+ * knowing how many vertices were read before in the whole file.
+ */
+struct RawFaceCorner {
+  int vert_index;
+  int uv_vert_index = -1;
+  int vertex_normal_index = -1;
+  bool got_uv = false;
+  bool got_normal = false;
+};
+
 static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
 {
   r_global_vertices.flush_mrgb_block();
@@ -187,11 +221,11 @@ static const char *parse_vertex_index(const char *p, const char *end, size_t n_e
 static void geom_add_polyline(Geometry *geom,
                               const char *p,
                               const char *end,
-                              GlobalVertices &r_global_vertices)
+                              const int64_t verts_num)
 {
   int last_vertex_index;
   p = drop_whitespace(p, end);
-  p = parse_vertex_index(p, end, r_global_vertices.vertices.size(), last_vertex_index);
+  p = parse_vertex_index(p, end, size_t(verts_num), last_vertex_index);
 
   if (last_vertex_index == INT32_MAX) {
     CLOG_WARN(&LOG, "Skipping invalid OBJ polyline.");
@@ -207,7 +241,7 @@ static void geom_add_polyline(Geometry *geom,
     /* Skip whitespace to get to the next vertex. */
     p = drop_whitespace(p, end);
 
-    p = parse_vertex_index(p, end, r_global_vertices.vertices.size(), vertex_index);
+    p = parse_vertex_index(p, end, size_t(verts_num), vertex_index);
     if (vertex_index == INT32_MAX) {
       break;
     }
@@ -218,30 +252,16 @@ static void geom_add_polyline(Geometry *geom,
   }
 }
 
-static void geom_add_polygon(Geometry *geom,
-                             const char *p,
-                             const char *end,
-                             const GlobalVertices &global_vertices,
-                             const int material_index,
-                             const int group_index,
-                             const bool shaded_smooth)
+/**
+ * Parse the corners of a face, without validating the indices (see #geom_add_polygon).
+ */
+static void parse_polygon_corners(const char *p,
+                                  const char *end,
+                                  Vector<RawFaceCorner> &r_corners)
 {
-  FaceElem curr_face;
-  curr_face.shaded_smooth = shaded_smooth;
-  curr_face.material_index = material_index;
-  if (group_index >= 0) {
-    curr_face.vertex_group_index = group_index;
-    geom->has_vertex_groups_ = true;
-  }
-
-  const int orig_corners_size = geom->face_corners_.size();
-  curr_face.start_index_ = orig_corners_size;
-
-  bool face_valid = true;
   p = drop_whitespace(p, end);
-  while (p < end && face_valid) {
-    FaceCorner corner;
-    bool got_uv = false, got_normal = false;
+  while (p < end) {
+    RawFaceCorner corner;
     /* Parse vertex index. */
     p = parse_int(p, end, INT32_MAX, corner.vert_index, false);
 
@@ -250,68 +270,100 @@ static void geom_add_polygon(Geometry *geom,
       break;
     }
 
-    face_valid &= corner.vert_index != INT32_MAX;
     if (p < end && *p == '/') {
       /* Parse UV index. */
       ++p;
       if (p < end && *p != '/') {
         p = parse_int(p, end, INT32_MAX, corner.uv_vert_index, false);
-        got_uv = corner.uv_vert_index != INT32_MAX;
+        corner.got_uv = corner.uv_vert_index != INT32_MAX;
       }
       /* Parse normal index. */
       if (p < end && *p == '/') {
         ++p;
         p = parse_int(p, end, INT32_MAX, corner.vertex_normal_index, false);
-        got_normal = corner.vertex_normal_index != INT32_MAX;
+        corner.got_normal = corner.vertex_normal_index != INT32_MAX;
       }
     }
+    r_corners.append(corner);
+    if (corner.vert_index == INT32_MAX) {
+      /* The face is invalid, no need to parse the remaining corners. */
+      break;
+    }
+
+    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
+    p = drop_non_whitespace(p, end);
+    /* Skip whitespace to get to the next face corner. */
+    p = drop_whitespace(p, end);
+  }
+}
+
+static void geom_add_polygon(Geometry *geom,
+                             const Span<RawFaceCorner> raw_corners,
+                             const VertexCounts &counts,
+                             const int material_index,
+                             const int group_index,
+                             const bool shaded_smooth)
+{
+  FaceElem curr_face;
+  curr_face.shaded_smooth = shaded_smooth;
+  curr_face.material_index = material_index;
+  if (group_index >= 0) {
+    curr_face.vertex_group_index = group_index;
+    geom->has_vertex_groups_ = true;
+  }
+
+  const int orig_corners_size = geom->face_corners_.size();
+  curr_face.start_index_ = orig_corners_size;
+
+  bool face_valid = true;
+  for (const RawFaceCorner &raw_corner : raw_corners) {
+    FaceCorner corner;
+    corner.vert_index = raw_corner.vert_index;
+    corner.uv_vert_index = raw_corner.uv_vert_index;
+    corner.vertex_normal_index = raw_corner.vertex_normal_index;
+
+    face_valid &= corner.vert_index != INT32_MAX;
     /* Always keep stored indices non-negative and zero-based. */
-    corner.vert_index += corner.vert_index < 0 ? global_vertices.vertices.size() : -1;
-    if (corner.vert_index < 0 || corner.vert_index >= global_vertices.vertices.size()) {
+    corner.vert_index += corner.vert_index < 0 ? counts.verts : -1;
+    if (corner.vert_index < 0 || corner.vert_index >= counts.verts) {
       CLOG_WARN(&LOG,
                 "Invalid vertex index %i (valid range [0, %zu)), ignoring face",
                 corner.vert_index,
-                size_t(global_vertices.vertices.size()));
+                size_t(counts.verts));
       face_valid = false;
     }
     else {
       geom->track_vertex_index(corner.vert_index);
     }
     /* Ignore UV index, if the geometry does not have any UVs (#103212). */
-    if (got_uv && !global_vertices.uv_vertices.is_empty()) {
-      corner.uv_vert_index += corner.uv_vert_index < 0 ? global_vertices.uv_vertices.size() : -1;
-      if (corner.uv_vert_index < 0 || corner.uv_vert_index >= global_vertices.uv_vertices.size()) {
+    if (raw_corner.got_uv && counts.uvs != 0) {
+      corner.uv_vert_index += corner.uv_vert_index < 0 ? counts.uvs : -1;
+      if (corner.uv_vert_index < 0 || corner.uv_vert_index >= counts.uvs) {
         CLOG_WARN(&LOG,
                   "Invalid UV index %i (valid range [0, %zu)), ignoring face",
                   corner.uv_vert_index,
-                  size_t(global_vertices.uv_vertices.size()));
+                  size_t(counts.uvs));
         face_valid = false;
       }
     }
     /* Ignore corner normal index, if the geometry does not have any normals.
      * Some obj files out there do have face definitions that refer to normal indices,
      * without any normals being present (#98782). */
-    if (got_normal && !global_vertices.vert_normals.is_empty()) {
-      corner.vertex_normal_index += corner.vertex_normal_index < 0 ?
-                                        global_vertices.vert_normals.size() :
-                                        -1;
-      if (corner.vertex_normal_index < 0 ||
-          corner.vertex_normal_index >= global_vertices.vert_normals.size())
-      {
+    if (raw_corner.got_normal && counts.normals != 0) {
+      corner.vertex_normal_index += corner.vertex_normal_index < 0 ? counts.normals : -1;
+      if (corner.vertex_normal_index < 0 || corner.vertex_normal_index >= counts.normals) {
         CLOG_WARN(&LOG,
                   "Invalid normal index %i (valid range [0, %zu)), ignoring face",
                   corner.vertex_normal_index,
-                  size_t(global_vertices.vert_normals.size()));
+                  size_t(counts.normals));
         face_valid = false;
       }
     }
     geom->face_corners_.append(corner);
     curr_face.corner_count_++;
-
-    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
-    p = drop_non_whitespace(p, end);
-    /* Skip whitespace to get to the next face corner. */
-    p = drop_whitespace(p, end);
+    if (!face_valid) {
+      break;
+    }
   }
 
   if (face_valid) {
@@ -349,7 +401,7 @@ static void geom_set_curve_degree(Geometry *geom, const char *p, const char *end
 static void geom_add_curve_vertex_indices(Geometry *geom,
                                           const char *p,
                                           const char *end,
-                                          const GlobalVertices &global_vertices)
+                                          const int64_t verts_num)
 {
   /* Parse curve parameter range. */
   p = parse_floats(p, end, 0, geom->nurbs_element_.range, 2);
@@ -361,8 +413,8 @@ static void geom_add_curve_vertex_indices(Geometry *geom,
       return;
     }
     /* Always keep stored indices non-negative and zero-based. */
-    index += index < 0 ? global_vertices.vertices.size() : -1;
-    if (!validate::index_in_range(index, global_vertices.vertices.size())) {
+    index += index < 0 ? verts_num : -1;
+    if (!validate::index_in_range(index, verts_num)) {
       index = 0;
     }
     geom->nurbs_element_.curv_indices.append(index);
@@ -508,7 +560,7 @@ static void use_all_vertices_if_no_faces(Geometry *geom,
 /* OBJ file format supports "line continuations", which
  * are back-slashes, optionally followed by whitespace.
  * The line virtually extends to the next line in that case. */
-StringRef OBJParser::read_next_obj_line(StringRef &buffer)
+static StringRef read_next_obj_line(StringRef &buffer, string &line_buffer)
 {
   const char *start = buffer.begin();
   const char *end = buffer.end();
@@ -529,7 +581,7 @@ StringRef OBJParser::read_next_obj_line(StringRef &buffer)
   /* We have backslash. Copy into line buffer, replace
    * line continuation with space, return result. */
 
-  line_buffer_.assign(start, ptr);
+  line_buffer.assign(start, ptr);
 
   while (ptr < end) {
     char c = *ptr++;
@@ -541,41 +593,102 @@ StringRef OBJParser::read_next_obj_line(StringRef &buffer)
       }
       if (ahead < end && *ahead == '\n') {
         /* Line continuation: replace backslash & newline with space. */
-        line_buffer_ += ' ';
+        line_buffer += ' ';
         ptr = ahead + 1; /* Continue after the newline. */
       }
       else {
         /* Not a continuation: keep the backslash. */
-        line_buffer_ += c;
+        line_buffer += c;
       }
     }
     else if (c == '\n') {
       break;
     }
     else {
-      line_buffer_ += c;
+      line_buffer += c;
     }
   }
 
   buffer = StringRef(ptr, end);
-  return line_buffer_;
+  return line_buffer;
 }
 
-void OBJParser::parse_string_buffer(StringRef &buffer_str,
-                                    Vector<std::unique_ptr<Geometry>> &r_all_geometries,
-                                    GlobalVertices &r_global_vertices,
-                                    Geometry *&curr_geom)
+/**
+ * Split the buffer into chunks of approximately the given size, at line boundaries. Line
+ * continuations are never split.
+ */
+static Vector<StringRef> split_into_line_chunks(const StringRef buffer,
+                                                const int64_t approximate_chunk_size)
 {
-  /* State variables: once set, they remain the same for the remaining
-   * elements in the object. */
-  bool state_shaded_smooth = false;
-  string state_group_name;
-  int state_group_index = -1;
-  string state_material_name;
-  int state_material_index = -1;
+  Vector<StringRef> chunks;
+  const char *start = buffer.begin();
+  const char *buffer_end = buffer.end();
+  while (start < buffer_end) {
+    const char *end = start + std::min<int64_t>(approximate_chunk_size, buffer_end - start);
+    while (end < buffer_end) {
+      end = std::find(end, buffer_end, '\n');
+      if (end == buffer_end) {
+        break;
+      }
+      /* A backslash followed by whitespace only continues the line, see #read_next_obj_line. */
+      const char *prev = end;
+      while (prev > start && prev[-1] <= ' ' && prev[-1] != '\n') {
+        --prev;
+      }
+      ++end;
+      if (prev == start || prev[-1] != '\\') {
+        break;
+      }
+    }
+    chunks.append(StringRef(start, end));
+    start = end;
+  }
+  return chunks;
+}
+
+/**
+ * Elements parsed from a part of the file. Vertex data and faces are parsed independently for all
+ * chunks. Everything that depends on the elements that come before in the file (objects, groups,
+ * materials, curves, ...) is kept as text, and handled when the chunks are added in order.
+ */
+struct OBJChunk {
+  /** Vertex data of this chunk only, the indices are relative to the start of the chunk. */
+  GlobalVertices vertices;
+  /** Corners of all faces in order. */
+  Vector<RawFaceCorner> face_corners;
+  /** Number of corners of each face. */
+  Vector<int> face_sizes;
+  /**
+   * Lines with other elements, and their index in the chunk. Elements are faces and these lines,
+   * in the order they appear in the file.
+   */
+  Vector<std::pair<int64_t, string>> lines;
+  /** Vertex counts in the chunk at every element where they changed. */
+  Vector<std::pair<int64_t, VertexCounts>> counts;
+  /** Only handled correctly when the file is parsed as a single chunk. */
+  bool has_mrgb_colors = false;
+
+  int64_t elements_num() const
+  {
+    return face_sizes.size() + lines.size();
+  }
+};
+
+static void parse_chunk(StringRef buffer_str, OBJChunk &r_chunk, string &line_buffer)
+{
+  GlobalVertices &vertices = r_chunk.vertices;
+  VertexCounts recorded_counts;
+  auto record_counts = [&]() {
+    const VertexCounts counts{
+        vertices.vertices.size(), vertices.uv_vertices.size(), vertices.vert_normals.size()};
+    if (!(counts == recorded_counts)) {
+      r_chunk.counts.append({r_chunk.elements_num(), counts});
+      recorded_counts = counts;
+    }
+  };
 
   while (!buffer_str.is_empty()) {
-    StringRef line = read_next_obj_line(buffer_str);
+    StringRef line = read_next_obj_line(buffer_str, line_buffer);
     const char *p = line.begin(), *end = line.end();
     p = drop_whitespace(p, end);
     if (p == end) {
@@ -584,119 +697,227 @@ void OBJParser::parse_string_buffer(StringRef &buffer_str,
     /* Most common things that start with 'v': vertices, normals, UVs. */
     if (*p == 'v') {
       if (parse_keyword(p, end, "v")) {
-        geom_add_vertex(p, end, r_global_vertices);
+        geom_add_vertex(p, end, vertices);
       }
       else if (parse_keyword(p, end, "vn")) {
-        geom_add_vertex_normal(p, end, r_global_vertices);
+        geom_add_vertex_normal(p, end, vertices);
       }
       else if (parse_keyword(p, end, "vt")) {
-        geom_add_uv_vertex(p, end, r_global_vertices);
+        geom_add_uv_vertex(p, end, vertices);
       }
     }
     /* Faces. */
     else if (parse_keyword(p, end, "f")) {
-      /* If we don't have a material index assigned yet, get one.
-       * It means "usemtl" state came from the previous object. */
-      if (state_material_index == -1 && !state_material_name.empty() &&
-          curr_geom->material_indices_.is_empty())
-      {
-        curr_geom->material_indices_.add_new(state_material_name, 0);
-        curr_geom->material_order_.append(state_material_name);
-        state_material_index = 0;
-      }
-
-      geom_add_polygon(curr_geom,
-                       p,
-                       end,
-                       r_global_vertices,
-                       state_material_index,
-                       state_group_index,
-                       state_shaded_smooth);
-    }
-    /* Faces. */
-    else if (parse_keyword(p, end, "l")) {
-      geom_add_polyline(curr_geom, p, end, r_global_vertices);
-    }
-    /* Objects. */
-    else if (parse_keyword(p, end, "o")) {
-      if (import_params_.use_split_objects) {
-        geom_new_object(p,
-                        end,
-                        state_shaded_smooth,
-                        state_group_name,
-                        state_material_index,
-                        curr_geom,
-                        r_all_geometries);
-      }
-    }
-    /* Groups. */
-    else if (parse_keyword(p, end, "g")) {
-      if (import_params_.use_split_groups) {
-        geom_new_object(p,
-                        end,
-                        state_shaded_smooth,
-                        state_group_name,
-                        state_material_index,
-                        curr_geom,
-                        r_all_geometries);
-      }
-      else {
-        geom_update_group(StringRef(p, end).trim(), state_group_name);
-        int new_index = curr_geom->group_indices_.size();
-        state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name, new_index);
-        if (new_index == state_group_index) {
-          curr_geom->group_order_.append(state_group_name);
-        }
-      }
-    }
-    /* Smoothing groups. */
-    else if (parse_keyword(p, end, "s")) {
-      geom_update_smooth_group(p, end, state_shaded_smooth);
-    }
-    /* Materials and their libraries. */
-    else if (parse_keyword(p, end, "usemtl")) {
-      state_material_name = StringRef(p, end).trim();
-      int new_mat_index = curr_geom->material_indices_.size();
-      state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
-                                                                        new_mat_index);
-      if (new_mat_index == state_material_index) {
-        curr_geom->material_order_.append(state_material_name);
-      }
-    }
-    else if (parse_keyword(p, end, "mtllib")) {
-      add_mtl_library(StringRef(p, end).trim());
+      record_counts();
+      const int64_t corners_start = r_chunk.face_corners.size();
+      parse_polygon_corners(p, end, r_chunk.face_corners);
+      r_chunk.face_sizes.append(int(r_chunk.face_corners.size() - corners_start));
     }
     else if (parse_keyword(p, end, "#MRGB")) {
-      geom_add_mrgb_colors(p, end, r_global_vertices);
+      geom_add_mrgb_colors(p, end, vertices);
+      r_chunk.has_mrgb_colors = true;
     }
     /* Comments. */
     else if (*p == '#') {
       /* Nothing to do. */
     }
-    /* Curve related things. */
-    else if (parse_keyword(p, end, "cstype")) {
-      curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
+    else {
+      record_counts();
+      r_chunk.lines.append({r_chunk.elements_num(), string(p, end)});
+    }
+  }
+  vertices.flush_mrgb_block();
+}
+
+/**
+ * Copy the vertex data of all chunks into the global arrays.
+ */
+static void join_chunk_vertices(const Span<OBJChunk> chunks,
+                                const Span<VertexCounts> chunk_offsets,
+                                const VertexCounts &total,
+                                GlobalVertices &r_global_vertices)
+{
+  r_global_vertices.vertices.resize(total.verts);
+  r_global_vertices.uv_vertices.resize(total.uvs);
+  r_global_vertices.vert_normals.resize(total.normals);
+
+  /* Colors and weights are only stored up to the last vertex that has them. */
+  int64_t colors_num = 0;
+  int64_t weights_num = 0;
+  for (const int64_t i : chunks.index_range()) {
+    const GlobalVertices &vertices = chunks[i].vertices;
+    if (!vertices.vertex_colors.is_empty()) {
+      colors_num = chunk_offsets[i].verts + vertices.vertex_colors.size();
     }
-    else if (parse_keyword(p, end, "deg")) {
-      geom_set_curve_degree(curr_geom, p, end);
+    if (!vertices.vertex_weights.is_empty()) {
+      weights_num = chunk_offsets[i].verts + vertices.vertex_weights.size();
     }
-    else if (parse_keyword(p, end, "curv")) {
-      geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
+  }
+  r_global_vertices.vertex_colors.resize(colors_num, float3(-1.0, -1.0, -1.0));
+  r_global_vertices.vertex_weights.resize(weights_num, 1.0);
+
+  threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const GlobalVertices &vertices = chunks[i].vertices;
+      const VertexCounts &offset = chunk_offsets[i];
+      r_global_vertices.vertices.as_mutable_span()
+          .slice(offset.verts, vertices.vertices.size())
+          .copy_from(vertices.vertices);
+      r_global_vertices.uv_vertices.as_mutable_span()
+          .slice(offset.uvs, vertices.uv_vertices.size())
+          .copy_from(vertices.uv_vertices);
+      r_global_vertices.vert_normals.as_mutable_span()
+          .slice(offset.normals, vertices.vert_normals.size())
+          .copy_from(vertices.vert_normals);
+      r_global_vertices.vertex_colors.as_mutable_span()
+          .slice(offset.verts, vertices.vertex_colors.size())
+          .copy_from(vertices.vertex_colors);
+      r_global_vertices.vertex_weights.as_mutable_span()
+          .slice(offset.verts, vertices.vertex_weights.size())
+          .copy_from(vertices.vertex_weights);
     }
-    else if (parse_keyword(p, end, "parm")) {
-      geom_add_curve_parameters(curr_geom, p, end);
+  });
+}
+
+/**
+ * State variables: once set, they remain the same for the remaining elements in the object.
+ */
+struct ParseState {
+  bool shaded_smooth = false;
+  string group_name;
+  int group_index = -1;
+  string material_name;
+  int material_index = -1;
+};
+
+void OBJParser::add_chunk_line(StringRef line,
+                               const VertexCounts &counts,
+                               ParseState &state,
+                               Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                               Geometry *&curr_geom)
+{
+  const char *p = line.begin(), *end = line.end();
+  if (parse_keyword(p, end, "l")) {
+    geom_add_polyline(curr_geom, p, end, counts.verts);
+  }
+  /* Objects. */
+  else if (parse_keyword(p, end, "o")) {
+    if (import_params_.use_split_objects) {
+      geom_new_object(p,
+                      end,
+                      state.shaded_smooth,
+                      state.group_name,
+                      state.material_index,
+                      curr_geom,
+                      r_all_geometries);
     }
-    else if (StringRef(p, end).startswith("end")) {
-      /* End of curve definition, nothing else to do. */
+  }
+  /* Groups. */
+  else if (parse_keyword(p, end, "g")) {
+    if (import_params_.use_split_groups) {
+      geom_new_object(p,
+                      end,
+                      state.shaded_smooth,
+                      state.group_name,
+                      state.material_index,
+                      curr_geom,
+                      r_all_geometries);
     }
     else {
-      CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", string(p, end).c_str());
+      geom_update_group(StringRef(p, end).trim(), state.group_name);
+      int new_index = curr_geom->group_indices_.size();
+      state.group_index = curr_geom->group_indices_.lookup_or_add(state.group_name, new_index);
+      if (new_index == state.group_index) {
+        curr_geom->group_order_.append(state.group_name);
+      }
+    }
+  }
+  /* Smoothing groups. */
+  else if (parse_keyword(p, end, "s")) {
+    geom_update_smooth_group(p, end, state.shaded_smooth);
+  }
+  /* Materials and their libraries. */
+  else if (parse_keyword(p, end, "usemtl")) {
+    state.material_name = StringRef(p, end).trim();
+    int new_mat_index = curr_geom->material_indices_.size();
+    state.material_index = curr_geom->material_indices_.lookup_or_add(state.material_name,
+                                                                      new_mat_index);
+    if (new_mat_index == state.material_index) {
+      curr_geom->material_order_.append(state.material_name);
     }
   }
+  else if (parse_keyword(p, end, "mtllib")) {
+    add_mtl_library(StringRef(p, end).trim());
+  }
+  /* Curve related things. */
+  else if (parse_keyword(p, end, "cstype")) {
+    curr_geom = geom_set_curve_type(curr_geom, p, end, state.group_name, r_all_geometries);
+  }
+  else if (parse_keyword(p, end, "deg")) {
+    geom_set_curve_degree(curr_geom, p, end);
+  }
+  else if (parse_keyword(p, end, "curv")) {
+    geom_add_curve_vertex_indices(curr_geom, p, end, counts.verts);
+  }
+  else if (parse_keyword(p, end, "parm")) {
+    geom_add_curve_parameters(curr_geom, p, end);
+  }
+  else if (StringRef(p, end).startswith("end")) {
+    /* End of curve definition, nothing else to do. */
+  }
+  else {
+    CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", string(p, end).c_str());
+  }
+}
+
+void OBJParser::add_chunk_elements(const OBJChunk &chunk,
+                                   const VertexCounts &offset,
+                                   ParseState &state,
+                                   Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                                   Geometry *&curr_geom)
+{
+  const Span<RawFaceCorner> face_corners = chunk.face_corners;
+  VertexCounts counts = offset;
+  int64_t face_i = 0;
+  int64_t corner_i = 0;
+  int64_t line_i = 0;
+  int64_t counts_i = 0;
+  for (const int64_t element_i : IndexRange(chunk.elements_num())) {
+    if (counts_i < chunk.counts.size() && chunk.counts[counts_i].first == element_i) {
+      counts = offset + chunk.counts[counts_i].second;
+      counts_i++;
+    }
+    if (line_i < chunk.lines.size() && chunk.lines[line_i].first == element_i) {
+      add_chunk_line(chunk.lines[line_i].second, counts, state, r_all_geometries, curr_geom);
+      line_i++;
+      continue;
+    }
+
+    /* If we don't have a material index assigned yet, get one.
+     * It means "usemtl" state came from the previous object. */
+    if (state.material_index == -1 && !state.material_name.empty() &&
+        curr_geom->material_indices_.is_empty())
+    {
+      curr_geom->material_indices_.add_new(state.material_name, 0);
+      curr_geom->material_order_.append(state.material_name);
+      state.material_index = 0;
+    }
+
+    const int face_size = chunk.face_sizes[face_i];
+    geom_add_polygon(curr_geom,
+                     face_corners.slice(corner_i, face_size),
+                     counts,
+                     state.material_index,
+                     state.group_index,
+                     state.shaded_smooth);
+    corner_i += face_size;
+    face_i++;
+  }
 }
 
 void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
-                      GlobalVertices &r_global_vertices)
+                      GlobalVertices &r_global_vertices,
+                      const int64_t chunk_size)
 {
   if (!mmap_file_) {
     return;
@@ -712,7 +933,47 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
   const char *file_data = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file_));
   size_t file_size = BLI_mmap_get_length(mmap_file_);
   StringRef buffer_str{file_data, int64_t(file_size)};
-  OBJParser::parse_string_buffer(buffer_str, r_all_geometries, r_global_vertices, curr_geom);
+
+  /* Parse vertex data and faces of all parts of the file in parallel. */
+  const Vector<StringRef> chunk_buffers = split_into_line_chunks(buffer_str, chunk_size);
+  Array<OBJChunk> chunks(chunk_buffers.size());
+  threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+    string line_buffer;
+    for (const int64_t i : range) {
+      parse_chunk(chunk_buffers[i], chunks[i], line_buffer);
+    }
+  });
+
+  /* The #MRGB colors apply to the vertices that come before them, possibly across chunks. This
+   * extension is rare, parse the file on a single thread in that case. */
+  if (chunks.size() > 1 &&
+      std::any_of(chunks.begin(), chunks.end(), [](const OBJChunk &chunk) {
+        return chunk.has_mrgb_colors;
+      }))
+  {
+    chunks.reinitialize(1);
+    string line_buffer;
+    parse_chunk(buffer_str, chunks[0], line_buffer);
+  }
+
+  /* Compute where the vertex data of each chunk starts in the whole file. */
+  Array<VertexCounts> chunk_offsets(chunks.size());
+  VertexCounts total;
+  for (const int64_t i : chunks.index_range()) {
+    chunk_offsets[i] = total;
+    const GlobalVertices &vertices = chunks[i].vertices;
+    total = total + VertexCounts{vertices.vertices.size(),
+                                 vertices.uv_vertices.size(),
+                                 vertices.vert_normals.size()};
+  }
+  join_chunk_vertices(chunks, chunk_offsets, total, r_global_vertices);
+
+  /* Add the other elements in order, since they depend on the state of the previous elements. */
+  ParseState state;
+  for (const int64_t i : chunks.index_range()) {
+    add_chunk_elements(chunks[i], chunk_offsets[i], state, r_all_geometries, curr_geom);
+    chunks[i] = {};
+  }
 
   r_global_vertices.flush_mrgb_block();
   use_all_vertices_if_no_faces(curr_geom, r_all_geometries, r_global_vertices);
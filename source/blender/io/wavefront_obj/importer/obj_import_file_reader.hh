@@ -22,13 +22,15 @@ struct BLI_mmap_file;
 namespace blender::io::obj {
 
 struct MTLMaterial;
+struct OBJChunk;
+struct ParseState;
+struct VertexCounts;
 
 class OBJParser {
  private:
   const OBJImportParams &import_params_;
   Vector<std::string> mtl_libraries_;
   BLI_mmap_file *mmap_file_ = nullptr;
-  std::string line_buffer_;
 
  public:
   /**
@@ -38,11 +40,18 @@ class OBJParser {
   ~OBJParser();
 
   /**
-   * Read the OBJ file line by line and create OBJ Geometry instances. Also store all the vertex
+   * Read the OBJ file and create OBJ Geometry instances. Also store all the vertex
    * and UV vertex coordinates in a struct accessible by all objects.
+   *
+   * Parts of the file are parsed in parallel, the elements that depend on the previous ones
+   * (objects, groups, materials, ...) are then added in order.
+   *
+   * \param chunk_size: Approximate size in bytes of the parts of the file that are parsed in
+   * parallel. Files smaller than this are parsed on a single thread.
    */
   void parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
-             GlobalVertices &r_global_vertices);
+             GlobalVertices &r_global_vertices,
+             int64_t chunk_size = 1024 * 1024);
   /**
    * Return a list of all material library filepaths referenced by the OBJ file.
    */
@@ -51,11 +60,20 @@ class OBJParser {
  private:
   void add_mtl_library(StringRef path);
   void add_default_mtl_library();
-  StringRef read_next_obj_line(StringRef &buffer);
-  void parse_string_buffer(StringRef &buffer_str,
-                           Vector<std::unique_ptr<Geometry>> &r_all_geometries,
-                           GlobalVertices &r_global_vertices,
-                           Geometry *&curr_geom);
+  /**
+   * Add the faces and other elements of a chunk of the file that was parsed independently, in
+   * the state left by the previous chunks.
+   */
+  void add_chunk_elements(const OBJChunk &chunk,
+                          const VertexCounts &offset,
+                          ParseState &state,
+                          Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                          Geometry *&curr_geom);
+  void add_chunk_line(StringRef line,
+                      const VertexCounts &counts,
+                      ParseState &state,
+                      Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                      Geometry *&curr_geom);
 };
 
 class MTLParser {
@@ -13,10 +13,18 @@
 #include "BKE_appdir.hh"
 #include "BKE_blender_version.h"
 #include "BKE_gtest_base.hh"
+#include "BKE_layer.hh"
 #include "BKE_main.hh"
+#include "BKE_mesh.h"
+#include "BKE_mesh.hh"
+#include "BKE_object.hh"
 
 #include "BLI_fileops.hh"
 #include "BLI_string.hh"
+#include "BLI_threads.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_scene_types.h"
 
 #include "BLO_readfile.hh"
 
@@ -237,6 +245,100 @@ parm u 0.000000
   ASSERT_EQ(got_string, expected);
 }
 
+/** Add a grid object with enough vertices and faces to be written in multiple chunks. */
+static void add_grid_object(BlendFileData &bfile, const int size)
+{
+  const int faces_num = (size - 1) * (size - 1);
+  Mesh *grid = BKE_mesh_new_nomain(size * size, 0, faces_num, faces_num * 4);
+  MutableSpan<float3> positions = grid->vert_positions_for_write();
+  MutableSpan<int> face_offsets = grid->face_offsets_for_write();
+  MutableSpan<int> corner_verts = grid->corner_verts_for_write();
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      positions[y * size + x] = float3(x * 0.1f, y * 0.1f, float((x * y) % 7) * 0.01f);
+    }
+  }
+  for (const int y : IndexRange(size - 1)) {
+    for (const int x : IndexRange(size - 1)) {
+      const int face = y * (size - 1) + x;
+      face_offsets[face] = face * 4;
+      corner_verts[face * 4 + 0] = y * size + x;
+      corner_verts[face * 4 + 1] = y * size + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * size + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * size + x;
+    }
+  }
+  face_offsets.last() = faces_num * 4;
+  bke::mesh_calc_edges(*grid, false, false);
+
+  Mesh *mesh = BKE_mesh_add(bfile.main, "Grid");
+  BKE_mesh_nomain_to_mesh(grid, mesh, nullptr);
+  BKE_object_add_for_data(
+      bfile.main, bfile.curscene, bfile.cur_view_layer, OB_MESH, "Grid", &mesh->id, false);
+  BKE_view_layer_synced_ensure(*bfile.main, bfile.curscene, bfile.cur_view_layer);
+}
+
+/** Write the mesh like #write_mesh_objects does, optionally streaming it to the file. */
+static std::string write_obj_mesh(Depsgraph *depsgraph,
+                                  const OBJExportParams &params,
+                                  const int verts_num,
+                                  const std::string &filepath,
+                                  const bool stream)
+{
+  auto [objmeshes, objcurves]{filter_supported_objects(depsgraph, params)};
+  for (std::unique_ptr<OBJMesh> &obj : objmeshes) {
+    if (obj->tot_vertices() != verts_num) {
+      continue;
+    }
+    {
+      OBJWriter writer(filepath.c_str(), params);
+      FormatHandler fh;
+      if (stream) {
+        fh.set_stream_file(writer.get_outfile());
+      }
+      const IndexOffsets offsets{0, 0, 0};
+      writer.write_object_name(fh, *obj);
+      writer.write_vertex_coords(fh, *obj, false);
+      writer.write_normals(fh, *obj);
+      writer.write_uv_coords(fh, *obj);
+      writer.write_face_elements(fh, offsets, *obj, [](int) -> const char * { return nullptr; });
+      writer.write_edges_indices(fh, offsets, *obj);
+      fh.write_to_file(writer.get_outfile());
+    }
+    return read_temp_file_in_string(filepath);
+  }
+  ADD_FAILURE() << "Grid mesh not found";
+  return {};
+}
+
+TEST_F(OBJExportTest, streamed_mesh_matches_buffered_mesh)
+{
+  if (!blendfile_load(all_objects_file.c_str())) {
+    ADD_FAILURE();
+    return;
+  }
+  /* Large enough for the vertices and faces to be split into several chunks. */
+  const int size = 400;
+  add_grid_object(*bfile, size);
+  depsgraph_create(DAG_EVAL_VIEWPORT);
+
+  BKE_tempdir_init(nullptr);
+  const std::string filepath = std::string(BKE_tempdir_base()) + SEP_STR + "streamed_mesh.obj";
+  OBJExportParams params;
+  const std::string buffered = write_obj_mesh(depsgraph, params, size * size, filepath, false);
+  ASSERT_FALSE(buffered.empty());
+  /* With a single thread, the chunks don't fit into one window of the ring of buffers. */
+  for (const int threads_num : {1, 0}) {
+    SCOPED_TRACE(threads_num);
+    BLI_system_num_threads_override_set(threads_num);
+    const std::string streamed = write_obj_mesh(depsgraph, params, size * size, filepath, true);
+    EXPECT_EQ(streamed.size(), buffered.size());
+    EXPECT_TRUE(streamed == buffered);
+  }
+  BLI_system_num_threads_override_set(0);
+  BLI_delete(filepath.c_str(), false, false);
+}
+
 /* Return true if string #a and string #b are equal after their first newline. */
 static bool strings_equal_after_first_lines(const std::string &a, const std::string &b)
 {
@@ -0,0 +1,189 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "BLI_fileops.hh"
+#include "BLI_string.hh"
+
+#include "BKE_appdir.hh"
+#include "BKE_gtest_base.hh"
+
+#include "testing/testing.h"
+
+#include "obj_import_file_reader.hh"
+#include "obj_import_objects.hh"
+
+namespace blender::io::obj {
+
+struct ParseResult {
+  Vector<std::unique_ptr<Geometry>> geometries;
+  GlobalVertices vertices;
+};
+
+class OBJImporterTest : public bke::BlenderGTestBase {
+ public:
+  ParseResult parse_string(const char *text, const int64_t chunk_size)
+  {
+    BKE_tempdir_init(nullptr);
+    const std::string tmp_file_path = std::string(BKE_tempdir_base()) + SEP_STR +
+                                      "obj_import_test.obj";
+    FILE *tmp_file = BLI_fopen(tmp_file_path.c_str(), "wb");
+    fputs(text, tmp_file);
+    fclose(tmp_file);
+
+    OBJImportParams params;
+    STRNCPY(params.filepath, tmp_file_path.c_str());
+    ParseResult result;
+    {
+      OBJParser parser(params);
+      parser.parse(result.geometries, result.vertices, chunk_size);
+    }
+
+    BLI_delete(tmp_file_path.c_str(), false, false);
+    return result;
+  }
+};
+
+static Vector<int> sorted_vertices(const Geometry &geometry)
+{
+  Vector<int> vertices(geometry.vertices_.begin(), geometry.vertices_.end());
+  std::sort(vertices.begin(), vertices.end());
+  return vertices;
+}
+
+static void expect_equal_geometries(const Geometry &a, const Geometry &b)
+{
+  EXPECT_EQ(a.geom_type_, b.geom_type_);
+  EXPECT_EQ(a.geometry_name_, b.geometry_name_);
+  EXPECT_EQ(a.group_order_.as_span(), b.group_order_.as_span());
+  EXPECT_EQ(a.material_order_.as_span(), b.material_order_.as_span());
+  EXPECT_EQ(sorted_vertices(a).as_span(), sorted_vertices(b).as_span());
+  EXPECT_EQ(a.edges_.as_span(), b.edges_.as_span());
+  EXPECT_EQ(a.total_corner_, b.total_corner_);
+  EXPECT_EQ(a.has_invalid_faces_, b.has_invalid_faces_);
+  ASSERT_EQ(a.face_corners_.size(), b.face_corners_.size());
+  for (const int64_t i : a.face_corners_.index_range()) {
+    EXPECT_EQ(a.face_corners_[i].vert_index, b.face_corners_[i].vert_index);
+    EXPECT_EQ(a.face_corners_[i].uv_vert_index, b.face_corners_[i].uv_vert_index);
+    EXPECT_EQ(a.face_corners_[i].vertex_normal_index, b.face_corners_[i].vertex_normal_index);
+  }
+  ASSERT_EQ(a.face_elements_.size(), b.face_elements_.size());
+  for (const int64_t i : a.face_elements_.index_range()) {
+    EXPECT_EQ(a.face_elements_[i].vertex_group_index, b.face_elements_[i].vertex_group_index);
+    EXPECT_EQ(a.face_elements_[i].material_index, b.face_elements_[i].material_index);
+    EXPECT_EQ(a.face_elements_[i].shaded_smooth, b.face_elements_[i].shaded_smooth);
+    EXPECT_EQ(a.face_elements_[i].start_index_, b.face_elements_[i].start_index_);
+    EXPECT_EQ(a.face_elements_[i].corner_count_, b.face_elements_[i].corner_count_);
+  }
+  EXPECT_EQ(a.nurbs_element_.degree, b.nurbs_element_.degree);
+  EXPECT_EQ(a.nurbs_element_.curv_indices.as_span(), b.nurbs_element_.curv_indices.as_span());
+  EXPECT_EQ(a.nurbs_element_.parm.as_span(), b.nurbs_element_.parm.as_span());
+}
+
+static const Geometry *find_geometry(const ParseResult &result, const StringRef name)
+{
+  for (const std::unique_ptr<Geometry> &geometry : result.geometries) {
+    if (geometry->geometry_name_ == name) {
+      return geometry.get();
+    }
+  }
+  return nullptr;
+}
+
+/* Elements that depend on the state of previous lines, relative indices and line continuations,
+ * so that chunks of a few bytes test their handling across chunk boundaries. */
+static const char *chunk_test_obj =
+    "# Comment\n"
+    "mtllib test.mtl\n"
+    "v 0 0 0 1 0 0\n"
+    "v 1 0 0 0 1 0\n"
+    "v 1 1 0 \\\n"
+    "  0 0 1\n"
+    "v 0 1 0\n"
+    "vt 0 0\n"
+    "vt 1 0\n"
+    "vt 1 1\n"
+    "vn 0 0 1\n"
+    "o First\n"
+    "usemtl Red\n"
+    "s 1\n"
+    "f 1/1/1 2/2/1 3/3/1\n"
+    "f -4/-3/-1 -2/-1/-1 \\\n"
+    " -1/-2/-1\n"
+    "v 0 0 1\n"
+    "v 1 0 1\n"
+    "v 1 1 1\n"
+    "o Second\n"
+    "g group_a\n"
+    "usemtl Blue\n"
+    "s off\n"
+    "f -3 -2 -1\n"
+    "l 1 2\n"
+    "g group_b\n"
+    "usemtl Red\n"
+    "f 1 \\\n"
+    "2 \\\n"
+    "5\n"
+    "v 5 5 5\n"
+    "cstype bspline\n"
+    "deg 1\n"
+    "curv 0.0 1.0 -2 -1\n"
+    "parm u 0.0 1.0\n"
+    "end\n";
+
+TEST_F(OBJImporterTest, small_chunks)
+{
+  const ParseResult expected = parse_string(chunk_test_obj, 1024 * 1024);
+
+  ASSERT_EQ(expected.vertices.vertices.size(), 8);
+  EXPECT_EQ(expected.vertices.vertices[2], float3(1.0f, 1.0f, 0.0f));
+  EXPECT_EQ(expected.vertices.vertex_colors.size(), 3);
+  EXPECT_EQ(expected.vertices.vertex_colors[2], float3(0.0f, 0.0f, 1.0f));
+  EXPECT_EQ(expected.vertices.uv_vertices.size(), 3);
+  EXPECT_EQ(expected.vertices.vert_normals.size(), 1);
+
+  const Geometry *first = find_geometry(expected, "First");
+  ASSERT_NE(first, nullptr);
+  ASSERT_EQ(first->face_corners_.size(), 6);
+  EXPECT_EQ(first->face_corners_[3].vert_index, 0);
+  EXPECT_EQ(first->face_corners_[3].uv_vert_index, 0);
+  EXPECT_EQ(first->face_corners_[4].vert_index, 2);
+  EXPECT_EQ(first->face_corners_[5].vert_index, 3);
+  EXPECT_EQ(first->face_corners_[5].uv_vert_index, 1);
+
+  const Geometry *second = find_geometry(expected, "Second");
+  ASSERT_NE(second, nullptr);
+  ASSERT_EQ(second->face_corners_.size(), 6);
+  EXPECT_EQ(second->face_corners_[0].vert_index, 4);
+  EXPECT_EQ(second->face_corners_[2].vert_index, 6);
+  EXPECT_EQ(second->face_corners_[5].vert_index, 4);
+  ASSERT_EQ(second->face_elements_.size(), 2);
+  EXPECT_EQ(second->face_elements_[0].material_index, 0);
+  EXPECT_EQ(second->face_elements_[1].material_index, 1);
+  EXPECT_FALSE(second->face_elements_[0].shaded_smooth);
+
+  const Geometry *curve = find_geometry(expected, "group_b");
+  ASSERT_NE(curve, nullptr);
+  EXPECT_EQ(curve->geom_type_, GEOM_CURVE);
+  EXPECT_EQ(curve->nurbs_element_.curv_indices.as_span(), Span<int>({6, 7}));
+
+  for (const int64_t chunk_size : {1, 2, 7, 16, 33}) {
+    SCOPED_TRACE(chunk_size);
+    const ParseResult result = parse_string(chunk_test_obj, chunk_size);
+    EXPECT_EQ(result.vertices.vertices.as_span(), expected.vertices.vertices.as_span());
+    EXPECT_EQ(result.vertices.uv_vertices.as_span(), expected.vertices.uv_vertices.as_span());
+    EXPECT_EQ(result.vertices.vert_normals.as_span(), expected.vertices.vert_normals.as_span());
+    EXPECT_EQ(result.vertices.vertex_colors.as_span(),
+              expected.vertices.vertex_colors.as_span());
+    EXPECT_EQ(result.vertices.vertex_weights.as_span(),
+              expected.vertices.vertex_weights.as_span());
+    ASSERT_EQ(result.geometries.size(), expected.geometries.size());
+    for (const int64_t i : result.geometries.index_range()) {
+      expect_equal_geometries(*result.geometries[i], *expected.geometries[i]);
+    }
+  }
+}
+
+}  // namespace blender::io::obj
@@ -7678,6 +7678,28 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
       "Use file format used before Blender 5.0. This format is more limited "
       "but it may have better compatibility with tools that don't support the new format yet");
 
+  prop = RNA_def_property(srna, "use_mapped_blend_file_data", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(
+      prop,
+      "Reference Mapped Blend File Data",
+      "Reference large arrays (e.g. packed files) directly from the memory-mapped blend-file "
+      "instead of copying them when loading. They are only read from disk when first accessed. "
+      "Only works for uncompressed files, and not on Windows");
+
+  prop = RNA_def_property(srna, "use_undo_compression", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(prop,
+                           "Compress Undo Steps",
+                           "Compress the global undo steps that are not active in the background, "
+                           "to fit more steps in the undo memory limit. Steps are decompressed "
+                           "when undoing to them");
+
+  prop = RNA_def_property(srna, "use_incremental_depsgraph_relations", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(prop,
+                           "Incremental Depsgraph Relations",
+                           "When modifiers are added or removed, only build again the dependency "
+                           "graph nodes and relations of the affected objects instead of the whole "
+                           "graph, when possible");
+
   prop = RNA_def_property(srna, "no_data_block_packing", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "no_data_block_packing", 1);
   RNA_def_property_ui_text(
@@ -20,6 +20,7 @@
  * #lazy_function::Graph is build that can be used when evaluating the graph (e.g. for logging).
  */
 
+#include <atomic>
 #include <variant>
 
 #include "FN_lazy_function_graph.hh"
@@ -282,6 +283,12 @@ struct GeoNodesUserData : public fn::UserData {
    * Child contexts might use logging again even if the current compute context does not.
    */
   bool verbose_log = true;
+  /**
+   * Set when a warning is logged in the current compute context or a nested one, while the outputs
+   * of a node group that contains it are recorded to be memoized. Such results are not added to
+   * the cache, because the warnings would be missing when the cached outputs are used instead.
+   */
+  std::atomic<bool> *warning_logged = nullptr;
 
   destruct_ptr<fn::LocalUserData> get_local(LinearAllocator<> &allocator) override;
 
@@ -314,6 +321,14 @@ struct GeoNodesLocalUserData : public fn::LocalUserData {
     return *tree_logger_;
   }
 
+  /**
+   * Log a warning for a node in the current node tree. Warnings should always be added with this
+   * method, even when nothing is logged, so that node groups producing them are not memoized.
+   */
+  void log_warning(const GeoNodesUserData &user_data,
+                   int32_t node_id,
+                   eval_log::NodeWarning warning) const;
+
  private:
   void ensure_tree_logger(const GeoNodesUserData &user_data) const;
 };
@@ -455,6 +470,17 @@ struct GeometryNodesLazyFunctionGraphInfo {
    * This can be used as a simple heuristic for the complexity of the node group.
    */
   int num_inline_nodes_approximate = 0;
+  /**
+   * Non-zero when the outputs of the node group only depend on its inputs, so that they can be
+   * cached across evaluations. A new identifier is used whenever the graph is rebuilt, which makes
+   * sure that results of an outdated graph are not used.
+   */
+  uint64_t memoization_graph_id = 0;
+  /**
+   * Indices of the main inputs of the node group that are part of the key of memoized results.
+   * Nothing when some inputs are only used lazily, which disables memoization.
+   */
+  std::optional<Vector<int>> memoization_key_inputs;
 
   GeometryNodesLazyFunctionGraphInfo(const char *debug_name);
 };
@@ -243,10 +243,8 @@ class LazyFunctionForBakeNode final : public LazyFunction {
       this->store(params, user_data, behavior->data_block_map, *info);
     }
     else if (auto *info = std::get_if<sim_output::ReadError>(&behavior->behavior)) {
-      if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data)) {
-        tree_logger->node_warnings.append(
-            *tree_logger->allocator, {node_.identifier, {NodeWarningType::Error, info->message}});
-      }
+      local_user_data.log_warning(
+          user_data, node_.identifier, {NodeWarningType::Error, info->message});
       this->set_default_outputs(params);
     }
     else {
@@ -502,6 +500,7 @@ static void node_register()
   ntype.internally_linked_input = node_internally_linked_input;
   ntype.blend_write_storage_content = node_blend_write;
   ntype.blend_data_read_storage_content = node_blend_read;
+  ntype.depends_on_eval_context = true;
   bke::node_type_storage(ntype, "NodeGeometryBake", node_free_storage, node_copy_storage);
   bke::node_register_type(ntype);
 }
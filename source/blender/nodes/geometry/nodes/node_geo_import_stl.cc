@@ -99,6 +99,7 @@ static void node_register()
   ntype.geometry_node_execute = node_geo_exec;
   ntype.declare = node_declare;
 
+  ntype.depends_on_eval_context = true;
   bke::node_register_type(ntype);
 }
 NOD_REGISTER_NODE(node_register)
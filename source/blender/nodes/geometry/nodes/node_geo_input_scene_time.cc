@@ -62,6 +62,7 @@ static void node_register()
   ntype.declare = node_declare;
   ntype.gpu_fn = node_shader_gpu;
   ntype.materialx_fn = node_shader_materialx;
+  ntype.depends_on_eval_context = true;
   bke::node_register_type(ntype);
 }
 NOD_REGISTER_NODE(node_register)
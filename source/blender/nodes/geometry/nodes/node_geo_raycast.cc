@@ -142,22 +142,28 @@ static void raycast_to_mesh(const IndexMask &mask,
     return;
   }
 
-  mask.foreach_index([&](const int i) {
-    const float ray_length = ray_lengths[i];
-    const float3 ray_origin = ray_origins[i];
-    const float3 ray_direction = ray_directions[i];
-
-    BVHTreeRayHit hit;
-    hit.index = -1;
-    hit.dist = ray_length;
-    if (BLI_bvhtree_ray_cast(tree_data.tree,
-                             ray_origin,
-                             ray_direction,
+  /* Gather the rays into contiguous arrays, so that they can be cast in one batch. */
+  Array<float3> origins(mask.size());
+  Array<float3> directions(mask.size());
+  Array<BVHTreeRayHit> hits(mask.size());
+  mask.foreach_index_optimized<int>([&](const int i, const int pos) {
+    origins[pos] = ray_origins[i];
+    directions[pos] = ray_directions[i];
+    hits[pos].index = -1;
+    hits[pos].dist = ray_lengths[i];
+  });
+  BLI_bvhtree_ray_cast_batch(*tree_data.tree,
+                             IndexRange(mask.size()),
+                             origins,
+                             directions,
                              0.0f,
-                             &hit,
+                             hits,
                              tree_data.raycast_callback,
-                             &tree_data) != -1)
-    {
+                             &tree_data);
+
+  mask.foreach_index([&](const int i, const int pos) {
+    const BVHTreeRayHit &hit = hits[pos];
+    if (hit.index != -1) {
       if (!r_hit.is_empty()) {
         r_hit[i] = hit.index >= 0;
       }
@@ -189,7 +195,7 @@ static void raycast_to_mesh(const IndexMask &mask,
         r_hit_normals[i] = float3(0.0f, 0.0f, 0.0f);
       }
       if (!r_hit_distances.is_empty()) {
-        r_hit_distances[i] = ray_length;
+        r_hit_distances[i] = ray_lengths[i];
       }
     }
   });
@@ -159,11 +159,46 @@ class SampleNearestSurfaceFunction : public mf::MultiFunction {
     MutableSpan<bool> is_valid_span = params.uninitialized_single_output_if_required<bool>(
         4, "Is Valid");
 
-    mask.foreach_index([&](const int i) {
-      const float3 position = positions[i];
-      const int sample_id = sample_ids[i];
-      const int group_index = group_indices_.index_of_try(sample_id);
-      if (group_index == -1) {
+    /* Gather the positions into a contiguous array and sort them by group, so that the nearest
+     * points can be found in one batch for every group. */
+    const int groups_num = bvh_trees_.size();
+    Array<float3> positions_compact(mask.size());
+    Array<int> group_by_pos(mask.size());
+    mask.foreach_index_optimized<int>([&](const int i, const int pos) {
+      positions_compact[pos] = positions[i];
+      const int group_index = group_indices_.index_of_try(sample_ids[i]);
+      /* Positions with an unknown group id are put into an extra group. */
+      group_by_pos[pos] = group_index == -1 ? groups_num : group_index;
+    });
+    IndexMaskMemory memory;
+    Array<IndexMask> group_masks(groups_num + 1);
+    IndexMask::from_groups<int>(
+        IndexRange(mask.size()),
+        memory,
+        [&](const int pos) { return group_by_pos[pos]; },
+        group_masks);
+
+    Array<BVHTreeNearest> nearest(mask.size());
+    for (const int group_index : IndexRange(groups_num)) {
+      const IndexMask &group_mask = group_masks[group_index];
+      if (group_mask.is_empty()) {
+        continue;
+      }
+      group_mask.foreach_index_optimized<int>([&](const int pos) {
+        nearest[pos].dist_sq = FLT_MAX;
+        nearest[pos].index = -1;
+      });
+      const bke::BVHTreeFromMesh &bvh = bvh_trees_[group_index];
+      BLI_bvhtree_find_nearest_batch(*bvh.tree,
+                                     group_mask,
+                                     positions_compact,
+                                     nearest,
+                                     bvh.nearest_callback,
+                                     const_cast<bke::BVHTreeFromMesh *>(&bvh));
+    }
+
+    mask.foreach_index([&](const int i, const int pos) {
+      if (group_by_pos[pos] == groups_num) {
         triangle_index[i] = -1;
         sample_position[i] = float3(0, 0, 0);
         if (!is_valid_span.is_empty()) {
@@ -171,17 +206,8 @@ class SampleNearestSurfaceFunction : public mf::MultiFunction {
         }
         return;
       }
-      const bke::BVHTreeFromMesh &bvh = bvh_trees_[group_index];
-      BVHTreeNearest nearest;
-      nearest.dist_sq = FLT_MAX;
-      nearest.index = -1;
-      BLI_bvhtree_find_nearest(bvh.tree,
-                               position,
-                               &nearest,
-                               bvh.nearest_callback,
-                               const_cast<bke::BVHTreeFromMesh *>(&bvh));
-      triangle_index[i] = nearest.index;
-      sample_position[i] = nearest.co;
+      triangle_index[i] = nearest[pos].index;
+      sample_position[i] = nearest[pos].co;
       if (!is_valid_span.is_empty()) {
         is_valid_span[i] = true;
       }
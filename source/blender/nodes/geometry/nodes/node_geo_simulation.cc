@@ -366,6 +366,7 @@ static void node_register()
   ntype.gather_link_search_ops = nullptr;
   ntype.no_muting = true;
   ntype.draw_buttons_ex = node_layout_ex;
+  ntype.depends_on_eval_context = true;
   bke::node_type_storage(ntype,
                          "NodeGeometrySimulationInput",
                          node_free_standard_storage,
@@ -446,22 +447,19 @@ class LazyFunctionForSimulationOutputNode final : public LazyFunction {
       return;
     }
     if (!user_data.call_data->simulation_params) {
-      if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data)) {
-        tree_logger->node_warnings.append(
-            *tree_logger->allocator,
-            {node_.identifier,
-             {NodeWarningType::Error, TIP_("Simulation zone is not supported")}});
-      }
+      local_user_data.log_warning(
+          user_data,
+          node_.identifier,
+          {NodeWarningType::Error, TIP_("Simulation zone is not supported")});
       this->set_default_outputs(params);
       return;
     }
     std::optional<FoundNestedNodeID> found_id = find_nested_node_id(user_data, node_.identifier);
     if (!found_id || found_id->is_in_loop || found_id->is_in_closure) {
-      if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data)) {
-        const StringRefNull message = TIP_("Simulation must not be in a loop or closure");
-        tree_logger->node_warnings.append(*tree_logger->allocator,
-                                          {node_.identifier, {NodeWarningType::Error, message}});
-      }
+      local_user_data.log_warning(
+          user_data,
+          node_.identifier,
+          {NodeWarningType::Error, TIP_("Simulation must not be in a loop or closure")});
       this->set_default_outputs(params);
       return;
     }
@@ -783,6 +781,7 @@ static void node_register()
   ntype.get_extra_info = node_extra_info;
   ntype.blend_write_storage_content = node_blend_write;
   ntype.blend_data_read_storage_content = node_blend_read;
+  ntype.depends_on_eval_context = true;
   bke::node_type_storage(
       ntype, "NodeGeometrySimulationOutput", node_free_storage, node_copy_storage);
   bke::node_register_type(ntype);
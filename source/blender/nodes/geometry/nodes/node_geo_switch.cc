@@ -167,11 +167,8 @@ class LazyFunctionForSwitchNode : public LazyFunction {
 
     auto &user_data = *static_cast<GeoNodesUserData *>(context.user_data);
     auto &local_user_data = *static_cast<GeoNodesLocalUserData *>(context.local_user_data);
-    if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data)) {
-      tree_logger->node_warnings.append(
-          *tree_logger->allocator,
-          {node_id_, {NodeWarningType::Error, N_("Type cannot be switched by a field")}});
-    }
+    local_user_data.log_warning(
+        user_data, node_id_, {NodeWarningType::Error, N_("Type cannot be switched by a field")});
 
     this->execute_single(condition_variant.get<bool>(), params);
   }
@@ -62,11 +62,8 @@ class LazyFunctionForWarningNode : public LazyFunction {
     GeoNodesUserData &user_data = *static_cast<GeoNodesUserData *>(context.user_data);
     GeoNodesLocalUserData &local_user_data = *static_cast<GeoNodesLocalUserData *>(
         context.local_user_data);
-    if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data)) {
-      tree_logger->node_warnings.append(
-          *tree_logger->allocator,
-          {node_.identifier, {NodeWarningType(node_.custom1), std::move(message)}});
-    }
+    local_user_data.log_warning(
+        user_data, node_.identifier, {NodeWarningType(node_.custom1), std::move(message)});
     /* Only set output in the end so that this node is not finished before the warning is set. */
     params.set_output(0, show_variant);
   }
@@ -140,6 +137,7 @@ static void node_register()
   ntype.labelfunc = node_label;
   ntype.draw_buttons = node_layout;
   ntype.get_compositor_operation = get_compositor_operation;
+  ntype.depends_on_eval_context = true;
   bke::node_register_type(ntype);
 
   node_rna(ntype.rna_ext.srna);
@@ -360,15 +360,11 @@ class LazyFunctionForEvaluateClosureNode : public LazyFunction {
       if (eval_storage.closure) {
         if (user_data.is_stack_limit_reached()) {
           this->initialize_pass_through_graph(eval_storage);
-          if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(
-                  user_data))
-          {
-            tree_logger->node_warnings.append(
-                *tree_logger->allocator,
-                {bnode_.identifier,
-                 {NodeWarningType::Error,
-                  TIP_("Stack limit reached. Closure becomes pass-through.")}});
-          }
+          local_user_data.log_warning(
+              user_data,
+              bnode_.identifier,
+              {NodeWarningType::Error,
+               TIP_("Stack limit reached. Closure becomes pass-through.")});
         }
         else {
           this->generate_closure_compatibility_warnings(*eval_storage.closure, context);
@@ -436,10 +432,9 @@ class LazyFunctionForEvaluateClosureNode : public LazyFunction {
     const auto &node_storage = *static_cast<const NodeEvaluateClosure *>(bnode_.storage);
     const auto &user_data = *static_cast<GeoNodesUserData *>(context.user_data);
     const auto &local_user_data = *static_cast<GeoNodesLocalUserData *>(context.local_user_data);
-    eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data);
-    if (tree_logger == nullptr) {
-      return;
-    }
+    const auto log_warning = [&](const NodeWarningType type, const StringRef message) {
+      local_user_data.log_warning(user_data, bnode_.identifier, {type, message});
+    };
     const ClosureSignature &signature = closure.signature();
     for (const NodeEvaluateClosureInputItem &item :
          Span{node_storage.input_items.items, node_storage.input_items.items_num})
@@ -448,40 +443,32 @@ class LazyFunctionForEvaluateClosureNode : public LazyFunction {
       if (const std::optional<int> i = signature.find_input_index(item.name)) {
         const ClosureSignature::Item &closure_item = signature.inputs[*i];
         if (!btree_.typeinfo->validate_link(item.socket_type, closure_item.type->type)) {
-          tree_logger->node_warnings.append(
-              *tree_logger->allocator,
-              {bnode_.identifier,
-               {NodeWarningType::Error,
-                fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
-                            " {})",
-                            TIP_("Conversion not supported when evaluating closure"),
-                            TIP_("Input"),
-                            item.name,
-                            TIP_(item_type->label),
-                            TIP_(closure_item.type->label))}});
+          log_warning(
+              NodeWarningType::Error,
+              fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
+                          " {})",
+                          TIP_("Conversion not supported when evaluating closure"),
+                          TIP_("Input"),
+                          item.name,
+                          TIP_(item_type->label),
+                          TIP_(closure_item.type->label)));
         }
         else if (item.socket_type != closure_item.type->type) {
-          tree_logger->node_warnings.append(
-              *tree_logger->allocator,
-              {bnode_.identifier,
-               {NodeWarningType::Info,
-                fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
-                            " {})",
-                            TIP_("Implicit type conversion when evaluating closure"),
-                            TIP_("Input"),
-                            item.name,
-                            TIP_(item_type->label),
-                            TIP_(closure_item.type->label))}});
+          log_warning(
+              NodeWarningType::Info,
+              fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
+                          " {})",
+                          TIP_("Implicit type conversion when evaluating closure"),
+                          TIP_("Input"),
+                          item.name,
+                          TIP_(item_type->label),
+                          TIP_(closure_item.type->label)));
         }
       }
       else {
-        tree_logger->node_warnings.append(
-            *tree_logger->allocator,
-            {bnode_.identifier,
-             {
-                 NodeWarningType::Error,
-                 fmt::format(fmt::runtime(TIP_("Closure does not have input: \"{}\"")), item.name),
-             }});
+        log_warning(
+            NodeWarningType::Error,
+            fmt::format(fmt::runtime(TIP_("Closure does not have input: \"{}\"")), item.name));
       }
     }
     for (const NodeEvaluateClosureOutputItem &item :
@@ -491,39 +478,32 @@ class LazyFunctionForEvaluateClosureNode : public LazyFunction {
       if (const std::optional<int> i = signature.find_output_index(item.name)) {
         const ClosureSignature::Item &closure_item = signature.outputs[*i];
         if (!btree_.typeinfo->validate_link(closure_item.type->type, item.socket_type)) {
-          tree_logger->node_warnings.append(
-              *tree_logger->allocator,
-              {bnode_.identifier,
-               {NodeWarningType::Error,
-                fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
-                            " {})",
-                            TIP_("Conversion not supported when evaluating closure"),
-                            TIP_("Output"),
-                            item.name,
-                            TIP_(closure_item.type->label),
-                            TIP_(item_type->label))}});
+          log_warning(
+              NodeWarningType::Error,
+              fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
+                          " {})",
+                          TIP_("Conversion not supported when evaluating closure"),
+                          TIP_("Output"),
+                          item.name,
+                          TIP_(closure_item.type->label),
+                          TIP_(item_type->label)));
         }
         else if (item.socket_type != closure_item.type->type) {
-          tree_logger->node_warnings.append(
-              *tree_logger->allocator,
-              {bnode_.identifier,
-               {NodeWarningType::Info,
-                fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
-                            " {})",
-                            TIP_("Implicit type conversion when evaluating closure"),
-                            TIP_("Output"),
-                            item.name,
-                            TIP_(closure_item.type->label),
-                            TIP_(item_type->label))}});
+          log_warning(
+              NodeWarningType::Info,
+              fmt::format("{}: {} \"{}\" ({} " BLI_STR_UTF8_BLACK_RIGHT_POINTING_SMALL_TRIANGLE
+                          " {})",
+                          TIP_("Implicit type conversion when evaluating closure"),
+                          TIP_("Output"),
+                          item.name,
+                          TIP_(closure_item.type->label),
+                          TIP_(item_type->label)));
         }
       }
       else {
-        tree_logger->node_warnings.append(
-            *tree_logger->allocator,
-            {bnode_.identifier,
-             {NodeWarningType::Error,
-              fmt::format(fmt::runtime(TIP_("Closure does not have output: \"{}\"")),
-                          item.name)}});
+        log_warning(
+            NodeWarningType::Error,
+            fmt::format(fmt::runtime(TIP_("Closure does not have output: \"{}\"")), item.name));
       }
     }
   }
@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "NOD_geometry_nodes_lazy_function.hh"
+#include "NOD_node_declaration.hh"
+#include "NOD_socket.hh"
 
 #include "BKE_anonymous_attribute_make.hh"
 #include "BKE_compute_contexts.hh"
@@ -62,6 +64,8 @@ struct ForeachElementComponent {
   /** The set of body evaluation nodes that correspond to this component. This indexes into
    * `lf_body_nodes`. */
   IndexRange body_nodes_range;
+  /** Selected elements of the component. */
+  IndexMask mask;
 
   void emplace_field_context(const GeometrySet &geometry)
   {
@@ -228,6 +232,11 @@ struct ForeachGeometryElementEvalStorage {
   Array<ForeachElementComponent> components;
   /** Amount of iterations across all components. */
   int total_iterations_num = 0;
+  /**
+   * When true, there is only a single body node per component which computes the fields for all
+   * elements at once. See #LazyFunctionForForeachGeometryElementZone::body_is_field_function_.
+   */
+  bool vectorized = false;
 };
 
 class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
@@ -237,6 +246,14 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
   const bNode &output_bnode_;
   const ZoneBuildInfo &zone_info_;
   const ZoneBodyFunction &body_fn_;
+  /**
+   * True when the zone body only contains field nodes and does not use the element geometry.
+   * Evaluating the body for every element is then equivalent to evaluating it once with the index
+   * and input items passed in as fields, and evaluating the resulting fields on the geometry. That
+   * avoids creating a lazy-function node for every element, which is much faster when the number
+   * of elements is large.
+   */
+  bool body_is_field_function_ = false;
 
   struct ItemIndices {
     /* `outer` refers to sockets on the outside of the zone, and `inner` to the sockets on the
@@ -305,6 +322,99 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
                                                                     generation_items_num);
     indices_.generation.bsocket_inner = IndexRange::from_begin_size(1 + main_items_num,
                                                                     generation_items_num);
+
+    body_is_field_function_ = this->zone_body_is_field_function(node_storage);
+  }
+
+  bool zone_body_is_field_function(
+      const NodeGeometryForeachGeometryElementOutput &node_storage) const
+  {
+    if (node_storage.generation_items.items_num > 0 || !zone_.child_zones.is_empty()) {
+      return false;
+    }
+    const bNodeSocket &element_geometry_bsocket = zone_.input_node()->output_socket(1);
+    if (element_geometry_bsocket.is_available() && element_geometry_bsocket.is_directly_linked())
+    {
+      return false;
+    }
+    for (const NodeForeachGeometryElementMainItem &item :
+         Span(node_storage.main_items.items, node_storage.main_items.items_num))
+    {
+      if (!socket_type_supports_fields(item.socket_type)) {
+        return false;
+      }
+    }
+    for (const bNodeLink *link : zone_.border_links) {
+      if (!socket_type_supports_fields(eNodeSocketDatatype(link->tosock->type))) {
+        return false;
+      }
+    }
+    for (const bNode *node : zone_.child_nodes()) {
+      if (node->is_reroute()) {
+        continue;
+      }
+      if (node->is_undefined() || node->typeinfo->build_multi_function == nullptr) {
+        return false;
+      }
+      for (const bNodeSocket *socket : node->input_sockets()) {
+        if (!socket->is_available()) {
+          continue;
+        }
+        if (!socket_type_supports_fields(eNodeSocketDatatype(socket->type))) {
+          return false;
+        }
+        /* Implicit field inputs like the position would be evaluated on the geometry instead of
+         * on a single element. */
+        if (!socket->is_directly_linked() && socket->runtime->declaration &&
+            socket->runtime->declaration->default_input_type != NODE_DEFAULT_INPUT_VALUE)
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * The body can only be vectorized when the values passed in from outside of the zone are single
+   * values. Fields passed into the body are evaluated without a geometry context in each
+   * iteration.
+   */
+  bool try_check_vectorization(lf::Params &params,
+                               const GeoNodesUserData &user_data,
+                               const NodeGeometryForeachGeometryElementOutput &node_storage,
+                               std::optional<bool> &r_vectorize) const
+  {
+    if (!body_is_field_function_) {
+      r_vectorize = false;
+      return true;
+    }
+    if (user_data.call_data->eval_log) {
+      /* Values inside the zone are logged for a single iteration. */
+      const bke::ForeachGeometryElementZoneComputeContext inspected_compute_context{
+          user_data.compute_context, output_bnode_, node_storage.inspection_index};
+      if (should_log_verbose_in_context(user_data, inspected_compute_context.hash())) {
+        r_vectorize = false;
+        return true;
+      }
+    }
+    bool all_available = true;
+    for (const int i : zone_info_.indices.inputs.border_links) {
+      const SocketValueVariant *value =
+          params.try_get_input_data_ptr_or_request<SocketValueVariant>(i);
+      if (value == nullptr) {
+        all_available = false;
+      }
+      else if (!value->is_single()) {
+        r_vectorize = false;
+        return true;
+      }
+    }
+    if (!all_available) {
+      return false;
+    }
+    r_vectorize = true;
+    return true;
   }
 
   void *init_storage(LinearAllocator<> &allocator) const override
@@ -331,21 +441,25 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
     const auto &node_storage = *static_cast<const NodeGeometryForeachGeometryElementOutput *>(
         output_bnode_.storage);
     auto &eval_storage = *static_cast<ForeachGeometryElementEvalStorage *>(context.storage);
-    eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data);
 
     if (!eval_storage.graph_executor) {
+      std::optional<bool> vectorize;
+      if (!this->try_check_vectorization(params, user_data, node_storage, vectorize)) {
+        /* Wait until the values passed into the zone are available. */
+        return;
+      }
+      eval_storage.vectorized = *vectorize;
+
       /* Create the execution graph in the first evaluation. */
       this->initialize_execution_graph(params, eval_storage, node_storage);
 
-      if (tree_logger) {
-        if (eval_storage.total_iterations_num == 0) {
-          if (!eval_storage.main_geometry.is_empty()) {
-            tree_logger->node_warnings.append(
-                *tree_logger->allocator,
-                {zone_.input_node()->identifier,
-                 {NodeWarningType::Info,
-                  N_("Input geometry has no elements in the iteration domain.")}});
-          }
+      if (eval_storage.total_iterations_num == 0) {
+        if (!eval_storage.main_geometry.is_empty()) {
+          local_user_data.log_warning(
+              user_data,
+              zone_.input_node()->identifier,
+              {NodeWarningType::Info,
+               N_("Input geometry has no elements in the iteration domain.")});
         }
       }
     }
@@ -389,7 +503,10 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
 
     eval_storage.side_effect_provider.emplace();
     eval_storage.side_effect_provider->output_bnode_ = &output_bnode_;
-    eval_storage.side_effect_provider->lf_body_nodes_ = eval_storage.lf_body_nodes;
+    if (!eval_storage.vectorized) {
+      /* Vectorized bodies have no side effects and their nodes don't correspond to iterations. */
+      eval_storage.side_effect_provider->lf_body_nodes_ = eval_storage.lf_body_nodes;
+    }
 
     eval_storage.body_execute_wrapper.emplace();
     eval_storage.body_execute_wrapper->output_bnode_ = &output_bnode_;
@@ -490,6 +607,14 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
 
       /* The mask contains all the indices that should be iterated over in the component. */
       const IndexMask mask = component_info.field_evaluator->get_evaluated_selection_as_mask();
+      component_info.mask = mask;
+
+      if (eval_storage.vectorized) {
+        this->prepare_vectorized_component(
+            params, component_info, node_storage, body_nodes_offset);
+        continue;
+      }
+
       component_info.body_nodes_range = IndexRange::from_begin_size(body_nodes_offset,
                                                                     mask.size());
       body_nodes_offset += mask.size();
@@ -535,6 +660,35 @@ class LazyFunctionForForeachGeometryElementZone : public LazyFunction {
     eval_storage.total_iterations_num = body_nodes_offset;
   }
 
+  /**
+   * Prepare a single body evaluation for all selected elements of the component. The index and
+   * input items are passed in as fields, which are evaluated on the component by the reduce node.
+   */
+  void prepare_vectorized_component(lf::Params &params,
+                                    ForeachElementComponent &component_info,
+                                    const NodeGeometryForeachGeometryElementOutput &node_storage,
+                                    int &body_nodes_offset) const
+  {
+    const int body_nodes_num = component_info.mask.is_empty() ? 0 : 1;
+    component_info.body_nodes_range = IndexRange::from_begin_size(body_nodes_offset,
+                                                                  body_nodes_num);
+    body_nodes_offset += body_nodes_num;
+
+    component_info.index_values.reinitialize(body_nodes_num);
+    component_info.item_input_values.reinitialize(node_storage.input_items.items_num);
+    for (const int item_i : IndexRange(node_storage.input_items.items_num)) {
+      component_info.item_input_values[item_i].reinitialize(body_nodes_num);
+    }
+    if (body_nodes_num == 0) {
+      return;
+    }
+    component_info.index_values[0] = SocketValueVariant::From(fn::IndexFieldInput::get_field());
+    for (const int item_i : IndexRange(node_storage.input_items.items_num)) {
+      component_info.item_input_values[item_i][0] = params.get_input<SocketValueVariant>(
+          zone_info_.indices.inputs.main[indices_.inputs.lf_outer[item_i]]);
+    }
+  }
+
   std::optional<Array<GeometrySet>> try_extract_element_geometries(
       const GeometrySet &main_geometry,
       const ForeachElementComponentID &id,
@@ -905,6 +1059,21 @@ void LazyFunctionForReduceForeachGeometryElement::handle_main_items_and_geometry
       const IndexMask inverted_mask = mask.complement(IndexRange(domain_size), memory);
       base_cpp_type->value_initialize_indices(attribute.span.data(), inverted_mask);
 
+      if (eval_storage_.vectorized) {
+        if (!component_info.body_nodes_range.is_empty()) {
+          /* Evaluate the field computed by the body for all selected elements at once. */
+          const int lf_param_index = component_info.body_nodes_range.first() *
+                                         body_main_outputs_num +
+                                     item_i;
+          GField field = params.get_input<SocketValueVariant>(lf_param_index).get<GField>();
+          fn::FieldEvaluator evaluator{*component_info.field_context, &mask};
+          evaluator.add_with_destination(std::move(field), attribute.span);
+          evaluator.evaluate();
+        }
+        attribute.finish();
+        continue;
+      }
+
       /* Copy the values from each iteration into the attribute. */
       mask.foreach_index([&](const int i, const int pos) {
         const int lf_param_index = pos * body_main_outputs_num + item_i;
@@ -34,6 +34,7 @@
 #include "BLI_bit_span_ops.hh"
 #include "BLI_lazy_threading.hh"
 #include "BLI_map.hh"
+#include "BLI_memory_cache.hh"
 #include "BLI_stack.hh"
 
 #include "DNA_ID.h"
@@ -62,6 +63,7 @@
 
 #include "GEO_foreach_geometry.hh"
 
+#include "geometry_nodes_memoize.hh"
 #include "list_function_eval.hh"
 #include "volume_grid_function_eval.hh"
 
@@ -752,12 +754,8 @@ class LazyFunctionForMultiFunctionNode : public LazyFunction {
         const auto &user_data = *static_cast<GeoNodesUserData *>(context.user_data);
         const auto &local_user_data = *static_cast<GeoNodesLocalUserData *>(
             context.local_user_data);
-        if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data))
-        {
-          tree_logger->node_warnings.append(
-              *tree_logger->allocator,
-              {node_.identifier, {NodeWarningType::Error, error_message}});
-        }
+        local_user_data.log_warning(
+            user_data, node_.identifier, {NodeWarningType::Error, error_message});
       }
       return;
     }
@@ -1133,6 +1131,113 @@ bool should_log_verbose_in_context(const GeoNodesUserData &user_data,
   return true;
 }
 
+/**
+ * Node groups with fewer nodes are usually cheap enough to compute that looking up and storing
+ * their results in the cache is not worth it.
+ */
+static constexpr int min_nodes_to_memoize = 32;
+
+enum class GroupMemoizeState {
+  /** Not all inputs required for the cache lookup are available yet. */
+  Unknown,
+  /** The node group is evaluated without using the cache. */
+  Disabled,
+  /** The result was not cached, so the outputs are recorded while they are computed. */
+  Recording,
+};
+
+/**
+ * Used when evaluating a node group whose outputs may be memoized. Inputs that have been requested
+ * for the cache lookup must not be set unused anymore, and computed outputs are recorded so that
+ * they can be added to the cache.
+ */
+class MemoizeGroupParams : public lf::Params {
+ private:
+  lf::Params &base_params_;
+  const GeometryNodesGroupFunction &group_function_;
+  const BitSpan requested_inputs_;
+  memoize::GroupCallResult *recording_;
+  bool &multi_threading_enabled_;
+
+ public:
+  MemoizeGroupParams(lf::Params &base_params,
+                     const GeometryNodesGroupFunction &group_function,
+                     const BitSpan requested_inputs,
+                     memoize::GroupCallResult *recording,
+                     bool &multi_threading_enabled)
+      : lf::Params(*group_function.function, multi_threading_enabled),
+        base_params_(base_params),
+        group_function_(group_function),
+        requested_inputs_(requested_inputs),
+        recording_(recording),
+        multi_threading_enabled_(multi_threading_enabled)
+  {
+  }
+
+  void *try_get_input_data_ptr_impl(const int index) const override
+  {
+    return base_params_.try_get_input_data_ptr(index);
+  }
+
+  void *try_get_input_data_ptr_or_request_impl(const int index) override
+  {
+    return base_params_.try_get_input_data_ptr_or_request(index);
+  }
+
+  void *get_output_data_ptr_impl(const int index) override
+  {
+    return base_params_.get_output_data_ptr(index);
+  }
+
+  void output_set_impl(const int index) override
+  {
+    if (recording_) {
+      /* Record the value before passing it on, because it may be moved away afterwards. */
+      const void *value = base_params_.get_output_data_ptr(index);
+      const IndexRange main_outputs = group_function_.outputs.main;
+      const IndexRange input_usages = group_function_.outputs.input_usages;
+      if (main_outputs.contains(index)) {
+        recording_->record_output(index - main_outputs.start(),
+                                  {group_function_.function->outputs()[index].type, value});
+      }
+      else if (input_usages.contains(index)) {
+        recording_->input_usages[index - input_usages.start()] = *static_cast<const bool *>(
+            value);
+      }
+    }
+    base_params_.output_set(index);
+  }
+
+  bool output_was_set_impl(const int index) const override
+  {
+    return base_params_.output_was_set(index);
+  }
+
+  lf::ValueUsage get_output_usage_impl(const int index) const override
+  {
+    return base_params_.get_output_usage(index);
+  }
+
+  void set_input_unused_impl(const int index) override
+  {
+    if (index >= requested_inputs_.size() || !requested_inputs_[index]) {
+      base_params_.set_input_unused(index);
+    }
+  }
+
+  bool try_enable_multi_threading_impl() override
+  {
+    if (multi_threading_enabled_) {
+      return true;
+    }
+    if (base_params_.try_enable_multi_threading()) {
+      multi_threading_enabled_ = true;
+      return true;
+    }
+    return false;
+  }
+};
+
 /**
  * This lazy-function wraps a group node. Internally it just executes the lazy-function graph of
  * the referenced group.
@@ -1142,9 +1247,21 @@ class LazyFunctionForGroupNode : public LazyFunction {
   const bNode &group_node_;
   const GeometryNodesGroupFunction &group_lazy_function_;
   bool has_many_nodes_ = false;
+  /** Identifies the graph of the node group in the cache, zero if it is not memoized. */
+  uint64_t memoization_graph_id_ = 0;
+  /** Main inputs of the node group that are part of the cache key. */
+  Span<int> memoization_key_inputs_;
 
   struct Storage {
     void *group_storage = nullptr;
+    GroupMemoizeState memoize_state = GroupMemoizeState::Unknown;
+    /** Inputs that have been requested to build the cache key. */
+    BitVector<> requested_inputs;
+    std::optional<memoize::GroupCallKey> memoize_key;
+    std::unique_ptr<memoize::GroupCallResult> recording;
+    /** A warning was logged in the group while recording its outputs. */
+    std::atomic<bool> warning_logged = false;
+    bool multi_threading_enabled = false;
   };
 
  public:
@@ -1161,6 +1278,12 @@ class LazyFunctionForGroupNode : public LazyFunction {
     outputs_ = group_lf_graph_info.function.function->outputs();
 
     has_many_nodes_ = group_lf_graph_info.num_inline_nodes_approximate > 1000;
+    if (group_lf_graph_info.num_inline_nodes_approximate >= min_nodes_to_memoize &&
+        group_lf_graph_info.memoization_graph_id != 0)
+    {
+      memoization_graph_id_ = group_lf_graph_info.memoization_graph_id;
+      memoization_key_inputs_ = *group_lf_graph_info.memoization_key_inputs;
+    }
 
     /* Add a boolean input for every output bsocket that indicates whether that socket is used. */
     for (const int i : group_node.output_sockets().index_range()) {
@@ -1192,13 +1315,10 @@ class LazyFunctionForGroupNode : public LazyFunction {
     auto &local_user_data = *static_cast<GeoNodesLocalUserData *>(context.local_user_data);
 
     if (user_data->is_stack_limit_reached()) {
-      if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(*user_data))
-      {
-        tree_logger->node_warnings.append(
-            *tree_logger->allocator,
-            {group_node_.identifier,
-             {NodeWarningType::Error, TIP_("Stack limit reached. Group node is ignored.")}});
-      }
+      local_user_data.log_warning(
+          *user_data,
+          group_node_.identifier,
+          {NodeWarningType::Error, TIP_("Stack limit reached. Group node is ignored.")});
       for (const int i : group_lazy_function_.outputs.main.index_range()) {
         const bNodeSocket &socket = group_node_.output_socket(i);
         set_default_value_for_output_socket(params, group_lazy_function_.outputs.main[i], socket);
@@ -1225,11 +1345,133 @@ class LazyFunctionForGroupNode : public LazyFunction {
     group_user_data.verbose_log = should_log_verbose_in_context(*user_data,
                                                                 compute_context.hash());
 
+    if (memoization_graph_id_ != 0) {
+      if (storage->memoize_state == GroupMemoizeState::Unknown) {
+        if (group_user_data.call_data->eval_log && group_user_data.verbose_log) {
+          /* The logged values of nodes in the group would be missing when using cached outputs. */
+          storage->memoize_state = GroupMemoizeState::Disabled;
+        }
+        else if (this->try_output_memoized_result(params, *storage, compute_context.hash())) {
+          return;
+        }
+      }
+      if (storage->memoize_state == GroupMemoizeState::Unknown) {
+        /* Wait until all inputs required for the cache lookup are available. */
+        return;
+      }
+    }
+
+    if (storage->recording) {
+      group_user_data.warning_logged = &storage->warning_logged;
+    }
+
     GeoNodesLocalUserData group_local_user_data{group_user_data};
     lf::Context group_context{storage->group_storage, &group_user_data, &group_local_user_data};
 
     ScopedComputeContextTimer timer(group_context);
-    group_lazy_function_.function->execute(params, group_context);
+    if (memoization_graph_id_ == 0) {
+      group_lazy_function_.function->execute(params, group_context);
+      return;
+    }
+    MemoizeGroupParams memoize_params{params,
+                                      group_lazy_function_,
+                                      storage->requested_inputs,
+                                      storage->recording.get(),
+                                      storage->multi_threading_enabled};
+    group_lazy_function_.function->execute(memoize_params, group_context);
+
+    const bool warning_logged = storage->warning_logged.load(std::memory_order_relaxed);
+    if (warning_logged && user_data->warning_logged) {
+      /* A node group containing this one must not be memoized either. */
+      user_data->warning_logged->store(true, std::memory_order_relaxed);
+    }
+    if (storage->recording && storage->recording->is_complete()) {
+      if (warning_logged) {
+        /* The warnings of the nodes in the group would be missing when the cached outputs are
+         * used, so the group is evaluated every time instead. */
+        storage->recording.reset();
+      }
+      else {
+        memory_cache::add(*storage->memoize_key, std::move(storage->recording));
+      }
+      storage->memoize_state = GroupMemoizeState::Disabled;
+    }
+  }
+
+  /**
+   * Request the inputs of the node group that it always uses, and use the cached outputs once
+   * they are available. Other inputs are never used by the group.
+   * \return True when all outputs have been set from the cache.
+   */
+  bool try_output_memoized_result(lf::Params &params,
+                                  Storage &storage,
+                                  const ComputeContextHash &context_hash) const
+  {
+    if (storage.requested_inputs.is_empty()) {
+      storage.requested_inputs.resize(inputs_.size(), false);
+    }
+    bool all_inputs_available = true;
+    for (const int i : group_lazy_function_.inputs.output_usages) {
+      storage.requested_inputs[i].set();
+      const bool *is_used = params.try_get_input_data_ptr_or_request<bool>(i);
+      if (is_used == nullptr) {
+        all_inputs_available = false;
+      }
+      else if (!*is_used) {
+        /* Only some outputs are computed, those can't be cached. */
+        storage.memoize_state = GroupMemoizeState::Disabled;
+        return false;
+      }
+    }
+    Vector<GPointer, 16> key_inputs;
+    const auto request_key_input = [&](const int i) {
+      storage.requested_inputs[i].set();
+      const void *value = params.try_get_input_data_ptr_or_request(i);
+      if (value == nullptr) {
+        all_inputs_available = false;
+      }
+      else {
+        key_inputs.append({inputs_[i].type, value});
+      }
+    };
+    for (const int i : memoization_key_inputs_) {
+      request_key_input(group_lazy_function_.inputs.main[i]);
+    }
+    for (const int i : group_lazy_function_.inputs.references_to_propagate.range) {
+      request_key_input(i);
+    }
+    if (!all_inputs_available) {
+      return false;
+    }
+
+    Vector<memoize::RetainedData> retained_data;
+    storage.memoize_key = memoize::build_group_call_key(
+        memoization_graph_id_, context_hash, key_inputs, retained_data);
+    if (!storage.memoize_key) {
+      storage.memoize_state = GroupMemoizeState::Disabled;
+      return false;
+    }
+
+    if (const std::shared_ptr<const memoize::GroupCallResult> result =
+            memory_cache::lookup<memoize::GroupCallResult>(*storage.memoize_key))
+    {
+      for (const int i : group_lazy_function_.outputs.main.index_range()) {
+        const int lf_index = group_lazy_function_.outputs.main[i];
+        result->copy_output_to_uninitialized(i, params.get_output_data_ptr(lf_index));
+        params.output_set(lf_index);
+      }
+      for (const int i : group_lazy_function_.outputs.input_usages.index_range()) {
+        params.set_output(group_lazy_function_.outputs.input_usages[i], *result->input_usages[i]);
+      }
+      return true;
+    }
+
+    storage.recording = std::make_unique<memoize::GroupCallResult>(
+        group_lazy_function_.outputs.main.size(),
+        group_lazy_function_.outputs.input_usages.size());
+    storage.recording->retained_data = std::move(retained_data);
+    storage.memoize_state = GroupMemoizeState::Recording;
+    return false;
   }
 
   void *init_storage(LinearAllocator<> &allocator) const override
@@ -1619,6 +1861,9 @@ void report_from_multi_function(const mf::Context &context,
   if (!user_data) {
     return;
   }
+  if (user_data->warning_logged) {
+    user_data->warning_logged->store(true, std::memory_order_relaxed);
+  }
   eval_log::NodesEvalLog *log = user_data->call_data->eval_log;
   if (!log) {
     return;
@@ -2547,6 +2792,9 @@ struct GeometryNodesLazyFunctionBuilder {
     function.outputs.input_usages = lf_graph_outputs.index_range().take_back(
         group_input_usage_sockets_.size());
 
+    lf_graph_info_->memoization_key_inputs = memoize::find_key_inputs(
+        group_input_sockets_, standard_group_output_sockets_);
+
     Vector<const lf::FunctionNode *> &local_side_effect_nodes =
         scope_.construct<Vector<const lf::FunctionNode *>>();
     for (const bNode *bnode : btree_.nodes_by_type("GeometryNodeWarning"_ustr)) {
@@ -4327,6 +4575,10 @@ ensure_geometry_nodes_lazy_function_graph_impl(const bNodeTree &btree)
 
   GeometryNodesLazyFunctionBuilder builder{lf_graph_info};
   builder.build();
+
+  if (memoize::group_results_can_be_memoized(*btree_copy, *lf_graph_info)) {
+    lf_graph_info->memoization_graph_id = memoize::new_graph_id();
+  }
   return lf_graph_info;
 }
 
@@ -4354,6 +4606,18 @@ void GeoNodesLocalUserData::ensure_tree_logger(const GeoNodesUserData &user_data
   this->tree_logger_.emplace(nullptr);
 }
 
+void GeoNodesLocalUserData::log_warning(const GeoNodesUserData &user_data,
+                                        const int32_t node_id,
+                                        eval_log::NodeWarning warning) const
+{
+  if (user_data.warning_logged) {
+    user_data.warning_logged->store(true, std::memory_order_relaxed);
+  }
+  if (eval_log::NodeTreeLogger *tree_logger = this->try_get_tree_logger(user_data)) {
+    tree_logger->node_warnings.append(*tree_logger->allocator, {node_id, std::move(warning)});
+  }
+}
+
 std::optional<FoundNestedNodeID> find_nested_node_id(const GeoNodesUserData &user_data,
                                                      const int node_id)
 {
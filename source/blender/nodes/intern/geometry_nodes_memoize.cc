@@ -0,0 +1,616 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup nodes
+ */
+
+#include <algorithm>
+#include <atomic>
+
+#include "xxhash.h"
+
+#include "BLI_listbase.hh"
+#include "BLI_memory_counter.hh"
+#include "BLI_set.hh"
+#include "BLI_stack.hh"
+
+#include "DNA_customdata_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_node_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_curves.hh"
+#include "BKE_customdata.hh"
+#include "BKE_geometry_nodes_reference_set.hh"
+#include "BKE_instances.hh"
+#include "BKE_mesh_types.hh"
+#include "BKE_node_runtime.hh"
+
+#include "NOD_dependencies.hh"
+#include "NOD_geometry_nodes_lazy_function.hh"
+
+#include "geometry_nodes_memoize.hh"
+
+namespace blender::nodes::memoize {
+
+/* -------------------------------------------------------------------- */
+/** \name Node Group Analysis
+ * \{ */
+
+static bool is_supported_value_type(const CPPType &type)
+{
+  return type.is<bke::SocketValueVariant>() || type.is<bke::GeometrySet>();
+}
+
+static bool is_data_block_socket_type(const eNodeSocketDatatype type)
+{
+  switch (type) {
+    case SOCK_OBJECT:
+    case SOCK_COLLECTION:
+    case SOCK_MATERIAL:
+    case SOCK_TEXTURE:
+    case SOCK_IMAGE:
+    case SOCK_FONT:
+    case SOCK_SCENE:
+    case SOCK_TEXT_ID:
+    case SOCK_MASK:
+    case SOCK_SOUND:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool socket_depends_on_context(const bNodeSocket &socket)
+{
+  if (!socket.is_available()) {
+    return false;
+  }
+  /* Data-blocks passed into the group may change without their pointer changing. */
+  return is_data_block_socket_type(eNodeSocketDatatype(socket.type));
+}
+
+static bool eval_dependencies_are_empty(const EvalDependencies &deps)
+{
+  return deps.ids.is_empty() && !deps.needs_own_transform && !deps.needs_active_camera &&
+         !deps.needs_scene_render_params && !deps.time_dependent;
+}
+
+std::optional<Vector<int>> find_key_inputs(const Span<const lf::GraphInputSocket *> group_inputs,
+                                           const Span<const lf::GraphOutputSocket *> group_outputs)
+{
+  /* Nodes whose inputs are used as soon as one of their outputs is requested are always executed
+   * when an output that depends on them is computed. Inputs that are requested lazily, like the
+   * inputs of a Switch node, may remain unused. */
+  Set<const lf::Node *> executed_nodes;
+  Set<const lf::GraphInputSocket *> used_inputs;
+  Stack<const lf::InputSocket *> sockets_to_check;
+  sockets_to_check.push_multiple(group_outputs);
+  while (!sockets_to_check.is_empty()) {
+    const lf::OutputSocket *origin = sockets_to_check.pop()->origin();
+    if (origin == nullptr) {
+      continue;
+    }
+    const lf::Node &node = origin->node();
+    if (node.is_interface()) {
+      used_inputs.add(origin);
+      continue;
+    }
+    if (!executed_nodes.add(&node)) {
+      continue;
+    }
+    const LazyFunction &fn = static_cast<const lf::FunctionNode &>(node).function();
+    for (const lf::InputSocket *input : node.inputs()) {
+      if (fn.inputs()[input->index()].usage == lf::ValueUsage::Used) {
+        sockets_to_check.push(input);
+      }
+    }
+  }
+
+  Vector<int> key_inputs;
+  for (const int i : group_inputs.index_range()) {
+    const lf::GraphInputSocket &socket = *group_inputs[i];
+    if (used_inputs.contains(&socket)) {
+      key_inputs.append(i);
+    }
+    else if (!socket.targets().is_empty()) {
+      return std::nullopt;
+    }
+  }
+  return key_inputs;
+}
+
+bool group_results_can_be_memoized(const bNodeTree &tree,
+                                   const GeometryNodesLazyFunctionGraphInfo &lf_graph_info)
+{
+  if (!lf_graph_info.memoization_key_inputs) {
+    return false;
+  }
+  const GeometryNodesGroupFunction &function = lf_graph_info.function;
+  const LazyFunction &fn = *function.function;
+  for (const int i : function.inputs.main) {
+    if (!is_supported_value_type(*fn.inputs()[i].type)) {
+      return false;
+    }
+  }
+  for (const int i : function.outputs.main) {
+    if (!is_supported_value_type(*fn.outputs()[i].type)) {
+      return false;
+    }
+  }
+
+  tree.ensure_topology_cache();
+  /* Nested groups are checked with their own memoization state below. */
+  const EvalDependencies deps = gather_eval_dependencies_with_cache(tree);
+  if (!eval_dependencies_are_empty(deps)) {
+    return false;
+  }
+  for (const bNode *node : tree.all_nodes()) {
+    if (node->is_undefined()) {
+      return false;
+    }
+    if (node->is_group()) {
+      if (const bNodeTree *group = reinterpret_cast<const bNodeTree *>(node->id)) {
+        const std::shared_ptr<const GeometryNodesLazyFunctionGraphInfo> &group_lf_graph_info =
+            ensure_geometry_nodes_lazy_function_graph(*group);
+        if (!group_lf_graph_info || group_lf_graph_info->memoization_graph_id == 0) {
+          return false;
+        }
+      }
+      continue;
+    }
+    if (node->typeinfo->depends_on_eval_context) {
+      return false;
+    }
+    for (const bNodeSocket *socket : node->input_sockets()) {
+      if (socket_depends_on_context(*socket)) {
+        return false;
+      }
+    }
+    for (const bNodeSocket *socket : node->output_sockets()) {
+      if (socket_depends_on_context(*socket)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+uint64_t new_graph_id()
+{
+  static std::atomic<uint64_t> last_id = 0;
+  return last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Key
+ * \{ */
+
+uint64_t GroupCallKey::hash() const
+{
+  return hash_.hash();
+}
+
+bool GroupCallKey::equal_to(const GenericKey &other) const
+{
+  if (const auto *other_typed = dynamic_cast<const GroupCallKey *>(&other)) {
+    return other_typed->hash_ == hash_;
+  }
+  return false;
+}
+
+std::unique_ptr<GenericKey> GroupCallKey::to_storable() const
+{
+  return std::make_unique<GroupCallKey>(*this);
+}
+
+static void hash_string(const StringRef str, UniqueHashBytes &hash)
+{
+  hash.add(str.size());
+  hash.data.extend(Span(str.data(), str.size()).cast<std::byte>());
+}
+
+static void hash_shared_data(const ImplicitSharingInfo *sharing_info,
+                             const void *data,
+                             const int64_t size_in_bytes,
+                             UniqueHashBytes &hash,
+                             Vector<RetainedData> &r_retained_data)
+{
+  hash.add(sharing_info);
+  hash.add(data);
+  hash.add(size_in_bytes);
+  sharing_info->add_user();
+  r_retained_data.append({ImplicitSharingPtr<>(sharing_info), size_in_bytes});
+}
+
+static bool hash_attributes(const bke::AttributeAccessor attributes,
+                            const Set<StringRef> &skipped_names,
+                            UniqueHashBytes &hash,
+                            Vector<RetainedData> &r_retained_data)
+{
+  bool success = true;
+  attributes.foreach_attribute([&](const bke::AttributeIter &iter) {
+    if (skipped_names.contains(iter.name)) {
+      return;
+    }
+    const bke::GAttributeReader reader = iter.get();
+    if (!reader.sharing_info || !reader.varray.is_span()) {
+      /* Virtual arrays can't be identified without hashing all values. */
+      success = false;
+      iter.stop();
+      return;
+    }
+    const GSpan span = reader.varray.get_internal_span();
+    hash_string(iter.name, hash);
+    hash.add(iter.domain);
+    hash.add(iter.data_type);
+    hash_shared_data(
+        reader.sharing_info, span.data(), span.size_in_bytes(), hash, r_retained_data);
+  });
+  return success;
+}
+
+/** Hash generic data that is not exposed as attribute, like vertex group weights. */
+static bool hash_custom_data(const CustomData &data,
+                             const int elements_num,
+                             UniqueHashBytes &hash,
+                             Vector<RetainedData> &r_retained_data)
+{
+  for (const CustomDataLayer &layer : Span(data.layers, data.totlayer)) {
+    if (layer.data == nullptr) {
+      continue;
+    }
+    if (layer.sharing_info == nullptr) {
+      return false;
+    }
+    hash.add(layer.type);
+    hash_string(layer.name, hash);
+    hash_shared_data(layer.sharing_info,
+                     layer.data,
+                     int64_t(CustomData_get_elem_size(&layer)) * elements_num,
+                     hash,
+                     r_retained_data);
+  }
+  return true;
+}
+
+/**
+ * Vertex groups are exposed as virtual arrays by the attribute API, they are identified by their
+ * custom data layer instead.
+ */
+static Set<StringRef> hash_vertex_group_names(const ListBaseT<bDeformGroup> &vertex_group_names,
+                                              UniqueHashBytes &hash)
+{
+  Set<StringRef> names;
+  for (const bDeformGroup &group : vertex_group_names) {
+    hash_string(group.name, hash);
+    names.add(group.name);
+  }
+  hash.add(names.size());
+  return names;
+}
+
+static void hash_optional_string(const char *str, UniqueHashBytes &hash)
+{
+  hash_string(str ? StringRef(str) : StringRef(), hash);
+}
+
+/**
+ * Material pointers are only passed through by node groups that don't reference any data-blocks
+ * themselves, so it's enough to compare their addresses.
+ */
+static void hash_materials(const Span<Material *> materials, UniqueHashBytes &hash)
+{
+  hash.add(materials.size());
+  for (const Material *material : materials) {
+    hash.add(material);
+  }
+}
+
+static bool hash_mesh(const Mesh &mesh, UniqueHashBytes &hash, Vector<RetainedData> &r_data)
+{
+  hash.add(mesh.verts_num);
+  hash.add(mesh.edges_num);
+  hash.add(mesh.faces_num);
+  hash.add(mesh.corners_num);
+  if (mesh.faces_num > 0) {
+    if (!mesh.runtime->face_offsets_sharing_info) {
+      return false;
+    }
+    hash_shared_data(mesh.runtime->face_offsets_sharing_info,
+                     mesh.face_offset_indices,
+                     sizeof(int) * (mesh.faces_num + 1),
+                     hash,
+                     r_data);
+  }
+  hash_optional_string(mesh.active_color_attribute, hash);
+  hash_optional_string(mesh.default_color_attribute, hash);
+  hash_optional_string(mesh.active_uv_map_attribute, hash);
+  hash_optional_string(mesh.default_uv_map_attribute, hash);
+  hash_materials({mesh.mat, mesh.totcol}, hash);
+  const Set<StringRef> vertex_group_names = hash_vertex_group_names(mesh.vertex_group_names, hash);
+  return hash_custom_data(mesh.vert_data, mesh.verts_num, hash, r_data) &&
+         hash_custom_data(mesh.edge_data, mesh.edges_num, hash, r_data) &&
+         hash_custom_data(mesh.face_data, mesh.faces_num, hash, r_data) &&
+         hash_custom_data(mesh.corner_data, mesh.corners_num, hash, r_data) &&
+         hash_attributes(mesh.attributes(), vertex_group_names, hash, r_data);
+}
+
+static bool hash_pointcloud(const PointCloud &pointcloud,
+                            UniqueHashBytes &hash,
+                            Vector<RetainedData> &r_data)
+{
+  hash.add(pointcloud.totpoint);
+  hash_materials({pointcloud.mat, pointcloud.totcol}, hash);
+  return hash_attributes(pointcloud.attributes(), {}, hash, r_data);
+}
+
+static bool hash_curves(const Curves &curves_id,
+                        UniqueHashBytes &hash,
+                        Vector<RetainedData> &r_data)
+{
+  if (curves_id.surface != nullptr) {
+    return false;
+  }
+  const bke::CurvesGeometry &curves = curves_id.geometry.wrap();
+  hash.add(curves.points_num());
+  hash.add(curves.curves_num());
+  if (curves.curves_num() > 0) {
+    if (!curves.runtime->curve_offsets_sharing_info) {
+      return false;
+    }
+    hash_shared_data(curves.runtime->curve_offsets_sharing_info,
+                     curves.curve_offsets,
+                     sizeof(int) * (curves.curves_num() + 1),
+                     hash,
+                     r_data);
+  }
+  if (curves.nurbs_has_custom_knots()) {
+    if (!curves.runtime->custom_knots_sharing_info) {
+      return false;
+    }
+    const Span<float> knots = curves.nurbs_custom_knots();
+    hash_shared_data(curves.runtime->custom_knots_sharing_info,
+                     knots.data(),
+                     knots.size_in_bytes(),
+                     hash,
+                     r_data);
+  }
+  hash_materials({curves_id.mat, curves_id.totcol}, hash);
+  const Set<StringRef> vertex_group_names = hash_vertex_group_names(curves.vertex_group_names,
+                                                                    hash);
+  return hash_custom_data(curves.point_data, curves.points_num(), hash, r_data) &&
+         hash_attributes(curves.attributes(), vertex_group_names, hash, r_data);
+}
+
+static bool hash_geometry(const bke::GeometrySet &geometry,
+                          UniqueHashBytes &hash,
+                          Vector<RetainedData> &r_data);
+
+static bool hash_instances(const bke::Instances &instances,
+                           UniqueHashBytes &hash,
+                           Vector<RetainedData> &r_data)
+{
+  hash.add(instances.instances_num());
+  const Span<bke::InstanceReference> references = instances.references();
+  hash.add(references.size());
+  for (const bke::InstanceReference &reference : references) {
+    hash.add(reference.type());
+    switch (reference.type()) {
+      case bke::InstanceReference::Type::None:
+        break;
+      case bke::InstanceReference::Type::GeometrySet:
+        if (!hash_geometry(reference.geometry_set(), hash, r_data)) {
+          return false;
+        }
+        break;
+      case bke::InstanceReference::Type::Object:
+      case bke::InstanceReference::Type::Collection:
+        return false;
+    }
+  }
+  return hash_attributes(instances.attributes(), {}, hash, r_data);
+}
+
+static bool hash_geometry(const bke::GeometrySet &geometry,
+                          UniqueHashBytes &hash,
+                          Vector<RetainedData> &r_data)
+{
+  if (geometry.has_bundle()) {
+    return false;
+  }
+  hash_string(geometry.name(), hash);
+  for (const bke::GeometryComponent *component : geometry.get_components()) {
+    hash.add(component->type());
+    switch (component->type()) {
+      case bke::GeometryComponent::Type::Mesh: {
+        const Mesh *mesh = static_cast<const bke::MeshComponent *>(component)->get();
+        if (mesh && !hash_mesh(*mesh, hash, r_data)) {
+          return false;
+        }
+        break;
+      }
+      case bke::GeometryComponent::Type::PointCloud: {
+        const PointCloud *pointcloud =
+            static_cast<const bke::PointCloudComponent *>(component)->get();
+        if (pointcloud && !hash_pointcloud(*pointcloud, hash, r_data)) {
+          return false;
+        }
+        break;
+      }
+      case bke::GeometryComponent::Type::Curve: {
+        const Curves *curves = static_cast<const bke::CurveComponent *>(component)->get();
+        if (curves && !hash_curves(*curves, hash, r_data)) {
+          return false;
+        }
+        break;
+      }
+      case bke::GeometryComponent::Type::Instance: {
+        const bke::Instances *instances =
+            static_cast<const bke::InstancesComponent *>(component)->get();
+        if (instances && !hash_instances(*instances, hash, r_data)) {
+          return false;
+        }
+        break;
+      }
+      case bke::GeometryComponent::Type::Volume:
+      case bke::GeometryComponent::Type::Edit:
+      case bke::GeometryComponent::Type::GreasePencil:
+        return false;
+    }
+  }
+  return true;
+}
+
+static bool hash_socket_value(const bke::SocketValueVariant &value, UniqueHashBytes &hash)
+{
+  if (!value.is_single()) {
+    /* Fields may reference data by address that is not owned by the field, so they can't be
+     * compared reliably across evaluations. */
+    return false;
+  }
+  const GPointer single_value = value.get_single_ptr();
+  const CPPType &type = *single_value.type();
+  if (!type.is_hashable()) {
+    return false;
+  }
+  hash.add(value.socket_type());
+  if (type.is<std::string>()) {
+    hash_string(*single_value.get<std::string>(), hash);
+  }
+  else {
+    type.hash_unique(single_value.get(), hash);
+  }
+  return true;
+}
+
+static void hash_reference_set(const bke::GeometryNodesReferenceSet &reference_set,
+                               UniqueHashBytes &hash)
+{
+  if (!reference_set.names) {
+    hash.add(0);
+    return;
+  }
+  Vector<StringRef> names(reference_set.names->begin(), reference_set.names->end());
+  std::sort(names.begin(), names.end());
+  hash.add(names.size());
+  for (const StringRef name : names) {
+    hash_string(name, hash);
+  }
+}
+
+std::optional<GroupCallKey> build_group_call_key(const uint64_t graph_id,
+                                                 const UniqueHash &context_hash,
+                                                 const Span<GPointer> inputs,
+                                                 Vector<RetainedData> &r_retained_data)
+{
+  UniqueHashBytes hash;
+  hash.add(graph_id);
+  hash.add(context_hash);
+  for (const GPointer input : inputs) {
+    const CPPType &type = *input.type();
+    if (type.is<bke::SocketValueVariant>()) {
+      if (!hash_socket_value(*input.get<bke::SocketValueVariant>(), hash)) {
+        return std::nullopt;
+      }
+    }
+    else if (type.is<bke::GeometrySet>()) {
+      if (!hash_geometry(*input.get<bke::GeometrySet>(), hash, r_retained_data)) {
+        return std::nullopt;
+      }
+    }
+    else if (type.is<bke::GeometryNodesReferenceSet>()) {
+      hash_reference_set(*input.get<bke::GeometryNodesReferenceSet>(), hash);
+    }
+    else {
+      return std::nullopt;
+    }
+  }
+  const Span<std::byte> bytes = hash.data.as_span();
+  const XXH128_hash_t xxhash = XXH3_128bits(bytes.data(), bytes.size());
+  return GroupCallKey(UniqueHash{xxhash.low64, xxhash.high64});
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Cached Result
+ * \{ */
+
+GroupCallResult::GroupCallResult(const int outputs_num, const int inputs_num)
+    : outputs(outputs_num), input_usages(inputs_num)
+{
+}
+
+void GroupCallResult::record_output(const int index, const GPointer value)
+{
+  const CPPType &type = *value.type();
+  if (type.is<bke::GeometrySet>()) {
+    bke::GeometrySet geometry = *value.get<bke::GeometrySet>();
+    geometry.ensure_owns_direct_data();
+    this->outputs[index] = std::move(geometry);
+  }
+  else {
+    bke::SocketValueVariant value_variant = *value.get<bke::SocketValueVariant>();
+    value_variant.ensure_owns_direct_data();
+    this->outputs[index] = std::move(value_variant);
+  }
+}
+
+void GroupCallResult::copy_output_to_uninitialized(const int index, void *dst) const
+{
+  std::visit(
+      [&]<typename T>(const T &value) {
+        if constexpr (std::is_same_v<T, std::monostate>) {
+          BLI_assert_unreachable();
+        }
+        else {
+          new (dst) T(value);
+        }
+      },
+      this->outputs[index]);
+}
+
+bool GroupCallResult::is_complete() const
+{
+  for (const Value &value : this->outputs) {
+    if (std::holds_alternative<std::monostate>(value)) {
+      return false;
+    }
+  }
+  for (const std::optional<bool> &usage : this->input_usages) {
+    if (!usage.has_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GroupCallResult::count_memory(MemoryCounter &memory) const
+{
+  for (const Value &value : this->outputs) {
+    if (const bke::GeometrySet *geometry = std::get_if<bke::GeometrySet>(&value)) {
+      geometry->count_memory(memory);
+    }
+    else if (const bke::SocketValueVariant *value_variant = std::get_if<bke::SocketValueVariant>(
+                 &value))
+    {
+      value_variant->count_memory(memory);
+    }
+  }
+  /* The inputs are often shared with the original data, in which case the cache does not use any
+   * extra memory for them. However, they may also be intermediate data that is only kept alive by
+   * the cache. */
+  for (const RetainedData &data : this->retained_data) {
+    memory.add_shared(data.sharing_info.get(), data.size_in_bytes);
+  }
+}
+
+/** \} */
+
+}  // namespace blender::nodes::memoize
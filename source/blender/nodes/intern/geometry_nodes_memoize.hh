@@ -0,0 +1,129 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup nodes
+ *
+ * Memoization of node group evaluations across evaluations of the node tree. When a node group
+ * only depends on its inputs (i.e. it does not access the scene time, other objects or any other
+ * context), its outputs can be reused as long as the inputs don't change. This avoids
+ * recomputing expensive node groups when only nodes after them changed.
+ *
+ * The results are stored in the global #memory_cache, so the amount of memory used is limited by
+ * the memory cache limit in the preferences.
+ */
+
+#pragma once
+
+#include <variant>
+
+#include "BLI_array.hh"
+#include "BLI_generic_pointer.hh"
+#include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_memory_cache.hh"
+#include "BLI_unique_hash.hh"
+
+#include "BKE_geometry_set.hh"
+#include "BKE_node_socket_value.hh"
+
+#include "FN_lazy_function_graph.hh"
+
+struct bNodeTree;
+
+namespace blender::nodes {
+
+struct GeometryNodesLazyFunctionGraphInfo;
+
+namespace memoize {
+
+/**
+ * Find the main inputs of the node group that are used whenever all of its outputs are computed.
+ * Those are requested before the group is evaluated, to look up its results in the cache. Inputs
+ * that are not linked are not used at all and are not part of the result.
+ *
+ * \return Nothing if some inputs are only used depending on other values, e.g. because they are
+ * passed to a Switch node. Requesting them for the cache lookup could compute values that are not
+ * needed otherwise.
+ */
+std::optional<Vector<int>> find_key_inputs(Span<const lf::GraphInputSocket *> group_inputs,
+                                           Span<const lf::GraphOutputSocket *> group_outputs);
+
+/**
+ * Check whether the outputs of the node group only depend on its inputs, and whether all of its
+ * inputs and outputs have types that can be memoized. Nested node groups have to be built before
+ * this is called.
+ */
+bool group_results_can_be_memoized(const bNodeTree &tree,
+                                   const GeometryNodesLazyFunctionGraphInfo &lf_graph_info);
+
+/**
+ * Get a new identifier for a lazy-function graph whose results can be memoized. It is part of the
+ * key of the cached values, so that values computed by an outdated graph are not used anymore.
+ */
+uint64_t new_graph_id();
+
+/**
+ * Data that is referenced by the key of a cached value. It is kept alive as long as the value is
+ * cached, because the key contains the addresses of the data. Otherwise the memory could be reused
+ * for different data which would result in a false match.
+ */
+struct RetainedData {
+  ImplicitSharingPtr<> sharing_info;
+  int64_t size_in_bytes;
+};
+
+class GroupCallKey : public GenericKey {
+ private:
+  UniqueHash hash_;
+
+ public:
+  GroupCallKey(const UniqueHash &hash) : hash_(hash) {}
+
+  uint64_t hash() const override;
+  bool equal_to(const GenericKey &other) const override;
+  std::unique_ptr<GenericKey> to_storable() const override;
+};
+
+/**
+ * Build the key for calling a node group with the given input values. Geometries are identified by
+ * their implicitly shared data arrays, which are added to #r_retained_data. The compute context is
+ * part of the key because the names of anonymous attributes created by the group depend on it.
+ *
+ * \return Nothing if one of the values is not supported, e.g. because it is a field or a geometry
+ * with data that is not implicitly shared.
+ */
+std::optional<GroupCallKey> build_group_call_key(uint64_t graph_id,
+                                                 const UniqueHash &context_hash,
+                                                 Span<GPointer> inputs,
+                                                 Vector<RetainedData> &r_retained_data);
+
+/**
+ * The outputs of a node group for a specific set of inputs.
+ */
+class GroupCallResult : public memory_cache::CachedValue {
+ public:
+  using Value = std::variant<std::monostate, bke::SocketValueVariant, bke::GeometrySet>;
+
+  /** Main outputs of the node group. */
+  Array<Value> outputs;
+  /** Whether each input of the node group is used. */
+  Array<std::optional<bool>> input_usages;
+  Vector<RetainedData> retained_data;
+
+  GroupCallResult(int outputs_num, int inputs_num);
+
+  /** Store a copy of an output value that has just been computed. */
+  void record_output(int index, GPointer value);
+
+  /** Copy a stored output value into uninitialized memory. */
+  void copy_output_to_uninitialized(int index, void *dst) const;
+
+  /** True when all outputs have been recorded. */
+  bool is_complete() const;
+
+  void count_memory(MemoryCounter &memory) const override;
+};
+
+}  // namespace memoize
+}  // namespace blender::nodes
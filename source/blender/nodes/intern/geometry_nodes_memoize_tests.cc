@@ -0,0 +1,198 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_listbase.hh"
+
+#include "BKE_geometry_set.hh"
+#include "BKE_global.hh"
+#include "BKE_gtest_base.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.hh"
+#include "BKE_node.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_node_socket_value.hh"
+#include "BKE_node_tree_update.hh"
+
+#include "DNA_node_types.h"
+
+#include "NOD_geometry_nodes_lazy_function.hh"
+
+#include "geometry_nodes_memoize.hh"
+
+namespace blender::nodes::memoize::tests {
+
+class GeometryNodesMemoizeTest : public bke::BlenderGTestBase {};
+
+class TestData {
+ public:
+  Main *bmain = nullptr;
+
+  TestData()
+  {
+    bmain = BKE_main_new();
+    G.main = bmain;
+  }
+
+  ~TestData()
+  {
+    BKE_main_free(bmain);
+    G.main = nullptr;
+  }
+};
+
+/** A node group with two geometry inputs and one geometry output, without any links yet. */
+struct TestGroup {
+  bNodeTree *tree;
+  bNode *group_input;
+  bNode *group_output;
+
+  TestGroup(Main &bmain)
+  {
+    tree = bke::node_tree_add_tree(&bmain, "Test", "GeometryNodeTree");
+    tree->tree_interface.add_socket(
+        "A", "", "NodeSocketGeometry", NODE_INTERFACE_SOCKET_INPUT, nullptr);
+    tree->tree_interface.add_socket(
+        "B", "", "NodeSocketGeometry", NODE_INTERFACE_SOCKET_INPUT, nullptr);
+    tree->tree_interface.add_socket(
+        "Geometry", "", "NodeSocketGeometry", NODE_INTERFACE_SOCKET_OUTPUT, nullptr);
+    group_input = bke::node_add_node(nullptr, *tree, "NodeGroupInput"_ustr);
+    group_output = bke::node_add_node(nullptr, *tree, "NodeGroupOutput"_ustr);
+    BKE_ntree_update_after_single_tree_change(bmain, *tree);
+  }
+
+  bNodeSocket &group_input_socket(const int index)
+  {
+    return *static_cast<bNodeSocket *>(BLI_findlink(&group_input->outputs, index));
+  }
+
+  bNodeSocket &group_output_socket()
+  {
+    return *static_cast<bNodeSocket *>(group_output->inputs.first);
+  }
+
+  const GeometryNodesLazyFunctionGraphInfo &build(Main &bmain)
+  {
+    BKE_ntree_update_after_single_tree_change(bmain, *tree);
+    const std::shared_ptr<const GeometryNodesLazyFunctionGraphInfo> &lf_graph_info =
+        ensure_geometry_nodes_lazy_function_graph(*tree);
+    BLI_assert(lf_graph_info);
+    return *lf_graph_info;
+  }
+};
+
+static bNode &add_transform_node(Main &bmain, TestGroup &group)
+{
+  bNode &node = *bke::node_add_node(nullptr, *group.tree, "GeometryNodeTransform"_ustr);
+  BKE_ntree_update_after_single_tree_change(bmain, *group.tree);
+  bke::node_add_link(*group.tree,
+                     node,
+                     *node.output_by_identifier("Geometry"_ustr),
+                     *group.group_output,
+                     group.group_output_socket());
+  return node;
+}
+
+TEST_F(GeometryNodesMemoizeTest, unlinked_inputs_are_not_part_of_key)
+{
+  TestData data;
+  TestGroup group(*data.bmain);
+  bNode &transform = add_transform_node(*data.bmain, group);
+  bke::node_add_link(*group.tree,
+                     *group.group_input,
+                     group.group_input_socket(0),
+                     transform,
+                     *transform.input_by_identifier("Geometry"_ustr));
+
+  const GeometryNodesLazyFunctionGraphInfo &lf_graph_info = group.build(*data.bmain);
+  EXPECT_NE(lf_graph_info.memoization_graph_id, 0);
+  ASSERT_TRUE(lf_graph_info.memoization_key_inputs.has_value());
+  EXPECT_EQ(lf_graph_info.memoization_key_inputs->as_span(), Span<int>({0}));
+}
+
+TEST_F(GeometryNodesMemoizeTest, context_dependent_node)
+{
+  TestData data;
+  TestGroup group(*data.bmain);
+  bNode &transform = add_transform_node(*data.bmain, group);
+  bke::node_add_link(*group.tree,
+                     *group.group_input,
+                     group.group_input_socket(0),
+                     transform,
+                     *transform.input_by_identifier("Geometry"_ustr));
+  bNode &scene_time = *bke::node_add_node(nullptr, *group.tree, "GeometryNodeInputSceneTime"_ustr);
+  bNode &combine = *bke::node_add_node(nullptr, *group.tree, "ShaderNodeCombineXYZ"_ustr);
+  BKE_ntree_update_after_single_tree_change(*data.bmain, *group.tree);
+  bke::node_add_link(*group.tree,
+                     scene_time,
+                     *scene_time.output_by_identifier("Frame"_ustr),
+                     combine,
+                     *combine.input_by_identifier("X"_ustr));
+  bke::node_add_link(*group.tree,
+                     combine,
+                     *combine.output_by_identifier("Vector"_ustr),
+                     transform,
+                     *transform.input_by_identifier("Translation"_ustr));
+
+  const GeometryNodesLazyFunctionGraphInfo &lf_graph_info = group.build(*data.bmain);
+  EXPECT_EQ(lf_graph_info.memoization_graph_id, 0);
+}
+
+TEST_F(GeometryNodesMemoizeTest, lazily_used_inputs)
+{
+  TestData data;
+  TestGroup group(*data.bmain);
+  bNode &switch_node = *bke::node_add_node(nullptr, *group.tree, "GeometryNodeSwitch"_ustr);
+  static_cast<NodeSwitch *>(switch_node.storage)->input_type = SOCK_GEOMETRY;
+  BKE_ntree_update_after_single_tree_change(*data.bmain, *group.tree);
+  bke::node_add_link(*group.tree,
+                     *group.group_input,
+                     group.group_input_socket(0),
+                     switch_node,
+                     *switch_node.input_by_identifier("False"_ustr));
+  bke::node_add_link(*group.tree,
+                     *group.group_input,
+                     group.group_input_socket(1),
+                     switch_node,
+                     *switch_node.input_by_identifier("True"_ustr));
+  bke::node_add_link(*group.tree,
+                     switch_node,
+                     *switch_node.output_by_identifier("Output"_ustr),
+                     *group.group_output,
+                     group.group_output_socket());
+
+  /* Requesting both inputs to build the key would compute the one that is not used. */
+  const GeometryNodesLazyFunctionGraphInfo &lf_graph_info = group.build(*data.bmain);
+  EXPECT_FALSE(lf_graph_info.memoization_key_inputs.has_value());
+  EXPECT_EQ(lf_graph_info.memoization_graph_id, 0);
+}
+
+TEST_F(GeometryNodesMemoizeTest, group_call_key)
+{
+  const UniqueHash context_hash{1, 2};
+  const auto build_key = [&](const bke::GeometrySet &geometry, const float value) {
+    const bke::SocketValueVariant value_variant = bke::SocketValueVariant::From(value);
+    const Array<GPointer> inputs = {GPointer(&geometry), GPointer(&value_variant)};
+    Vector<RetainedData> retained_data;
+    std::optional<GroupCallKey> key = build_group_call_key(
+        1, context_hash, inputs, retained_data);
+    EXPECT_TRUE(key.has_value());
+    return *key;
+  };
+
+  const bke::GeometrySet geometry = bke::GeometrySet::from_mesh(BKE_mesh_new_nomain(3, 0, 0, 0));
+  const GroupCallKey key = build_key(geometry, 1.0f);
+  EXPECT_TRUE(key.equal_to(build_key(geometry, 1.0f)));
+  EXPECT_FALSE(key.equal_to(build_key(geometry, 2.0f)));
+
+  /* Copies of the geometry share the same data and are identified as equal. */
+  bke::GeometrySet geometry_copy = geometry;
+  EXPECT_TRUE(key.equal_to(build_key(geometry_copy, 1.0f)));
+
+  geometry_copy.get_mesh_for_write()->vert_positions_for_write()[0] = float3(1.0f);
+  EXPECT_FALSE(key.equal_to(build_key(geometry_copy, 1.0f)));
+}
+
+}  // namespace blender::nodes::memoize::tests
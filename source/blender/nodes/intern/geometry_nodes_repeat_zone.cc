@@ -210,13 +210,10 @@ class LazyFunctionForRepeatZone : public LazyFunction {
     /* Show a warning when the inspection index is out of range. */
     if (node_storage.inspection_index > 0) {
       if (node_storage.inspection_index >= iterations) {
-        if (eval_log::NodeTreeLogger *tree_logger = local_user_data.try_get_tree_logger(user_data))
-        {
-          tree_logger->node_warnings.append(
-              *tree_logger->allocator,
-              {repeat_output_bnode_.identifier,
-               {NodeWarningType::Info, N_("Inspection index is out of range")}});
-        }
+        local_user_data.log_warning(
+            user_data,
+            repeat_output_bnode_.identifier,
+            {NodeWarningType::Info, N_("Inspection index is out of range")});
       }
     }
 
@@ -35,11 +35,7 @@ Main *GeoNodeExecParams::bmain() const
 void GeoNodeExecParams::error_message_add(const NodeWarningType type,
                                           const StringRef message) const
 {
-  if (eval_log::NodeTreeLogger *tree_logger = this->get_local_tree_logger()) {
-    tree_logger->node_warnings.append(
-        *tree_logger->allocator,
-        {node_.identifier, {type, tree_logger->allocator->copy_string(message)}});
-  }
+  this->local_user_data()->log_warning(*this->user_data(), node_.identifier, {type, message});
 }
 
 void GeoNodeExecParams::used_named_attribute(const StringRef attribute_name,
@@ -22,6 +22,7 @@
 
 #include "BKE_camera.h"
 #include "BKE_global.hh"
+#include "BKE_mesh_eval_share.hh"
 #include "BKE_node.hh"
 #include "BKE_report.hh"
 #include "BKE_scene.hh"
@@ -1093,7 +1094,9 @@ bool RE_engine_render(Render *re, bool do_all)
   /* Clear UI drawing locks. */
   re->display->draw_unlock();
 
-  /* Render view layers. */
+  /* Render view layers. Meshes evaluated for one view layer are kept for the following ones, even
+   * if the depsgraph is freed in between. */
+  bke::mesh_eval_share::render_job_begin();
   bool delay_grease_pencil = false;
 
   if (type->render) {
@@ -1148,6 +1151,7 @@ bool RE_engine_render(Render *re, bool do_all)
     RE_engine_free(engine);
     re->engine = nullptr;
   }
+  bke::mesh_eval_share::render_job_end();
 
   if (re->r.scemode & R_EXR_CACHE_FILE) {
     BLI_rw_mutex_lock(&re->resultmutex, THREAD_LOCK_WRITE);
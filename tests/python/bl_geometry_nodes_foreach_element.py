@@ -0,0 +1,112 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# ./blender.bin --background --python tests/python/bl_geometry_nodes_foreach_element.py -- --verbose
+import bpy
+import unittest
+
+
+VERTS_NUM = 40
+SELECTED_NUM = 20
+FACTOR = 2.0
+
+
+def create_foreach_element_tree(per_element):
+    """
+    Create a node group that computes ``(index + position.x) * FACTOR`` for the first
+    ``SELECTED_NUM`` points in a For Each Element zone, and stores it as the "result" attribute.
+
+    The zone body only contains field nodes, so it is evaluated for all elements at once. When
+    ``per_element`` is true, the element geometry is used in the body, which requires evaluating
+    the body for every element separately.
+    """
+    tree = bpy.data.node_groups.new("ForeachElement", "GeometryNodeTree")
+    tree.interface.new_socket("Geometry", in_out='INPUT', socket_type='NodeSocketGeometry')
+    tree.interface.new_socket("Geometry", in_out='OUTPUT', socket_type='NodeSocketGeometry')
+    nodes = tree.nodes
+    links = tree.links
+
+    group_input = nodes.new("NodeGroupInput")
+    group_output = nodes.new("NodeGroupOutput")
+
+    zone_input = nodes.new("GeometryNodeForeachGeometryElementInput")
+    zone_output = nodes.new("GeometryNodeForeachGeometryElementOutput")
+    zone_input.pair_with_output(zone_output)
+    zone_output.domain = 'POINT'
+    # Geometries generated in the body are not supported when evaluating all elements at once.
+    zone_output.generation_items.clear()
+    zone_output.input_items.new('FLOAT', "X")
+    zone_output.main_items.new('FLOAT', "Result")
+
+    # Inputs of the zone, evaluated on the iteration domain.
+    index = nodes.new("GeometryNodeInputIndex")
+    selection = nodes.new("ShaderNodeMath")
+    selection.operation = 'LESS_THAN'
+    selection.inputs[1].default_value = SELECTED_NUM
+    position = nodes.new("GeometryNodeInputPosition")
+    separate = nodes.new("ShaderNodeSeparateXYZ")
+    links.new(index.outputs["Index"], selection.inputs[0])
+    links.new(position.outputs["Position"], separate.inputs["Vector"])
+    links.new(group_input.outputs["Geometry"], zone_input.inputs["Geometry"])
+    links.new(selection.outputs["Value"], zone_input.inputs["Selection"])
+    links.new(separate.outputs["X"], zone_input.inputs["X"])
+
+    # A single value passed into the zone body.
+    factor = nodes.new("ShaderNodeValue")
+    factor.outputs["Value"].default_value = FACTOR
+
+    # Zone body.
+    add = nodes.new("ShaderNodeMath")
+    add.operation = 'ADD'
+    multiply = nodes.new("ShaderNodeMath")
+    multiply.operation = 'MULTIPLY'
+    links.new(zone_input.outputs["Index"], add.inputs[0])
+    links.new(zone_input.outputs["X"], add.inputs[1])
+    links.new(add.outputs["Value"], multiply.inputs[0])
+    links.new(factor.outputs["Value"], multiply.inputs[1])
+    links.new(multiply.outputs["Value"], zone_output.inputs["Result"])
+    if per_element:
+        domain_size = nodes.new("GeometryNodeAttributeDomainSize")
+        links.new(zone_input.outputs["Element"], domain_size.inputs["Geometry"])
+
+    store = nodes.new("GeometryNodeStoreNamedAttribute")
+    store.data_type = 'FLOAT'
+    store.domain = 'POINT'
+    store.inputs["Name"].default_value = "result"
+    links.new(zone_output.outputs["Geometry"], store.inputs["Geometry"])
+    links.new(zone_output.outputs["Result"], store.inputs["Value"])
+    links.new(store.outputs["Geometry"], group_output.inputs["Geometry"])
+    return tree
+
+
+class TestForeachElementZone(unittest.TestCase):
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        mesh = bpy.data.meshes.new("Points")
+        mesh.from_pydata([(i * 0.25, i % 3, 0.0) for i in range(VERTS_NUM)], [], [])
+        self.object = bpy.data.objects.new("Points", mesh)
+        bpy.context.scene.collection.objects.link(self.object)
+
+    def evaluate_result(self, per_element):
+        modifier = self.object.modifiers.new("Nodes", 'NODES')
+        modifier.node_group = create_foreach_element_tree(per_element)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        object_eval = self.object.evaluated_get(depsgraph)
+        result = [item.value for item in object_eval.data.attributes["result"].data]
+        self.object.modifiers.remove(modifier)
+        return result
+
+    def test_vectorized_matches_per_element(self):
+        expected = [(i + i * 0.25) * FACTOR if i < SELECTED_NUM else 0.0 for i in range(VERTS_NUM)]
+        vectorized = self.evaluate_result(per_element=False)
+        per_element = self.evaluate_result(per_element=True)
+        for i in range(VERTS_NUM):
+            self.assertAlmostEqual(vectorized[i], expected[i], places=5)
+            self.assertAlmostEqual(per_element[i], expected[i], places=5)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()